@@ -4,12 +4,24 @@
 #include "XojMsgBox.h"
 #include "i18n.h"
 
+void AudioController::initAudio() {
+    if (this->autoSys) {
+        return;
+    }
+
+    this->autoSys = std::make_unique<portaudio::AutoSystem>();
+    this->audioRecorder = std::make_unique<AudioRecorder>(settings);
+    this->audioPlayer = std::make_unique<AudioPlayer>(control, settings);
+}
+
 auto AudioController::startRecording() -> bool {
     if (!this->isRecording()) {
         if (getAudioFolder().isEmpty()) {
             return false;
         }
 
+        initAudio();
+
         this->timestamp = static_cast<size_t>(g_get_monotonic_time() / 1000);
 
         std::array<char, 50> buffer{};
@@ -38,7 +50,7 @@ auto AudioController::startRecording() -> bool {
 }
 
 auto AudioController::stopRecording() -> bool {
-    if (this->audioRecorder->isRecording()) {
+    if (this->isRecording()) {
         audioFilename = "";
         this->timestamp = 0;
 
@@ -49,11 +61,13 @@ auto AudioController::stopRecording() -> bool {
     return true;
 }
 
-auto AudioController::isRecording() -> bool { return this->audioRecorder->isRecording(); }
+auto AudioController::isRecording() -> bool { return this->audioRecorder && this->audioRecorder->isRecording(); }
 
-auto AudioController::isPlaying() -> bool { return this->audioPlayer->isPlaying(); }
+auto AudioController::isPlaying() -> bool { return this->audioPlayer && this->audioPlayer->isPlaying(); }
 
 auto AudioController::startPlayback(const string& filename, unsigned int timestamp) -> bool {
+    initAudio();
+
     this->audioPlayer->stop();
     bool status = this->audioPlayer->start(filename, timestamp);
     if (status) {
@@ -65,22 +79,37 @@ auto AudioController::startPlayback(const string& filename, unsigned int timesta
 void AudioController::pausePlayback() {
     this->control.getWindow()->getToolMenuHandler()->setAudioPlaybackPaused(true);
 
-    this->audioPlayer->pause();
+    if (this->audioPlayer) {
+        this->audioPlayer->pause();
+    }
 }
 
-void AudioController::seekForwards() { this->audioPlayer->seek(this->settings.getDefaultSeekTime()); }
+void AudioController::seekForwards() {
+    if (this->audioPlayer) {
+        this->audioPlayer->seek(this->settings.getDefaultSeekTime());
+    }
+}
 
-void AudioController::seekBackwards() { this->audioPlayer->seek(-1 * this->settings.getDefaultSeekTime()); }
+void AudioController::seekBackwards() {
+    if (this->audioPlayer) {
+        this->audioPlayer->seek(-1 * this->settings.getDefaultSeekTime());
+    }
+}
 
 void AudioController::continuePlayback() {
     this->control.getWindow()->getToolMenuHandler()->setAudioPlaybackPaused(false);
 
-    this->audioPlayer->play();
+    if (this->audioPlayer) {
+        this->audioPlayer->play();
+    }
 }
 
 void AudioController::stopPlayback() {
     this->control.getWindow()->getToolMenuHandler()->disableAudioPlaybackButtons();
-    this->audioPlayer->stop();
+
+    if (this->audioPlayer) {
+        this->audioPlayer->stop();
+    }
 }
 
 auto AudioController::getAudioFilename() const -> string const& { return this->audioFilename; }
@@ -101,6 +130,12 @@ auto AudioController::getAudioFolder() const -> Path {
 
 auto AudioController::getStartTime() const -> size_t { return this->timestamp; }
 
-auto AudioController::getOutputDevices() const -> vector<DeviceInfo> { return this->audioPlayer->getOutputDevices(); }
+auto AudioController::getOutputDevices() -> vector<DeviceInfo> {
+    initAudio();
+    return this->audioPlayer->getOutputDevices();
+}
 
-auto AudioController::getInputDevices() const -> vector<DeviceInfo> { return this->audioRecorder->getInputDevices(); }
+auto AudioController::getInputDevices() -> vector<DeviceInfo> {
+    initAudio();
+    return this->audioRecorder->getInputDevices();
+}
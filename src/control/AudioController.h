@@ -45,8 +45,14 @@ public:
     string const& getAudioFilename() const;
     Path getAudioFolder() const;
     size_t getStartTime() const;
-    vector<DeviceInfo> getOutputDevices() const;
-    vector<DeviceInfo> getInputDevices() const;
+    vector<DeviceInfo> getOutputDevices();
+    vector<DeviceInfo> getInputDevices();
+
+private:
+    /**
+     * Initialize PortAudio on first use, enumerating the devices can take a while
+     */
+    void initAudio();
 
 private:
     Settings& settings;
@@ -56,9 +62,9 @@ private:
      * RAII initializer don't move below the portaudio::System::instance() calls in
      * AudioRecorder and AudioPlayer
      * */
-    portaudio::AutoSystem autoSys;
-    std::unique_ptr<AudioRecorder> audioRecorder = std::make_unique<AudioRecorder>(settings);
-    std::unique_ptr<AudioPlayer> audioPlayer = std::make_unique<AudioPlayer>(control, settings);
+    std::unique_ptr<portaudio::AutoSystem> autoSys;
+    std::unique_ptr<AudioRecorder> audioRecorder;
+    std::unique_ptr<AudioPlayer> audioPlayer;
 
     string audioFilename;
     size_t timestamp = 0;
@@ -69,21 +69,36 @@ auto ElementCompareFunc(Element* a, Element* b) -> gint {
 static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
 static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
 
-// The contents of the clipboard
-class ClipboardContents {
+// The contents of the clipboard, the images are only rendered if another application requests them
+class ClipboardContents: public ElementContainer {
 public:
-    ClipboardContents(string text, GdkPixbuf* image, string svg, GString* str) {
+    ClipboardContents(string text, EditSelection* selection, GString* str) {
         this->text = std::move(text);
-        this->image = image;
-        this->svg = std::move(svg);
         this->str = str;
+
+        // The selection may be changed or deleted before the contents are requested
+        this->x = selection->getXOnView();
+        this->y = selection->getYOnView();
+        this->width = selection->getWidth();
+        this->height = selection->getHeight();
+
+        for (Element* e: *selection->getElements()) {
+            this->elements.push_back(e->clone());
+        }
     }
 
     ~ClipboardContents() {
-        g_object_unref(this->image);
+        for (Element* e: this->elements) {
+            delete e;
+        }
+
+        if (this->image) {
+            g_object_unref(this->image);
+        }
         g_string_free(this->str, true);
     }
 
+    vector<Element*>* getElements() { return &this->elements; }
 
     static void getFunction(GtkClipboard* clipboard, GtkSelectionData* selection, guint info,
                             ClipboardContents* contents) {
@@ -94,10 +109,10 @@ public:
         } else if (target == gdk_atom_intern_static_string("image/png") ||
                    target == gdk_atom_intern_static_string("image/jpeg") ||
                    target == gdk_atom_intern_static_string("image/gif")) {
-            gtk_selection_data_set_pixbuf(selection, contents->image);
+            gtk_selection_data_set_pixbuf(selection, contents->getImage());
         } else if (atomSvg1 == target || atomSvg2 == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(contents->svg.c_str()),
-                                   contents->svg.length());
+            const string& svg = contents->getSvg();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(svg.c_str()), svg.length());
         } else if (atomXournal == target) {
             gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(contents->str->str),
                                    contents->str->len);
@@ -106,17 +121,74 @@ public:
 
     static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents) { delete contents; }
 
+private:
+    /**
+     * Render the elements as 300 DPI image, on the first request
+     */
+    GdkPixbuf* getImage() {
+        if (this->image) {
+            return this->image;
+        }
+
+        double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
+
+        int imageWidth = this->width * dpiFactor;
+        int imageHeight = this->height * dpiFactor;
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, imageWidth, imageHeight);
+        cairo_t* cr = cairo_create(surface);
+        cairo_scale(cr, dpiFactor, dpiFactor);
+        cairo_translate(cr, -this->x, -this->y);
+
+        DocumentView view;
+        view.drawSelection(cr, this);
+
+        cairo_destroy(cr);
+
+        this->image = xoj_pixbuf_get_from_surface(surface, 0, 0, imageWidth, imageHeight);
+        cairo_surface_destroy(surface);
+
+        return this->image;
+    }
+
+    /**
+     * Render the elements as SVG, on the first request
+     */
+    const string& getSvg() {
+        if (!this->svg.empty()) {
+            return this->svg;
+        }
+
+        cairo_surface_t* surface = cairo_svg_surface_create_for_stream(
+                +[](void* closure, const unsigned char* data, unsigned int length) {
+                    static_cast<string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                    return CAIRO_STATUS_SUCCESS;
+                },
+                &this->svg, this->width, this->height);
+        cairo_t* cr = cairo_create(surface);
+        cairo_translate(cr, -this->x, -this->y);
+
+        DocumentView view;
+        view.drawSelection(cr, this);
+
+        cairo_destroy(cr);
+        cairo_surface_destroy(surface);
+
+        return this->svg;
+    }
+
 private:
     string text;
-    GdkPixbuf* image;
-    string svg;
     GString* str;
-};
 
-static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
-    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
-    return CAIRO_STATUS_SUCCESS;
-}
+    vector<Element*> elements;
+    double x;
+    double y;
+    double width;
+    double height;
+
+    GdkPixbuf* image = nullptr;
+    string svg;
+};
 
 auto ClipboardHandler::copy() -> bool {
     if (!this->selection) {
@@ -155,45 +227,6 @@ auto ClipboardHandler::copy() -> bool {
     }
     g_list_free(textElements);
 
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: PNG
-    /////////////////////////////////////////////////////////////////
-
-    DocumentView view;
-
-    double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
-
-    int width = selection->getWidth() * dpiFactor;
-    int height = selection->getHeight() * dpiFactor;
-    cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crPng = cairo_create(surfacePng);
-    cairo_scale(crPng, dpiFactor, dpiFactor);
-
-    cairo_translate(crPng, -selection->getXOnView(), -selection->getYOnView());
-    view.drawSelection(crPng, this->selection);
-
-    cairo_destroy(crPng);
-
-    GdkPixbuf* image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
-
-    cairo_surface_destroy(surfacePng);
-
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: SVG
-    /////////////////////////////////////////////////////////////////
-
-    GString* svgString = g_string_sized_new(1048576);  // 1MB
-
-    cairo_surface_t* surfaceSVG =
-            cairo_svg_surface_create_for_stream(reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString,
-                                                selection->getWidth(), selection->getHeight());
-    cairo_t* crSVG = cairo_create(surfaceSVG);
-
-    view.drawSelection(crSVG, this->selection);
-
-    cairo_surface_destroy(surfaceSVG);
-    cairo_destroy(crSVG);
-
     /////////////////////////////////////////////////////////////////
     // copy to clipboard
     /////////////////////////////////////////////////////////////////
@@ -206,7 +239,7 @@ auto ClipboardHandler::copy() -> bool {
     if (!text.empty()) {
         gtk_target_list_add_text_targets(list, 0);
     }
-    // we always copy an image to clipboard
+    // we always copy an image to clipboard, it is rendered when it is requested
     gtk_target_list_add_image_targets(list, 0, true);
     gtk_target_list_add(list, atomSvg1, 0, 0);
     gtk_target_list_add(list, atomSvg2, 0, 0);
@@ -214,7 +247,7 @@ auto ClipboardHandler::copy() -> bool {
 
     targets = gtk_target_table_new_from_list(list, &n_targets);
 
-    auto* contents = new ClipboardContents(text, image, svgString->str, out.getStr());
+    auto* contents = new ClipboardContents(text, this->selection, out.getStr());
 
     gtk_clipboard_set_with_data(this->clipboard, targets, n_targets,
                                 reinterpret_cast<GtkClipboardGetFunc>(ClipboardContents::getFunction),
@@ -224,8 +257,6 @@ auto ClipboardHandler::copy() -> bool {
     gtk_target_table_free(targets, n_targets);
     gtk_target_list_unref(list);
 
-    g_string_free(svgString, true);
-
     return true;
 }
 
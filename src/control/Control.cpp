@@ -59,6 +59,7 @@
 #include "PathUtil.h"
 #include "PrintHandler.h"
 #include "Stacktrace.h"
+#include "StartupTrace.h"
 #include "StringUtils.h"
 #include "UndoRedoController.h"
 #include "Util.h"
@@ -90,6 +91,7 @@ Control::Control(GladeSearchpath* gladeSearchPath) {
     name /= SETTINGS_XML_FILE;
     this->settings = new Settings(name);
     this->settings->load();
+    StartupTrace::mark("settings");
 
     TextView::setDpi(settings->getDisplayDpi());
 
@@ -125,10 +127,13 @@ Control::Control(GladeSearchpath* gladeSearchPath) {
     this->layerController = new LayerController(this);
     this->layerController->registerListener(this);
 
+    this->searchIndex = new SearchIndex(this);
+    this->searchIndex->registerListener(this);
+
     this->fullscreenHandler = new FullscreenHandler(settings);
 
+    // The plugins are loaded after the window is drawn the first time
     this->pluginController = new PluginController(this);
-    this->pluginController->registerToolbar();
 }
 
 Control::~Control() {
@@ -183,6 +188,8 @@ Control::~Control() {
     this->pageBackgroundChangeController = nullptr;
     delete this->layerController;
     this->layerController = nullptr;
+    delete this->searchIndex;
+    this->searchIndex = nullptr;
     delete this->fullscreenHandler;
     this->fullscreenHandler = nullptr;
 }
@@ -213,26 +220,13 @@ void Control::renameLastAutosaveFile() {
 
     std::vector<string> errors;
 
-    // See https://github.com/xournalpp/xournalpp/issues/1122 for why we use
-    // `g_file_copy` instead of `g_rename` here.
-    GFile* src = g_file_new_for_path(filename.c_str());
-    GFile* dest = g_file_new_for_path(renamed.c_str());
-    GError* err = nullptr;
-    // Use target default perms; the source partition may have different file
-    // system attributes than the target, and we don't want anything bad in the
-    // autosave directory
-    auto flags = static_cast<GFileCopyFlags>(G_FILE_COPY_TARGET_DEFAULT_PERMS | G_FILE_COPY_OVERWRITE);
-    g_file_copy(src, dest, flags, nullptr, nullptr, nullptr, &err);
-    if (err == nullptr) {
-        g_file_delete(src, nullptr, &err);
-    }
-    g_object_unref(src);
-    g_object_unref(dest);
-
-    if (err != nullptr) {
-        auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\": {3}");
-        errors.push_back(FS(fmtstr % filename.str() % renamed.str() % err->message));
-        g_error_free(err);
+    // The autosave of a saved document is next to the document, so it may be on another
+    // filesystem than the autosave folder (see https://github.com/xournalpp/xournalpp/issues/1122).
+    // It's renamed if possible, else copied to a temporary file next to the target, flushed
+    // and renamed. The copy is created with the default permissions of the target folder.
+    if (!PathUtil::move(filename, renamed)) {
+        auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\"");
+        errors.push_back(FS(fmtstr % filename.str() % renamed.str()));
     }
 
     if (!errors.empty()) {
@@ -335,12 +329,30 @@ void Control::initWindow(MainWindow* win) {
 
     win->setFontButtonFont(settings->getFont());
 
-    this->pluginController->registerMenu();
+    g_signal_connect(win->getXournal()->getWidget(), "draw", G_CALLBACK(firstFrameCallback), this);
 
     fireActionSelected(GROUP_SNAPPING, settings->isSnapRotation() ? ACTION_ROTATION_SNAPPING : ACTION_NONE);
     fireActionSelected(GROUP_GRID_SNAPPING, settings->isSnapGrid() ? ACTION_GRID_SNAPPING : ACTION_NONE);
 }
 
+auto Control::firstFrameCallback(GtkWidget* widget, cairo_t* cr, Control* control) -> bool {
+    g_signal_handlers_disconnect_by_func(widget, reinterpret_cast<gpointer>(firstFrameCallback), control);
+    StartupTrace::mark("first frame");
+
+    // Let the frame be finished, before the plugins are loaded
+    g_idle_add(reinterpret_cast<GSourceFunc>(loadPluginsCallback), control);
+
+    return false;
+}
+
+auto Control::loadPluginsCallback(Control* control) -> bool {
+    control->pluginController->loadPlugins();
+    StartupTrace::mark("plugins");
+    StartupTrace::report();
+
+    return false;
+}
+
 auto Control::autosaveCallback(Control* control) -> bool {
     if (!control->undoRedo->isChangedAutosave()) {
         // do nothing, nothing changed
@@ -2653,18 +2665,21 @@ void Control::clipboardPasteXournal(ObjectInputStream& in) {
         auto pasteAddUndoAction = mem::make_unique<AddUndoAction>(page, false);
         // this will undo a group of elements that are inserted
 
+        // The pasted elements are allocated together, like the elements of a loaded page
+        ElementArenaPtr arena(new ElementArena());
+
         for (int i = 0; i < count; i++) {
             string name = in.getNextObjectName();
             element.reset();
 
             if (name == "Stroke") {
-                element = mem::make_unique<Stroke>();
+                element.reset(new (arena.get()) Stroke());
             } else if (name == "Image") {
-                element = mem::make_unique<Image>();
+                element.reset(new (arena.get()) Image());
             } else if (name == "TexImage") {
-                element = mem::make_unique<TexImage>();
+                element.reset(new (arena.get()) TexImage());
             } else if (name == "Text") {
-                element = mem::make_unique<Text>();
+                element.reset(new (arena.get()) Text());
             } else {
                 throw InputStreamException(FS(FORMAT_STR("Get unknown object {1}") % name), __FILE__, __LINE__);
             }
@@ -2859,6 +2874,8 @@ auto Control::getSidebar() -> Sidebar* { return this->sidebar; }
 
 auto Control::getSearchBar() -> SearchBar* { return this->searchBar; }
 
+auto Control::getSearchIndex() -> SearchIndex* { return this->searchIndex; }
+
 auto Control::getAudioController() -> AudioController* { return this->audioController; }
 
 auto Control::getPageTypes() -> PageTypeHandler* { return this->pageTypes; }
@@ -32,6 +32,7 @@
 #include "PathUtil.h"
 #include "RecentManager.h"
 #include "ScrollHandler.h"
+#include "SearchIndex.h"
 #include "ToolHandler.h"
 #include "XournalType.h"
 
@@ -246,6 +247,7 @@ public:
     XournalppCursor* getCursor();
     Sidebar* getSidebar();
     SearchBar* getSearchBar();
+    SearchIndex* getSearchIndex();
     AudioController* getAudioController();
     PageTypeHandler* getPageTypes();
     PageTypeMenu* getNewPageType();
@@ -303,6 +305,8 @@ protected:
 
     static bool checkChangedDocument(Control* control);
     static bool autosaveCallback(Control* control);
+    static bool firstFrameCallback(GtkWidget* widget, cairo_t* cr, Control* control);
+    static bool loadPluginsCallback(Control* control);
 
     void fontChanged();
     /**
@@ -398,6 +402,11 @@ private:
 
     LayerController* layerController;
 
+    /**
+     * Text search index of the document
+     */
+    SearchIndex* searchIndex;
+
     /**
      * Manage all Xournal++ plugins
      */
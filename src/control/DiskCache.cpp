@@ -0,0 +1,171 @@
+#include "DiskCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <glib/gstdio.h>
+
+DiskCache::DiskCache(Path folder, string extension, size_t maxSize):
+        folder(std::move(folder)), extension(std::move(extension)), maxSize(maxSize) {
+    g_mutex_init(&this->mutex);
+}
+
+DiskCache::~DiskCache() { g_mutex_clear(&this->mutex); }
+
+auto DiskCache::computeKey(const string& data) -> string {
+    gchar* hash = g_compute_checksum_for_string(G_CHECKSUM_SHA256, data.c_str(), data.length());
+    string key = hash;
+    g_free(hash);
+    return key;
+}
+
+auto DiskCache::getFile(const string& key) const -> Path { return this->folder / (key + this->extension); }
+
+/**
+ * Read the sizes of the files of previous sessions, on first use so starting the application is not slowed down
+ */
+void DiskCache::loadIndex() {
+    if (this->indexLoaded) {
+        return;
+    }
+    this->indexLoaded = true;
+
+    GDir* dir = g_dir_open(this->folder.c_str(), 0, nullptr);
+    if (dir == nullptr) {
+        return;
+    }
+
+    const gchar* name = nullptr;
+    while ((name = g_dir_read_name(dir)) != nullptr) {
+        if (!g_str_has_suffix(name, this->extension.c_str())) {
+            continue;
+        }
+
+        GStatBuf fileStat;
+        if (g_stat((this->folder / name).c_str(), &fileStat) != 0) {
+            continue;
+        }
+
+        string key(name, strlen(name) - this->extension.length());
+        Entry& entry = this->entries[key];
+        entry.size = fileStat.st_size;
+        entry.lastUse = static_cast<gint64>(fileStat.st_mtime) * G_USEC_PER_SEC;
+        this->size += entry.size;
+    }
+    g_dir_close(dir);
+
+    limitSize();
+}
+
+auto DiskCache::lookup(const string& key, string& data) -> bool {
+    g_mutex_lock(&this->mutex);
+    loadIndex();
+    this->lookups++;
+
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) {
+        g_mutex_unlock(&this->mutex);
+        return false;
+    }
+
+    Path file = getFile(key);
+    gchar* contents = nullptr;
+    gsize length = 0;
+    if (!g_file_get_contents(file.c_str(), &contents, &length, nullptr)) {
+        // Deleted by someone else
+        this->size -= it->second.size;
+        this->entries.erase(it);
+        g_mutex_unlock(&this->mutex);
+        return false;
+    }
+
+    data.assign(contents, length);
+    g_free(contents);
+
+    // Keep the order of use for the next session
+    g_utime(file.c_str(), nullptr);
+    it->second.lastUse = g_get_real_time();
+
+    this->hits++;
+    g_mutex_unlock(&this->mutex);
+    return true;
+}
+
+void DiskCache::store(const string& key, const string& data) {
+    g_mutex_lock(&this->mutex);
+    loadIndex();
+
+    GError* err = nullptr;
+    if (!g_file_set_contents(getFile(key).c_str(), data.c_str(), data.length(), &err)) {
+        g_warning("Could not write cache file: %s", err->message);
+        g_error_free(err);
+        g_mutex_unlock(&this->mutex);
+        return;
+    }
+
+    Entry& entry = this->entries[key];
+    this->size -= entry.size;
+    entry.size = data.length();
+    entry.lastUse = g_get_real_time();
+    this->size += entry.size;
+
+    limitSize();
+    g_mutex_unlock(&this->mutex);
+}
+
+/**
+ * Delete the least recently used files
+ */
+void DiskCache::limitSize() {
+    if (this->size <= this->maxSize) {
+        return;
+    }
+
+    std::vector<std::pair<gint64, string>> byAge;
+    byAge.reserve(this->entries.size());
+    for (auto& e: this->entries) {
+        byAge.emplace_back(e.second.lastUse, e.first);
+    }
+    std::sort(byAge.begin(), byAge.end());
+
+    // Shrink to three quarters of the limit, so not every new file deletes a file
+    for (auto& e: byAge) {
+        if (this->size <= this->maxSize / 4 * 3) {
+            break;
+        }
+
+        getFile(e.second).deleteFile();
+        this->size -= this->entries[e.second].size;
+        this->entries.erase(e.second);
+    }
+}
+
+auto DiskCache::getCount() -> size_t {
+    g_mutex_lock(&this->mutex);
+    size_t count = this->entries.size();
+    g_mutex_unlock(&this->mutex);
+    return count;
+}
+
+auto DiskCache::getSize() -> size_t {
+    g_mutex_lock(&this->mutex);
+    size_t size = this->size;
+    g_mutex_unlock(&this->mutex);
+    return size;
+}
+
+auto DiskCache::getHits() -> size_t {
+    g_mutex_lock(&this->mutex);
+    size_t hits = this->hits;
+    g_mutex_unlock(&this->mutex);
+    return hits;
+}
+
+auto DiskCache::getLookups() -> size_t {
+    g_mutex_lock(&this->mutex);
+    size_t lookups = this->lookups;
+    g_mutex_unlock(&this->mutex);
+    return lookups;
+}
@@ -0,0 +1,96 @@
+/*
+ * Xournal++
+ *
+ * Persistent cache of files in the user cache folder
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <glib.h>
+
+#include "Path.h"
+#include "XournalType.h"
+
+/**
+ * Stores data in files named after their key. The least recently used files are deleted if the cache grows larger than
+ * the maximum size.
+ */
+class DiskCache {
+public:
+    DiskCache(Path folder, string extension, size_t maxSize);
+    virtual ~DiskCache();
+
+private:
+    DiskCache(const DiskCache& cache) = delete;
+    void operator=(const DiskCache& cache) = delete;
+
+public:
+    /**
+     * @return The SHA-256 hash of the data, usable as key
+     */
+    static string computeKey(const string& data);
+
+    /**
+     * Load cached data
+     *
+     * @return true on cache hit
+     */
+    bool lookup(const string& key, string& data);
+
+    /**
+     * Add data to the cache
+     */
+    void store(const string& key, const string& data);
+
+    /**
+     * @return The number of cached files
+     */
+    size_t getCount();
+
+    /**
+     * @return The size of all cached files in bytes
+     */
+    size_t getSize();
+
+    /**
+     * @return The number of cache hits / lookups in this session
+     */
+    size_t getHits();
+    size_t getLookups();
+
+private:
+    void loadIndex();
+    void limitSize();
+    Path getFile(const string& key) const;
+
+private:
+    struct Entry {
+        size_t size = 0;
+
+        /**
+         * Modification time of the file, updated on lookup
+         */
+        gint64 lastUse = 0;
+    };
+
+    GMutex mutex{};
+
+    Path folder;
+    string extension;
+    size_t maxSize;
+
+    std::map<string, Entry> entries;
+    bool indexLoaded = false;
+
+    size_t size = 0;
+    size_t hits = 0;
+    size_t lookups = 0;
+};
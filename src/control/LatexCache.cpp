@@ -0,0 +1,19 @@
+#include "LatexCache.h"
+
+#include <utility>
+
+#include "Util.h"
+
+LatexCache* LatexCache::instance = nullptr;
+
+LatexCache::LatexCache(Path folder): DiskCache(std::move(folder), ".pdf", MAX_SIZE) {}
+
+LatexCache::~LatexCache() = default;
+
+auto LatexCache::getInstance() -> LatexCache& {
+    if (instance == nullptr) {
+        instance = new LatexCache(Util::getCacheSubfolder("latex"));
+    }
+
+    return *instance;
+}
@@ -0,0 +1,33 @@
+/*
+ * Xournal++
+ *
+ * Persistent cache for rendered LaTeX formulas
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "DiskCache.h"
+
+/**
+ * Stores the PDF generated by pdflatex in the user cache folder, named after the SHA-256 hash of the complete .tex
+ * file.
+ */
+class LatexCache: public DiskCache {
+private:
+    LatexCache(Path folder);
+    virtual ~LatexCache();
+
+public:
+    static LatexCache& getInstance();
+
+public:
+    static constexpr size_t MAX_SIZE = 32 * 1024 * 1024;
+
+private:
+    static LatexCache* instance;
+};
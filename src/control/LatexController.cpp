@@ -1,6 +1,14 @@
 #include "LatexController.h"
 
+#include <cstring>
 #include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#endif
 
 #include "gui/XournalView.h"
 #include "gui/dialog/LatexDialog.h"
@@ -8,6 +16,7 @@
 #include "util/cpp14memory.h"
 
 #include "Control.h"
+#include "LatexCache.h"
 #include "Stacktrace.h"
 #include "StringUtils.h"
 #include "Util.h"
@@ -16,24 +25,29 @@
 #include "pixbuf-utils.h"
 
 /**
- * First half of the LaTeX template used to generate preview PDFs. User-supplied
+ * Preamble of the LaTeX template used to generate preview PDFs, which can be
+ * precompiled into a format file.
+ */
+const char* LATEX_PREAMBLE = R"(\documentclass[varwidth=true, crop, border=5pt]{standalone})"
+                             "\n"
+                             R"(\usepackage{amsmath})"
+                             "\n"
+                             R"(\usepackage{amssymb})"
+                             "\n"
+                             R"(\usepackage{ifthen})"
+                             "\n"
+                             R"(\newlength{\pheight})"
+                             "\n";
+
+/**
+ * First half of the LaTeX template after the preamble. User-supplied
  * formulas will be inserted between the two halves.
  *
  * This template is necessarily complicated because we need to cause an error if
  * the rendered formula is blank. Otherwise, a completely blank, sizeless PDF
  * will be generated, which Poppler will be unable to load.
  */
-const char* LATEX_TEMPLATE_1 = R"(\documentclass[varwidth=true, crop, border=5pt]{standalone})"
-                               "\n"
-                               R"(\usepackage{amsmath})"
-                               "\n"
-                               R"(\usepackage{amssymb})"
-                               "\n"
-                               R"(\usepackage{ifthen})"
-                               "\n"
-                               R"(\newlength{\pheight})"
-                               "\n"
-                               R"(\def\preview{\(\displaystyle)"
+const char* LATEX_TEMPLATE_1 = R"(\def\preview{\(\displaystyle)"
                                "\n";
 
 const char* LATEX_TEMPLATE_2 = "\n\\)}\n"
@@ -50,6 +64,74 @@ const char* LATEX_TEMPLATE_2 = "\n\\)}\n"
                                R"(\end{document})"
                                "\n";
 
+/**
+ * Time without changes before the preview is updated, if a preview is already being generated
+ */
+constexpr guint PREVIEW_DELAY_MS = 150;
+
+/**
+ * Name of the format file with the precompiled preamble
+ */
+constexpr const char* PREAMBLE_FORMAT = "preamble";
+
+/**
+ * The pdflatex binary, once the dependencies were found. Missing dependencies are checked again, so they can be
+ * installed while the application is running.
+ */
+static Path foundPdflatexPath;
+
+enum PreambleFormatState {
+    PREAMBLE_FORMAT_NONE,
+    PREAMBLE_FORMAT_BUILDING,
+    PREAMBLE_FORMAT_READY,
+    PREAMBLE_FORMAT_FAILED
+};
+
+/**
+ * The format is built once per session, in the temporary folder
+ */
+static PreambleFormatState preambleFormatState = PREAMBLE_FORMAT_NONE;
+
+static auto createTexContents(const string& texString) -> string {
+    string texContents = LATEX_PREAMBLE;
+    texContents += LATEX_TEMPLATE_1;
+    texContents += texString;
+    texContents += LATEX_TEMPLATE_2;
+    return texContents;
+}
+
+/**
+ * One pdflatex run. The job outlives the controller if the dialog is closed while pdflatex is running.
+ */
+struct LatexController::RenderJob {
+    /**
+     * nullptr if the result is no longer needed
+     */
+    LatexController* controller = nullptr;
+
+    GPid pid{};
+
+    /**
+     * Used as the job name, so the files of a cancelled run are not overwritten by the next one
+     */
+    int generation = 0;
+
+    /**
+     * The path of the generated files, without extension
+     */
+    Path basePath;
+
+    string texString;
+
+    void deleteFiles() const {
+        for (const char* ext: {".tex", ".pdf", ".log", ".aux"}) {
+            Path file = this->basePath;
+            file += ext;
+            file.deleteFile();
+        }
+    }
+};
+
 LatexController::LatexController(Control* control):
         control(control),
         dlg(control->getGladeSearchPath()),
@@ -58,12 +140,25 @@ LatexController::LatexController(Control* control):
     Util::ensureFolderExists(this->texTmpDir);
 }
 
-LatexController::~LatexController() { this->control = nullptr; }
+LatexController::~LatexController() {
+    if (this->updateTimeout != 0) {
+        g_source_remove(this->updateTimeout);
+        this->updateTimeout = 0;
+    }
+    this->cancelRender();
+
+    this->control = nullptr;
+}
 
 /**
  * Find the tex executable, return false if not found
  */
 auto LatexController::findTexDependencies() -> LatexController::FindDependencyStatus {
+    if (!foundPdflatexPath.isEmpty()) {
+        this->pdflatexPath = foundPdflatexPath;
+        return LatexController::FindDependencyStatus(true, "");
+    }
+
     gchar* pdflatex = g_find_program_in_path("pdflatex");
     if (!pdflatex) {
         string msg =
@@ -92,52 +187,131 @@ auto LatexController::findTexDependencies() -> LatexController::FindDependencySt
         return LatexController::FindDependencyStatus(false, msg);
     }
 
+    foundPdflatexPath = this->pdflatexPath;
     return LatexController::FindDependencyStatus(true, "");
 }
 
-auto LatexController::runCommandAsync(const string& texString) -> std::unique_ptr<GPid> {
-    g_assert(!this->isUpdating);
+auto LatexController::runCommandAsync(const string& texString) -> bool {
+    g_assert(this->currentJob == nullptr);
 
-    string texContents = LATEX_TEMPLATE_1;
-    texContents += texString;
-    texContents += LATEX_TEMPLATE_2;
+    bool usePreambleFormat = preambleFormatState == PREAMBLE_FORMAT_READY;
+    string texContents = createTexContents(texString);
+    if (usePreambleFormat) {
+        texContents = texContents.substr(strlen(LATEX_PREAMBLE));
+    }
 
-    Path texFile = this->texTmpDir / "tex.tex";
+    auto* job = new RenderJob();
+    job->controller = this;
+    job->generation = ++this->generation;
+    job->basePath = this->texTmpDir / ("tex-" + std::to_string(job->generation));
+    job->texString = texString;
+
+    Path texFile = job->basePath;
+    texFile += ".tex";
 
     GError* err = nullptr;
     if (!g_file_set_contents(texFile.c_str(), texContents.c_str(), texContents.length(), &err)) {
         XojMsgBox::showErrorToUser(control->getGtkWindow(), FS(_F("Could not save .tex file: {1}") % err->message));
         g_error_free(err);
-        return nullptr;
+        delete job;
+        return false;
     }
 
     char* texFileEscaped = g_strescape(texFile.c_str(), nullptr);
     char* cmd = g_strdup(this->pdflatexPath.c_str());
 
     static char* texFlag = g_strdup("-interaction=nonstopmode");
-    char* argv[] = {cmd, texFlag, texFileEscaped, nullptr};
+    static char* fmtFlag = g_strdup_printf("-fmt=%s", PREAMBLE_FORMAT);
+    std::vector<char*> argv = {cmd, texFlag};
+    if (usePreambleFormat) {
+        argv.push_back(fmtFlag);
+    }
+    argv.push_back(texFileEscaped);
+    argv.push_back(nullptr);
 
-    std::unique_ptr<GPid> pdflatexPid(new GPid);
     auto flags = GSpawnFlags(G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL | G_SPAWN_DO_NOT_REAP_CHILD);
 
-    this->setUpdating(true);
-    this->lastPreviewedTex = texString;
-
-    bool success = g_spawn_async(texTmpDir.c_str(), argv, nullptr, flags, nullptr, nullptr, pdflatexPid.get(), &err);
-    if (!success) {
+    bool success = g_spawn_async(texTmpDir.c_str(), argv.data(), nullptr, flags, nullptr, nullptr, &job->pid, &err);
+    if (success) {
+        this->currentJob = job;
+        g_child_watch_add(job->pid, reinterpret_cast<GChildWatchFunc>(onPdfRenderComplete), job);
+    } else {
         string message = FS(_F("Could not start pdflatex: {1} (exit code: {2})") % err->message % err->code);
         g_warning("%s", message.c_str());
         XojMsgBox::showErrorToUser(control->getGtkWindow(), message);
 
         g_error_free(err);
-        this->setUpdating(false);
-        pdflatexPid.reset();
+        job->deleteFiles();
+        delete job;
     }
 
     g_free(texFileEscaped);
     g_free(cmd);
 
-    return pdflatexPid;
+    return success;
+}
+
+void LatexController::cancelRender() {
+    if (this->currentJob == nullptr) {
+        return;
+    }
+
+    // The job is deleted when the process has exited
+#ifdef _WIN32
+    TerminateProcess(this->currentJob->pid, 1);
+#else
+    kill(this->currentJob->pid, SIGTERM);
+#endif
+    this->currentJob->controller = nullptr;
+    this->currentJob = nullptr;
+}
+
+/**
+ * Dump the preamble into a format file in the background, later previews only need to load it instead of all packages
+ */
+void LatexController::buildPreambleFormat() {
+    if (preambleFormatState != PREAMBLE_FORMAT_NONE) {
+        return;
+    }
+
+    Path texFile = this->texTmpDir / (string(PREAMBLE_FORMAT) + ".tex");
+    string texContents = LATEX_PREAMBLE;
+    texContents += "\\dump\n";
+    if (!g_file_set_contents(texFile.c_str(), texContents.c_str(), texContents.length(), nullptr)) {
+        preambleFormatState = PREAMBLE_FORMAT_FAILED;
+        return;
+    }
+
+    char* texFileEscaped = g_strescape(texFile.c_str(), nullptr);
+    char* cmd = g_strdup(this->pdflatexPath.c_str());
+    char* jobFlag = g_strdup_printf("-jobname=%s", PREAMBLE_FORMAT);
+    static char* iniFlag = g_strdup("-ini");
+    static char* texFlag = g_strdup("-interaction=nonstopmode");
+    static char* baseFormat = g_strdup("&pdflatex");
+    char* argv[] = {cmd, iniFlag, texFlag, jobFlag, baseFormat, texFileEscaped, nullptr};
+
+    GPid pid{};
+    auto flags = GSpawnFlags(G_SPAWN_STDOUT_TO_DEV_NULL | G_SPAWN_STDERR_TO_DEV_NULL | G_SPAWN_DO_NOT_REAP_CHILD);
+    if (g_spawn_async(texTmpDir.c_str(), argv, nullptr, flags, nullptr, nullptr, &pid, nullptr)) {
+        preambleFormatState = PREAMBLE_FORMAT_BUILDING;
+        g_child_watch_add(pid, reinterpret_cast<GChildWatchFunc>(onPreambleFormatComplete), nullptr);
+    } else {
+        preambleFormatState = PREAMBLE_FORMAT_FAILED;
+    }
+
+    g_free(texFileEscaped);
+    g_free(cmd);
+    g_free(jobFlag);
+}
+
+void LatexController::onPreambleFormatComplete(GPid pid, gint returnCode, gpointer unused) {
+    g_spawn_close_pid(pid);
+    if (g_spawn_check_exit_status(returnCode, nullptr)) {
+        preambleFormatState = PREAMBLE_FORMAT_READY;
+    } else {
+        g_warning("Could not precompile the LaTeX preamble, the full template is used");
+        preambleFormatState = PREAMBLE_FORMAT_FAILED;
+    }
 }
 
 /**
@@ -227,36 +401,65 @@ auto LatexController::showTexEditDialog() -> string {
 }
 
 void LatexController::triggerImageUpdate(const string& texString) {
-    if (this->isUpdating) {
+    this->cancelRender();
+
+    if (this->loadCached(texString)) {
         return;
     }
 
-    std::unique_ptr<GPid> pid = this->runCommandAsync(texString);
-    if (pid != nullptr) {
-        g_assert(this->isUpdating);
-        g_child_watch_add(*pid, reinterpret_cast<GChildWatchFunc>(onPdfRenderComplete), this);
+    this->setUpdating(true);
+    if (!this->runCommandAsync(texString)) {
+        this->setUpdating(false);
     }
 }
 
+void LatexController::scheduleImageUpdate() {
+    if (this->updateTimeout != 0) {
+        g_source_remove(this->updateTimeout);
+        this->updateTimeout = 0;
+    }
+
+    if (!this->isUpdating) {
+        // Nothing in progress, show the first change without delay
+        this->triggerImageUpdate(this->dlg.getBufferContents());
+        return;
+    }
+
+    this->setUpdating(true);
+    this->updateTimeout = g_timeout_add(PREVIEW_DELAY_MS, reinterpret_cast<GSourceFunc>(onUpdateTimeout), this);
+}
+
+auto LatexController::onUpdateTimeout(LatexController* self) -> gboolean {
+    self->updateTimeout = 0;
+    self->triggerImageUpdate(self->dlg.getBufferContents());
+    return false;
+}
+
 /**
  * Text-changed handler: when the Buffer in the dialog changes, this handler
  * removes the previous existing render and creates a new one. We need to do it
  * through 'self' because signal handlers cannot directly access non-static
  * methods and non-static fields such as 'dlg' so we need to wrap all the dlg
  * method inside small methods in 'self'. To improve performance, we render the
- * text asynchronously.
+ * text asynchronously, and wait for a pause in typing while a render is running.
  */
-void LatexController::handleTexChanged(GtkTextBuffer* buffer, LatexController* self) {
-    self->triggerImageUpdate(self->dlg.getBufferContents());
-}
+void LatexController::handleTexChanged(GtkTextBuffer* buffer, LatexController* self) { self->scheduleImageUpdate(); }
+
+void LatexController::onPdfRenderComplete(GPid pid, gint returnCode, RenderJob* job) {
+    g_spawn_close_pid(pid);
+
+    LatexController* self = job->controller;
+    if (self == nullptr) {
+        // Cancelled, a newer render was started or the dialog was closed
+        job->deleteFiles();
+        delete job;
+        return;
+    }
+    g_assert(self->currentJob == job);
+    self->currentJob = nullptr;
 
-void LatexController::onPdfRenderComplete(GPid pid, gint returnCode, LatexController* self) {
-    g_assert(self->isUpdating);
     GError* err = nullptr;
     g_spawn_check_exit_status(returnCode, &err);
-    g_spawn_close_pid(pid);
-    string currentTex = self->dlg.getBufferContents();
-    bool shouldUpdate = self->lastPreviewedTex != currentTex;
     if (err != nullptr) {
         self->isValidTex = false;
         if (!g_error_matches(err, G_SPAWN_EXIT_ERROR, 1)) {
@@ -265,37 +468,31 @@ void LatexController::onPdfRenderComplete(GPid pid, gint returnCode, LatexContro
             g_warning("%s", message.c_str());
             XojMsgBox::showErrorToUser(self->control->getGtkWindow(), message);
         }
-        Path pdfPath = self->texTmpDir / "tex.pdf";
-        if (pdfPath.exists()) {
-            // Delete the pdf to prevent more errors
-            pdfPath.deleteFile();
-        }
         g_error_free(err);
     } else {
         self->isValidTex = true;
-        self->temporaryRender = self->loadRendered(currentTex);
+        Path pdfPath = job->basePath;
+        pdfPath += ".pdf";
+        self->temporaryRender = self->loadRendered(pdfPath, job->texString);
         if (self->temporaryRender != nullptr) {
             self->dlg.setTempRender(self->temporaryRender->getPdf());
         }
     }
-    self->setUpdating(false);
-    if (shouldUpdate) {
-        self->triggerImageUpdate(currentTex);
-    }
+    job->deleteFiles();
+    delete job;
+
+    // Still updating if the text was changed while rendering
+    self->setUpdating(self->updateTimeout != 0);
 }
 
 void LatexController::setUpdating(bool newValue) {
     GtkWidget* okButton = this->dlg.get("texokbutton");
-    bool buttonEnabled = true;
-    if ((!this->isUpdating && newValue) || (this->isUpdating && !newValue)) {
-        // Disable LatexDialog OK button while updating. This is a workaround
-        // for the fact that 1) the LatexController only lives while the dialog
-        // is open; 2) the preview is generated asynchronously; and 3) the `run`
-        // method that inserts the TexImage object is called synchronously after
-        // the dialog is closed with the OK button.
-        buttonEnabled = !newValue;
-    }
-
+    // Disable LatexDialog OK button while updating. This is a workaround
+    // for the fact that 1) the LatexController only lives while the dialog
+    // is open; 2) the preview is generated asynchronously; and 3) the `run`
+    // method that inserts the TexImage object is called synchronously after
+    // the dialog is closed with the OK button.
+    bool buttonEnabled = !newValue;
 
     // Invalid LaTeX will generate an invalid PDF, so disable the OK button if
     // needed.
@@ -356,12 +553,30 @@ auto LatexController::convertDocumentToImage(PopplerDocument* doc, string formul
     return img;
 }
 
-auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexImage> {
+auto LatexController::loadCached(const string& texString) -> bool {
+    string pdfData;
+    if (!LatexCache::getInstance().lookup(LatexCache::computeKey(createTexContents(texString)), pdfData)) {
+        return false;
+    }
+
+    std::unique_ptr<TexImage> img = createTexImage(texString, pdfData);
+    if (img == nullptr) {
+        return false;
+    }
+
+    this->isValidTex = true;
+    this->temporaryRender = std::move(img);
+    this->dlg.setTempRender(this->temporaryRender->getPdf());
+    // Update the dialog state
+    this->setUpdating(false);
+    return true;
+}
+
+auto LatexController::loadRendered(const Path& pdfPath, string renderedTex) -> std::unique_ptr<TexImage> {
     if (!this->isValidTex) {
         return nullptr;
     }
 
-    Path pdfPath = texTmpDir / "tex.pdf";
     GError* err = nullptr;
 
     gchar* fileContents = nullptr;
@@ -373,7 +588,22 @@ auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexIma
         return nullptr;
     }
 
-    PopplerDocument* pdf = poppler_document_new_from_data(fileContents, fileLength, nullptr, &err);
+    string pdfData(fileContents, fileLength);
+    g_free(fileContents);
+
+    string key = LatexCache::computeKey(createTexContents(renderedTex));
+    std::unique_ptr<TexImage> img = createTexImage(std::move(renderedTex), pdfData);
+    if (img != nullptr) {
+        LatexCache::getInstance().store(key, pdfData);
+    }
+    return img;
+}
+
+auto LatexController::createTexImage(string renderedTex, const string& pdfData) -> std::unique_ptr<TexImage> {
+    GError* err = nullptr;
+    // Poppler does not copy the data, pdfData outlives the document
+    PopplerDocument* pdf = poppler_document_new_from_data(const_cast<char*>(pdfData.c_str()), pdfData.length(),
+                                                          nullptr, &err);
     if (err != nullptr) {
         string message = FS(_F("Could not load LaTeX PDF file: {1}") % err->message);
         g_message("%s", message.c_str());
@@ -389,12 +619,13 @@ auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexIma
 
     std::unique_ptr<TexImage> img = convertDocumentToImage(pdf, std::move(renderedTex));
     g_object_unref(pdf);
+    if (img == nullptr) {
+        return nullptr;
+    }
 
     // Do not assign the PDF, theoretical it should work, but it gets a Poppler PDF error
     // img->setPdf(pdf);
-    img->setBinaryData(string(fileContents, fileLength));
-
-    g_free(fileContents);
+    img->setBinaryData(pdfData);
 
     return img;
 }
@@ -423,9 +654,17 @@ void LatexController::run() {
         return;
     }
 
+    if (this->control->getSettings()->getLatexPrecompiledPreamble()) {
+        this->buildPreambleFormat();
+    }
+
     this->findSelectedTexElement();
     string newTex = this->showTexEditDialog();
 
+    LatexCache& cache = LatexCache::getInstance();
+    g_debug("LaTeX cache: %zu formulas, %zu KiB, %zu of %zu previews loaded from the cache", cache.getCount(),
+            cache.getSize() / 1024, cache.getHits(), cache.getLookups());
+
     if (this->initialTex != newTex) {
         g_assert(this->isValidTex);
         this->insertTexImage();
@@ -51,6 +51,8 @@ public:
     void run();
 
 private:
+    struct RenderJob;
+
     /**
      * Provides information about whether a particular dependency was found or not.
      */
@@ -78,21 +80,40 @@ private:
 
     /**
      * Run the LaTeX command asynchronously to generate a preview for the given
-     * LaTeX string. Note that this method can only be called when the preview
-     * is not updating.
+     * LaTeX string. Note that this method can only be called when no render
+     * is running.
      *
-     * @return The PID of the spawned process, or nullptr if the .tex file could
-     * not be written or the command failed to start.
+     * @return false if the .tex file could not be written or the command
+     * failed to start.
+     */
+    bool runCommandAsync(const string& texString);
+
+    /**
+     * Kill the running pdflatex process, its result is dropped.
+     */
+    void cancelRender();
+
+    /**
+     * Start precompiling the preamble, if it was not done in this session.
      */
-    std::unique_ptr<GPid> runCommandAsync(const string& texString);
+    void buildPreambleFormat();
+
+    static void onPreambleFormatComplete(GPid pid, gint returnCode, gpointer unused);
 
     /**
      * Asynchronously runs the LaTeX command and then updates the TeX image with
-     * the given LaTeX string. If the preview is already being updated, then
-     * this method will be a no-op.
+     * the given LaTeX string. A render which is still running is cancelled.
      */
     void triggerImageUpdate(const string& texString);
 
+    /**
+     * Update the preview immediately if nothing is in progress, else after the
+     * user paused typing for a moment.
+     */
+    void scheduleImageUpdate();
+
+    static gboolean onUpdateTimeout(LatexController* self);
+
     /**
      * Show the LaTex Editor dialog, returning the final formula input by the
      * user. If the input was cancelled, the resulting string will be the same
@@ -107,12 +128,10 @@ private:
     static void handleTexChanged(GtkTextBuffer* buffer, LatexController* self);
 
     /**
-     * Updates the display once the PDF file is generated.
-     *
-     * If the Latex text has changed since the last update, triggerPreviewUpdate
-     * will be called again.
+     * Updates the display once the PDF file is generated, unless the render
+     * was cancelled in the meantime.
      */
-    static void onPdfRenderComplete(GPid pid, gint returnCode, LatexController* self);
+    static void onPdfRenderComplete(GPid pid, gint returnCode, RenderJob* job);
 
     void setUpdating(bool newValue);
 
@@ -123,9 +142,21 @@ private:
     std::unique_ptr<TexImage> convertDocumentToImage(PopplerDocument* doc, string formula) const;
 
     /**
-     * Load the preview PDF from disk and create a TexImage object.
+     * Load the preview PDF from disk and create a TexImage object. The PDF is added to the LatexCache.
+     */
+    std::unique_ptr<TexImage> loadRendered(const Path& pdfPath, string renderedTex);
+
+    /**
+     * Show the preview from the LatexCache, if the formula was rendered before.
+     *
+     * @return false if pdflatex needs to be run
      */
-    std::unique_ptr<TexImage> loadRendered(string renderedTex);
+    bool loadCached(const string& texString);
+
+    /**
+     * Create a TexImage object from the PDF data.
+     */
+    std::unique_ptr<TexImage> createTexImage(string renderedTex, const string& pdfData);
 
     /**
      * Insert the generated preview TexImage into the current page.
@@ -152,14 +183,24 @@ private:
     string initialTex;
 
     /**
-     * The last TeX string shown in the preview.
+     * Whether the preview is out of date, a preview is being generated or scheduled.
+     */
+    bool isUpdating = false;
+
+    /**
+     * The running pdflatex process, or nullptr
      */
-    string lastPreviewedTex;
+    RenderJob* currentJob = nullptr;
 
     /**
-     * Whether a preview is currently being generated.
+     * Incremented for every pdflatex run
      */
-    bool isUpdating = false;
+    int generation = 0;
+
+    /**
+     * Source of the delayed preview update, or 0
+     */
+    guint updateTimeout = 0;
 
     /**
      * Whether the current TeX string is valid.
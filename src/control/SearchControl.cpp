@@ -6,9 +6,12 @@
 #include "model/Text.h"
 #include "view/TextView.h"
 
-SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf) {
+#include "SearchIndex.h"
+
+SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index) {
     this->page = page;
     this->pdf = std::move(pdf);
+    this->index = index;
 }
 
 SearchControl::~SearchControl() { freeSearchResults(); }
@@ -36,7 +39,10 @@ auto SearchControl::search(string text, int* occures, double* top) -> bool {
     }
 
     if (this->pdf) {
-        this->results = this->pdf->findText(text);
+        int pdfPage = this->page->getPdfPageNr();
+        if (this->index == nullptr || pdfPage < 0 || !this->index->findPdfText(pdfPage, text, this->results)) {
+            this->results = this->pdf->findText(text);
+        }
     }
 
     for (Layer* l: *this->page->getLayers()) {
@@ -48,6 +54,11 @@ auto SearchControl::search(string text, int* occures, double* top) -> bool {
             if (e->getType() == ELEMENT_TEXT) {
                 Text* t = dynamic_cast<Text*>(e);
 
+                // Layouting the text is expensive, only do this if there is something to find
+                if (SearchIndex::countMatches(t->getText(), text) == 0) {
+                    continue;
+                }
+
                 vector<XojPdfRectangle> textResult = TextView::findText(t, text);
 
                 this->results.insert(this->results.end(), textResult.begin(), textResult.end());
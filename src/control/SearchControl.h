@@ -15,9 +15,11 @@
 #include "pdf/base/XojPdfPage.h"
 #include "util/GtkColorWrapper.h"
 
+class SearchIndex;
+
 class SearchControl {
 public:
-    SearchControl(const PageRef& page, XojPdfPageSPtr pdf);
+    SearchControl(const PageRef& page, XojPdfPageSPtr pdf, SearchIndex* index);
     virtual ~SearchControl();
 
     bool search(string text, int* occures, double* top);
@@ -29,6 +31,7 @@ private:
 private:
     PageRef page;
     XojPdfPageSPtr pdf;
+    SearchIndex* index;
 
     vector<XojPdfRectangle> results;
 };
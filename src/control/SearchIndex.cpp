@@ -0,0 +1,263 @@
+#include "SearchIndex.h"
+
+#include <algorithm>
+
+#include "control/Control.h"
+#include "jobs/SearchIndexJob.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Text.h"
+
+#include "StringUtils.h"
+
+SearchIndex::SearchIndex(Control* control): control(control) { g_mutex_init(&this->mutex); }
+
+SearchIndex::~SearchIndex() { g_mutex_clear(&this->mutex); }
+
+void SearchIndex::documentChanged(DocumentChangeType type) {
+    if (type == DOCUMENT_CHANGE_CLEARED) {
+        clear();
+    } else if (type == DOCUMENT_CHANGE_COMPLETE) {
+        rebuild();
+    }
+}
+
+void SearchIndex::clear() {
+    g_mutex_lock(&this->mutex);
+    this->generation++;
+    this->pdfPages.clear();
+    this->indexedCount = 0;
+    g_mutex_unlock(&this->mutex);
+}
+
+void SearchIndex::rebuild() {
+    Document* doc = this->control->getDocument();
+    doc->lock();
+    size_t count = doc->getPdfPageCount();
+    doc->unlock();
+
+    g_mutex_lock(&this->mutex);
+    this->generation++;
+    int generation = this->generation;
+    this->pdfPages.clear();
+    this->pdfPages.resize(count);
+    this->indexedCount = 0;
+    g_mutex_unlock(&this->mutex);
+
+    scheduleIndexJob(0, generation);
+}
+
+auto SearchIndex::isComplete() -> bool {
+    g_mutex_lock(&this->mutex);
+    bool complete = this->indexedCount == this->pdfPages.size();
+    g_mutex_unlock(&this->mutex);
+
+    return complete;
+}
+
+auto SearchIndex::scheduleIndexJob(size_t pdfPage, int generation) -> bool {
+    g_mutex_lock(&this->mutex);
+    bool valid = generation == this->generation && pdfPage < this->pdfPages.size();
+    g_mutex_unlock(&this->mutex);
+
+    if (!valid) {
+        return false;
+    }
+
+    auto* job = new SearchIndexJob(this, pdfPage, generation);
+    this->control->getScheduler()->addJob(job, JOB_PRIORITY_NONE);
+    job->unref();
+
+    return true;
+}
+
+auto SearchIndex::indexPdfPage(size_t pdfPage, int generation) -> bool {
+    Document* doc = this->control->getDocument();
+    doc->lock();
+    XojPdfPageSPtr pdf = doc->getPdfPage(pdfPage);
+    doc->unlock();
+
+    PdfPageIndex entry;
+    entry.indexed = true;
+    if (pdf) {
+        string text = pdf->getTextLayout(entry.glyphs);
+        entry.text = normalize(text);
+    }
+
+    g_mutex_lock(&this->mutex);
+    bool valid = generation == this->generation && pdfPage < this->pdfPages.size();
+    if (valid) {
+        this->pdfPages[pdfPage] = std::move(entry);
+        this->indexedCount++;
+    }
+    g_mutex_unlock(&this->mutex);
+
+    return valid;
+}
+
+void SearchIndex::indexFinished(int generation) {
+    g_mutex_lock(&this->mutex);
+    bool valid = generation == this->generation;
+    g_mutex_unlock(&this->mutex);
+
+    SearchBar* searchBar = this->control->getSearchBar();
+    if (valid && searchBar) {
+        searchBar->updateDocumentResults();
+    }
+}
+
+auto SearchIndex::normalize(const string& text) -> vector<gunichar> {
+    vector<gunichar> result;
+    result.reserve(text.length());
+
+    for (const char* p = text.c_str(); *p; p = g_utf8_next_char(p)) {
+        gunichar c = g_utf8_get_char_validated(p, -1);
+        if (c == static_cast<gunichar>(-1) || c == static_cast<gunichar>(-2)) {
+            c = 0xFFFD;
+        }
+
+        // Line breaks of the PDF text are matched by a space in the search text
+        if (g_unichar_isspace(c)) {
+            c = ' ';
+        }
+
+        result.push_back(g_unichar_tolower(c));
+    }
+
+    return result;
+}
+
+auto SearchIndex::findAll(const vector<gunichar>& haystack, const vector<gunichar>& needle) -> vector<size_t> {
+    vector<size_t> positions;
+    if (needle.empty()) {
+        return positions;
+    }
+
+    auto it = haystack.begin();
+    while ((it = std::search(it, haystack.end(), needle.begin(), needle.end())) != haystack.end()) {
+        positions.push_back(it - haystack.begin());
+        ++it;
+    }
+
+    return positions;
+}
+
+void SearchIndex::addMatchRectangles(const PdfPageIndex& page, size_t start, size_t length,
+                                     vector<XojPdfRectangle>& results) {
+    bool hasRect = false;
+    XojPdfRectangle rect;
+
+    size_t end = std::min(start + length, page.glyphs.size());
+    for (size_t i = start; i < end; i++) {
+        if (page.text[i] == ' ') {
+            continue;
+        }
+
+        const XojPdfRectangle& glyph = page.glyphs[i];
+
+        // Merge characters on the same line, a match over a line break gets one rectangle per line
+        if (hasRect && glyph.y1 < rect.y2 && glyph.y2 > rect.y1 && glyph.x1 >= rect.x1) {
+            rect.x2 = std::max(rect.x2, glyph.x2);
+            rect.y1 = std::min(rect.y1, glyph.y1);
+            rect.y2 = std::max(rect.y2, glyph.y2);
+            continue;
+        }
+
+        if (hasRect) {
+            results.push_back(rect);
+        }
+        rect = glyph;
+        hasRect = true;
+    }
+
+    if (hasRect) {
+        results.push_back(rect);
+    }
+}
+
+auto SearchIndex::findPdfText(size_t pdfPage, const string& text, vector<XojPdfRectangle>& results) -> bool {
+    vector<gunichar> needle = normalize(text);
+
+    g_mutex_lock(&this->mutex);
+    if (pdfPage >= this->pdfPages.size() || !this->pdfPages[pdfPage].indexed) {
+        g_mutex_unlock(&this->mutex);
+        return false;
+    }
+
+    const PdfPageIndex& page = this->pdfPages[pdfPage];
+    results.clear();
+    for (size_t pos: findAll(page.text, needle)) {
+        addMatchRectangles(page, pos, needle.size(), results);
+    }
+    g_mutex_unlock(&this->mutex);
+
+    return true;
+}
+
+auto SearchIndex::countMatches(const string& str, const string& text) -> size_t {
+    if (text.empty()) {
+        return 0;
+    }
+
+    string haystack = StringUtils::toLowerCase(str);
+    string needle = StringUtils::toLowerCase(text);
+
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != string::npos; pos = haystack.find(needle, pos + 1)) {
+        count++;
+    }
+
+    return count;
+}
+
+auto SearchIndex::countTextElements(const PageRef& page, const string& text) -> size_t {
+    size_t count = 0;
+
+    for (Layer* l: *page->getLayers()) {
+        if (!page->isLayerVisible(l)) {
+            continue;
+        }
+
+        for (Element* e: *l->getElements()) {
+            if (e->getType() == ELEMENT_TEXT) {
+                count += countMatches(dynamic_cast<Text*>(e)->getText(), text);
+            }
+        }
+    }
+
+    return count;
+}
+
+auto SearchIndex::countOnPage(const PageRef& page, const string& text) -> size_t {
+    Document* doc = this->control->getDocument();
+    doc->lock();
+    size_t count = countTextElements(page, text);
+    int pdfPage = page->getPdfPageNr();
+    doc->unlock();
+
+    if (pdfPage < 0) {
+        return count;
+    }
+
+    vector<gunichar> needle = normalize(text);
+
+    g_mutex_lock(&this->mutex);
+    if (static_cast<size_t>(pdfPage) < this->pdfPages.size() && this->pdfPages[pdfPage].indexed) {
+        count += findAll(this->pdfPages[pdfPage].text, needle).size();
+        g_mutex_unlock(&this->mutex);
+        return count;
+    }
+    g_mutex_unlock(&this->mutex);
+
+    // Not yet indexed, ask the PDF directly
+    doc->lock();
+    XojPdfPageSPtr pdf = doc->getPdfPage(pdfPage);
+    doc->unlock();
+
+    if (pdf) {
+        string search = text;
+        count += pdf->findText(search).size();
+    }
+
+    return count;
+}
@@ -0,0 +1,135 @@
+/*
+ * Xournal++
+ *
+ * Full document text search index
+ *
+ * The text of the PDF background pages is extracted once, together with
+ * the position of every character, on the background scheduler. Searching
+ * then only needs a lookup in memory, instead of asking poppler page by page.
+ * Text elements are always searched on their current content, so they are
+ * never outdated.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+#include "model/DocumentListener.h"
+#include "model/PageRef.h"
+#include "pdf/base/XojPdfPage.h"
+
+#include "XournalType.h"
+
+class Control;
+
+class SearchIndex: public DocumentListener {
+public:
+    SearchIndex(Control* control);
+    ~SearchIndex() override;
+
+private:
+    SearchIndex(const SearchIndex& index);
+    void operator=(const SearchIndex& index);
+
+public:
+    void documentChanged(DocumentChangeType type) override;
+
+public:
+    /**
+     * Drop the index and start indexing the PDF pages of the current document
+     */
+    void rebuild();
+
+    /**
+     * Drop the index
+     */
+    void clear();
+
+    /**
+     * @return true if all PDF pages are indexed
+     */
+    bool isComplete();
+
+    /**
+     * Find the text on an indexed PDF page (case insensitive)
+     *
+     * @return false if the page is not (yet) indexed, results are not touched in this case
+     */
+    bool findPdfText(size_t pdfPage, const string& text, vector<XojPdfRectangle>& results);
+
+    /**
+     * Count the occurrences of the text on the page, including the PDF background and all visible Text elements.
+     * If the PDF page is not yet indexed it's searched directly.
+     *
+     * Locks the document, may be called from the scheduler thread.
+     */
+    size_t countOnPage(const PageRef& page, const string& text);
+
+    /**
+     * Count the case insensitive occurrences of text in str
+     */
+    static size_t countMatches(const string& str, const string& text);
+
+    // Called by the SearchIndexJob
+public:
+    /**
+     * Extract the text of a PDF page and add it to the index, runs on the scheduler thread
+     *
+     * @return false if the index generation is outdated
+     */
+    bool indexPdfPage(size_t pdfPage, int generation);
+
+    /**
+     * Add a job for the next PDF page to the scheduler
+     *
+     * @return false if there are no more pages to index
+     */
+    bool scheduleIndexJob(size_t pdfPage, int generation);
+
+    /**
+     * All pages are indexed, called from the UI Thread
+     */
+    void indexFinished(int generation);
+
+private:
+    /**
+     * A normalized (lower case, one entry per character) copy of the page text
+     */
+    class PdfPageIndex {
+    public:
+        bool indexed = false;
+        vector<gunichar> text;
+        vector<XojPdfRectangle> glyphs;
+    };
+
+    static vector<gunichar> normalize(const string& text);
+    static vector<size_t> findAll(const vector<gunichar>& haystack, const vector<gunichar>& needle);
+    static void addMatchRectangles(const PdfPageIndex& page, size_t start, size_t length,
+                                   vector<XojPdfRectangle>& results);
+
+    size_t countTextElements(const PageRef& page, const string& text);
+
+private:
+    Control* control = nullptr;
+
+    /**
+     * Protects pdfPages, generation and indexedCount, the index is filled from the scheduler thread
+     */
+    GMutex mutex{};
+
+    vector<PdfPageIndex> pdfPages;
+    size_t indexedCount = 0;
+
+    /**
+     * Incremented on each rebuild, so jobs of an older document can detect they are outdated
+     */
+    int generation = 0;
+};
@@ -0,0 +1,257 @@
+#include "SingleInstance.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+
+#ifdef G_OS_UNIX
+#include <fcntl.h>
+#include <gio/gunixsocketaddress.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include "Control.h"
+
+constexpr const char* SOCKET_NAME = "xournalpp.socket";
+constexpr const char* LOCK_NAME = "xournalpp.lock";
+constexpr const char* REQUEST_OPEN = "open";
+constexpr const char* REPLY_OK = "ok";
+constexpr const char* REPLY_FAILED = "failed";
+
+struct IncomingRequest {
+    SingleInstance* instance;
+    GSocketConnection* connection;
+    GDataInputStream* in;
+    string line;
+};
+
+SingleInstance::SingleInstance() = default;
+
+SingleInstance::~SingleInstance() {
+    for (IncomingRequest* request: this->pending) {
+        reply(request, REPLY_FAILED);
+    }
+    this->pending.clear();
+
+    if (this->service != nullptr) {
+        g_socket_service_stop(this->service);
+        g_socket_listener_close(G_SOCKET_LISTENER(this->service));
+        g_object_unref(this->service);
+        this->service = nullptr;
+
+        g_unlink(getSocketPath().c_str());
+    }
+
+#ifdef G_OS_UNIX
+    if (this->lockFd != -1) {
+        // Closing releases the lock
+        close(this->lockFd);
+        this->lockFd = -1;
+    }
+#endif
+}
+
+auto SingleInstance::getSocketPath() -> Path { return Path(g_get_user_runtime_dir()) / SOCKET_NAME; }
+
+auto SingleInstance::forward(const Path& file, int page, bool& opened) -> bool {
+#ifdef G_OS_UNIX
+    GSocketAddress* address = g_unix_socket_address_new(getSocketPath().c_str());
+    GSocketClient* client = g_socket_client_new();
+    GSocketConnection* connection = g_socket_client_connect(client, G_SOCKET_CONNECTABLE(address), nullptr, nullptr);
+    g_object_unref(client);
+    g_object_unref(address);
+
+    if (connection == nullptr) {
+        // No running instance
+        return false;
+    }
+
+    string request = formatRequest(file, page);
+    GOutputStream* out = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+    if (!g_output_stream_write_all(out, request.c_str(), request.length(), nullptr, nullptr, nullptr)) {
+        g_object_unref(connection);
+        return false;
+    }
+
+    GDataInputStream* in = g_data_input_stream_new(g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+    gchar* reply = g_data_input_stream_read_line(in, nullptr, nullptr, nullptr);
+    opened = reply != nullptr && strcmp(reply, REPLY_OK) == 0;
+    g_free(reply);
+
+    g_object_unref(in);
+    g_object_unref(connection);
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto SingleInstance::lock() -> bool {
+#ifdef G_OS_UNIX
+    Path lockPath = Path(g_get_user_runtime_dir()) / LOCK_NAME;
+    this->lockFd = g_open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (this->lockFd == -1) {
+        g_warning("Could not open %s: %s", lockPath.c_str(), g_strerror(errno));
+        return false;
+    }
+
+    if (flock(this->lockFd, LOCK_EX | LOCK_NB) != 0) {
+        close(this->lockFd);
+        this->lockFd = -1;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto SingleInstance::listen() -> bool {
+#ifdef G_OS_UNIX
+    if (!lock()) {
+        // Another instance owns the socket, it may still be starting
+        return false;
+    }
+
+    Path socketPath = getSocketPath();
+
+    // The lock is free, so the socket was left over by an instance which crashed
+    g_unlink(socketPath.c_str());
+
+    this->service = g_socket_service_new();
+
+    GError* err = nullptr;
+    GSocketAddress* address = g_unix_socket_address_new(socketPath.c_str());
+    bool added = g_socket_listener_add_address(G_SOCKET_LISTENER(this->service), address, G_SOCKET_TYPE_STREAM,
+                                               G_SOCKET_PROTOCOL_DEFAULT, nullptr, nullptr, &err);
+    g_object_unref(address);
+
+    if (!added) {
+        g_warning("Could not listen on %s: %s", socketPath.c_str(), err->message);
+        g_error_free(err);
+        g_object_unref(this->service);
+        this->service = nullptr;
+        return false;
+    }
+
+    g_signal_connect(this->service, "incoming", G_CALLBACK(incomingCallback), this);
+    g_socket_service_start(this->service);
+    return true;
+#else
+    g_warning("Single instance mode is not supported on this platform");
+    return false;
+#endif
+}
+
+void SingleInstance::setControl(Control* control) {
+    this->control = control;
+    if (control == nullptr) {
+        return;
+    }
+
+    std::vector<IncomingRequest*> requests;
+    std::swap(requests, this->pending);
+    for (IncomingRequest* request: requests) {
+        reply(request, handleRequest(request->line));
+    }
+}
+
+auto SingleInstance::incomingCallback(GSocketService* service, GSocketConnection* connection, GObject* sourceObject,
+                                      SingleInstance* instance) -> bool {
+    auto* request = new IncomingRequest;
+    request->instance = instance;
+    request->connection = G_SOCKET_CONNECTION(g_object_ref(connection));
+    request->in = g_data_input_stream_new(g_io_stream_get_input_stream(G_IO_STREAM(connection)));
+
+    // Read asynchronously, a client which does not send anything must not block the UI
+    g_data_input_stream_read_line_async(
+            request->in, G_PRIORITY_DEFAULT, nullptr,
+            +[](GObject* source, GAsyncResult* res, gpointer data) {
+                auto* request = static_cast<IncomingRequest*>(data);
+                SingleInstance* instance = request->instance;
+
+                gchar* line = g_data_input_stream_read_line_finish(request->in, res, nullptr, nullptr);
+                if (line == nullptr) {
+                    reply(request, "");
+                    return;
+                }
+                request->line = line;
+                g_free(line);
+
+                if (instance->control == nullptr) {
+                    // The window is not built yet
+                    instance->pending.push_back(request);
+                    return;
+                }
+                reply(request, instance->handleRequest(request->line));
+            },
+            request);
+
+    return true;
+}
+
+/**
+ * Send the reply, an empty reply only closes the connection
+ */
+void SingleInstance::reply(IncomingRequest* request, const string& reply) {
+    if (!reply.empty()) {
+        string line = reply + "\n";
+        GOutputStream* out = g_io_stream_get_output_stream(G_IO_STREAM(request->connection));
+        g_output_stream_write_all(out, line.c_str(), line.length(), nullptr, nullptr, nullptr);
+    }
+
+    g_object_unref(request->in);
+    g_object_unref(request->connection);
+    delete request;
+}
+
+auto SingleInstance::handleRequest(const string& request) -> string {
+    Path file;
+    int page = -1;
+    if (!parseRequest(request, file, page)) {
+        g_warning("Invalid request from another instance: %s", request.c_str());
+        return REPLY_FAILED;
+    }
+
+    gtk_window_present(this->control->getGtkWindow());
+
+    if (file.isEmpty()) {
+        return REPLY_OK;
+    }
+
+    return this->control->openFile(file, page) ? REPLY_OK : REPLY_FAILED;
+}
+
+auto SingleInstance::formatRequest(const Path& file, int page) -> string {
+    gchar* path = g_strescape(file.c_str(), nullptr);
+
+    string request = REQUEST_OPEN;
+    request += " ";
+    request += std::to_string(page);
+    request += " ";
+    request += path;
+    request += "\n";
+    g_free(path);
+
+    return request;
+}
+
+auto SingleInstance::parseRequest(const string& request, Path& file, int& page) -> bool {
+    gchar** parts = g_strsplit(request.c_str(), " ", 3);
+    if (g_strv_length(parts) != 3 || strcmp(parts[0], REQUEST_OPEN) != 0) {
+        g_strfreev(parts);
+        return false;
+    }
+
+    page = static_cast<int>(g_ascii_strtoll(parts[1], nullptr, 10));
+
+    gchar* path = g_strcompress(parts[2]);
+    file = Path(path);
+    g_free(path);
+    g_strfreev(parts);
+
+    return true;
+}
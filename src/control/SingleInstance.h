@@ -0,0 +1,105 @@
+/*
+ * Xournal++
+ *
+ * Forwards files to open to an already running instance
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <gio/gio.h>
+
+#include "Path.h"
+#include "XournalType.h"
+
+class Control;
+struct IncomingRequest;
+
+/**
+ * With --single-instance the first instance listens on a local socket in the user runtime folder. Later instances
+ * started with the same option send the file and page to this socket and exit, without initializing GTK.
+ *
+ * The listening instance holds a lock on a file next to the socket, so a socket is only replaced if the instance which
+ * created it is no longer running. Listening starts before the main window is built, requests received until then are
+ * answered as soon as the window is shown.
+ *
+ * A request is one line "open <page> <escaped path>", the path is empty to only raise the window. The reply is
+ * one line "ok" or "failed", after the file was opened.
+ *
+ * Only supported on Unix, on other platforms a new instance is started.
+ */
+class SingleInstance {
+public:
+    SingleInstance();
+    virtual ~SingleInstance();
+
+private:
+    SingleInstance(const SingleInstance& instance) = delete;
+    void operator=(const SingleInstance& instance) = delete;
+
+public:
+    /**
+     * Send the file to a running instance
+     *
+     * @param file The absolute path of the file, or empty
+     * @param page The page to scroll to, -1 for the default
+     * @param opened Set if the running instance could open the file
+     * @return true if there is a running instance which handled the request
+     */
+    static bool forward(const Path& file, int page, bool& opened);
+
+    /**
+     * Accept the requests of instances started later
+     *
+     * @return false if another instance is listening or the socket could not be created
+     */
+    bool listen();
+
+    /**
+     * Set the control which opens the requested files, and answer the requests received until now
+     */
+    void setControl(Control* control);
+
+private:
+    static Path getSocketPath();
+
+    /**
+     * Lock the file next to the socket, the lock is released when the instance exits or crashes
+     *
+     * @return false if another instance holds the lock
+     */
+    bool lock();
+
+    static bool incomingCallback(GSocketService* service, GSocketConnection* connection, GObject* sourceObject,
+                                 SingleInstance* instance);
+
+    /**
+     * Open the requested file
+     *
+     * @return The reply
+     */
+    string handleRequest(const string& request);
+
+    static void reply(IncomingRequest* request, const string& reply);
+
+    static string formatRequest(const Path& file, int page);
+    static bool parseRequest(const string& request, Path& file, int& page);
+
+private:
+    Control* control = nullptr;
+
+    GSocketService* service = nullptr;
+    int lockFd = -1;
+
+    /**
+     * Requests received before the control was set
+     */
+    std::vector<IncomingRequest*> pending;
+};
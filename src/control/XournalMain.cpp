@@ -17,7 +17,9 @@
 #include "xojfile/LoadHandler.h"
 
 #include "Control.h"
+#include "SingleInstance.h"
 #include "Stacktrace.h"
+#include "StartupTrace.h"
 #include "StringUtils.h"
 #include "XojMsgBox.h"
 #include "config-dev.h"
@@ -258,6 +260,7 @@ auto XournalMain::exportPdf(const char* input, const char* output) -> int {
 
 auto XournalMain::run(int argc, char* argv[]) -> int {
     this->initLocalisation();
+    StartupTrace::mark("localisation");
 
     GError* error = nullptr;
     GOptionContext* context = g_option_context_new("FILE");
@@ -266,14 +269,22 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
     gchar* pdfFilename = nullptr;
     gchar* imgFilename = nullptr;
     int openAtPageNumber = -1;
+    gboolean startupTrace = false;
+    gboolean singleInstance = false;
 
     string create_pdf = _("PDF output filename");
     string create_img = _("Image output filename (.png / .svg)");
     string page_jump = _("Jump to Page (first Page: 1)");
     string audio_folder = _("Absolute path for the audio files playback");
+    string startup_trace = _("Print the time needed for the startup phases");
+    string single_instance = _("Open the file in a running instance, which was also started with this option");
     GOptionEntry options[] = {{"create-pdf", 'p', 0, G_OPTION_ARG_FILENAME, &pdfFilename, create_pdf.c_str(), nullptr},
                               {"create-img", 'i', 0, G_OPTION_ARG_FILENAME, &imgFilename, create_img.c_str(), nullptr},
                               {"page", 'n', 0, G_OPTION_ARG_INT, &openAtPageNumber, page_jump.c_str(), "N"},
+                              {"startup-trace", 0, 0, G_OPTION_ARG_NONE, &startupTrace, startup_trace.c_str(),
+                               nullptr},
+                              {"single-instance", 0, 0, G_OPTION_ARG_NONE, &singleInstance,
+                               single_instance.c_str(), nullptr},
                               {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &optFilename, "<input>", nullptr},
                               {nullptr}};
 
@@ -289,6 +300,7 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
         error = nullptr;
     }
     g_option_context_free(context);
+    StartupTrace::setEnabled(startupTrace);
 
     if (pdfFilename && optFilename && *optFilename) {
         return exportPdf(*optFilename, pdfFilename);
@@ -297,6 +309,30 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
         return exportImg(*optFilename, imgFilename);
     }
 
+    SingleInstance instance;
+    if (singleInstance) {
+        bool hasFile = optFilename && *optFilename;
+        Path file;
+        if (hasFile) {
+            GFile* gfile = g_file_new_for_commandline_arg(optFilename[0]);
+            file = Path::fromGFile(gfile);
+            g_object_unref(gfile);
+        }
+
+        // Remote files are not forwarded, this instance shows the error
+        bool forwardable = !hasFile || !file.isEmpty();
+        bool opened = false;
+        if (forwardable && SingleInstance::forward(file, openAtPageNumber, opened)) {
+            return opened ? 0 : 1;
+        }
+
+        // Listen before the window is built, so instances started meanwhile are forwarded to this one. If another
+        // instance started at the same time won, forward to it.
+        if (!instance.listen() && forwardable && SingleInstance::forward(file, openAtPageNumber, opened)) {
+            return opened ? 0 : 1;
+        }
+    }
+
     // Checks for input method compatibility
 
     const char* imModule = g_getenv("GTK_IM_MODULE");
@@ -307,6 +343,7 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
 
     // Init GTK Display
     gtk_init(&argc, &argv);
+    StartupTrace::mark("gtk_init");
 
     auto* gladePath = new GladeSearchpath();
     initResourcePath(gladePath, "ui/about.glade");
@@ -316,8 +353,10 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
     // init singleton
     string colorNameFile = Util::getConfigFile("colornames.ini").str();
     ToolbarColorNames::getInstance().loadFile(colorNameFile);
+    StartupTrace::mark("resources");
 
     auto* control = new Control(gladePath);
+    StartupTrace::mark("control");
 
     if (control->getSettings()->isDarkTheme()) {
         string icon = gladePath->getFirstSearchPath() + "/iconsDark/";
@@ -328,9 +367,12 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
     gtk_icon_theme_prepend_search_path(gtk_icon_theme_get_default(), icon.c_str());
 
     auto* win = new MainWindow(gladePath, control);
+    StartupTrace::mark("main window");
     control->initWindow(win);
+    StartupTrace::mark("init window");
 
     win->show(nullptr);
+    StartupTrace::mark("show window");
 
     bool opened = false;
     if (optFilename) {
@@ -358,6 +400,10 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
     if (!opened) {
         control->newFile();
     }
+    StartupTrace::mark("open document");
+
+    // Answer the requests received while starting
+    instance.setControl(control);
 
     checkForErrorlog();
     checkForEmergencySave(control);
@@ -374,6 +420,8 @@ auto XournalMain::run(int argc, char* argv[]) -> int {
 
     control->getScheduler()->stop();
 
+    instance.setControl(nullptr);
+
     delete win;
     delete control;
     delete gladePath;
@@ -19,6 +19,7 @@ void AutosaveJob::afterRun() {
 
 void AutosaveJob::run() {
     SaveHandler handler;
+    handler.setCompressionLevel(Settings::getCompressionLevel(control->getSettings()->getAutosaveStorageProfile()));
 
     control->getUndoRedoHandler()->documentAutosaved();
 
@@ -16,7 +16,14 @@
 
 #include "XournalType.h"
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType {
+    JOB_TYPE_BLOCKING,
+    JOB_TYPE_PREVIEW,
+    JOB_TYPE_RENDER,
+    JOB_TYPE_AUTOSAVE,
+    JOB_TYPE_SEARCH_INDEX,
+    JOB_TYPE_SEARCH
+};
 
 class Job {
 public:
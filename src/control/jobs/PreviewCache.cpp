@@ -0,0 +1,150 @@
+#include "PreviewCache.h"
+
+#include <utility>
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <glib/gstdio.h>
+
+#include "model/Document.h"
+#include "model/Image.h"
+#include "model/Layer.h"
+#include "serializing/BinObjectEncoding.h"
+#include "serializing/ObjectOutputStream.h"
+
+#include "Util.h"
+
+PreviewCache* PreviewCache::instance = nullptr;
+
+PreviewCache::PreviewCache(Path folder): DiskCache(std::move(folder), ".png", MAX_SIZE) {}
+
+PreviewCache::~PreviewCache() = default;
+
+auto PreviewCache::getInstance() -> PreviewCache& {
+    if (instance == nullptr) {
+        instance = new PreviewCache(Util::getCacheSubfolder("previews"));
+    }
+
+    return *instance;
+}
+
+static void updateChecksum(GChecksum* checksum, cairo_surface_t* surface) {
+    if (surface == nullptr || cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return;
+    }
+
+    cairo_surface_flush(surface);
+    g_checksum_update(checksum, cairo_image_surface_get_data(surface),
+                      cairo_image_surface_get_stride(surface) * cairo_image_surface_get_height(surface));
+}
+
+auto PreviewCache::computePageKey(Document* doc, PageRef page, int width, int height, double zoom) -> string {
+    Path filename = doc->getFilename();
+    if (filename.isEmpty()) {
+        return "";
+    }
+
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    ObjectOutputStream out(new BinObjectEncoding());
+
+    out.writeString(filename.str());
+    out.writeInt(width);
+    out.writeInt(height);
+    out.writeDouble(zoom);
+
+    PageType type = page->getBackgroundType();
+    out.writeDouble(page->getWidth());
+    out.writeDouble(page->getHeight());
+    out.writeInt(static_cast<int>(type.format));
+    out.writeString(type.config);
+    out.writeInt(page->getBackgroundColor());
+    out.writeInt(page->isLayerVisible(0));
+
+    if (type.isPdfPage()) {
+        Path pdf = doc->getPdfFilename();
+        out.writeString(pdf.str());
+        out.writeSizeT(page->getPdfPageNr());
+
+        GStatBuf pdfStat;
+        if (g_stat(pdf.c_str(), &pdfStat) == 0) {
+            out.writeSizeT(static_cast<size_t>(pdfStat.st_mtime));
+        }
+    } else if (type.isImagePage()) {
+        GdkPixbuf* pixbuf = page->getBackgroundImage().getPixbuf();
+        if (pixbuf != nullptr) {
+            g_checksum_update(checksum, gdk_pixbuf_get_pixels(pixbuf), gdk_pixbuf_get_byte_length(pixbuf));
+        }
+    }
+
+    for (Layer* l: *page->getLayers()) {
+        out.writeInt(l->isVisible());
+
+        for (Element* e: *l->getElements()) {
+            if (e->getType() == ELEMENT_IMAGE) {
+                // Encoding the image as PNG would take longer than rendering it, use the pixels
+                out.writeDouble(e->getX());
+                out.writeDouble(e->getY());
+                out.writeDouble(e->getElementWidth());
+                out.writeDouble(e->getElementHeight());
+                updateChecksum(checksum, dynamic_cast<Image*>(e)->getImage());
+            } else {
+                e->serialize(out);
+            }
+        }
+    }
+
+    GString* data = out.getStr();
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(data->str), data->len);
+    g_string_free(data, true);
+
+    string key = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return key;
+}
+
+struct PngReader {
+    const string& data;
+    size_t offset;
+};
+
+auto PreviewCache::lookupSurface(const string& key) -> cairo_surface_t* {
+    string png;
+    if (!lookup(key, png)) {
+        return nullptr;
+    }
+
+    PngReader reader = {png, 0};
+    cairo_surface_t* surface = cairo_image_surface_create_from_png_stream(
+            +[](void* closure, unsigned char* data, unsigned int length) {
+                auto* reader = static_cast<PngReader*>(closure);
+                if (reader->offset + length > reader->data.length()) {
+                    return CAIRO_STATUS_READ_ERROR;
+                }
+                reader->data.copy(reinterpret_cast<char*>(data), length, reader->offset);
+                reader->offset += length;
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &reader);
+
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        g_warning("Invalid cached preview %s", key.c_str());
+        cairo_surface_destroy(surface);
+        return nullptr;
+    }
+
+    return surface;
+}
+
+void PreviewCache::storeSurface(const string& key, cairo_surface_t* surface) {
+    string png;
+    cairo_status_t status = cairo_surface_write_to_png_stream(
+            surface,
+            +[](void* closure, const unsigned char* data, unsigned int length) {
+                static_cast<string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &png);
+
+    if (status == CAIRO_STATUS_SUCCESS) {
+        store(key, png);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * Xournal++
+ *
+ * Persistent cache for sidebar page previews
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+
+#include <cairo.h>
+
+#include "control/DiskCache.h"
+#include "model/PageRef.h"
+
+class Document;
+
+/**
+ * Stores rendered page previews as PNG in the user cache folder. The key contains the document path, the content of
+ * the page and the size of the preview, so a changed page is a cache miss.
+ */
+class PreviewCache: public DiskCache {
+private:
+    PreviewCache(Path folder);
+    virtual ~PreviewCache();
+
+public:
+    static PreviewCache& getInstance();
+
+    /**
+     * The document needs to be locked
+     *
+     * @return The key of the page preview, empty if the document is not saved
+     */
+    static string computePageKey(Document* doc, PageRef page, int width, int height, double zoom);
+
+    /**
+     * @return The cached preview, nullptr on cache miss
+     */
+    cairo_surface_t* lookupSurface(const string& key);
+
+    void storeSurface(const string& key, cairo_surface_t* surface);
+
+public:
+    static constexpr size_t MAX_SIZE = 64 * 1024 * 1024;
+
+private:
+    static PreviewCache* instance;
+};
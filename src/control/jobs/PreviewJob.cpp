@@ -7,9 +7,13 @@
 #include "gui/sidebar/previews/layer/SidebarPreviewLayerEntry.h"
 #include "model/Document.h"
 #include "view/DocumentView.h"
+#include "view/LayerCache.h"
 #include "view/PdfView.h"
 
-PreviewJob::PreviewJob(SidebarPreviewBaseEntry* sidebar): sidebarPreview(sidebar) {}
+#include "PreviewCache.h"
+
+PreviewJob::PreviewJob(SidebarPreviewBaseEntry* sidebar, bool storeInCache):
+        sidebarPreview(sidebar), storeInCache(storeInCache) {}
 
 PreviewJob::~PreviewJob() { this->sidebarPreview = nullptr; }
 
@@ -18,9 +22,8 @@ auto PreviewJob::getSource() -> void* { return this->sidebarPreview; }
 auto PreviewJob::getType() -> JobType { return JOB_TYPE_PREVIEW; }
 
 void PreviewJob::initGraphics() {
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(this->sidebarPreview->widget, &alloc);
-    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+    crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->sidebarPreview->getWidgetWidth(),
+                                          this->sidebarPreview->getWidgetHeight());
     zoom = this->sidebarPreview->sidebar->getZoom();
     cr2 = cairo_create(crBuffer);
 }
@@ -83,9 +86,31 @@ void PreviewJob::drawPage(int layer) {
     cairo_destroy(cr2);
 }
 
+/**
+ * Scale the layer rendered by the main view
+ *
+ * @return false if the main view has not rendered the layer
+ */
+auto PreviewJob::drawCachedLayer(int layer) -> bool {
+    auto* entry = dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview);
+    if (entry->layerCache == nullptr) {
+        return false;
+    }
+
+    Layer* drawLayer = nullptr;
+    if (layer >= 0) {
+        drawLayer = (*this->sidebarPreview->page->getLayers())[layer];
+    }
+
+    return entry->layerCache->paintLayer(cr2, drawLayer);
+}
+
 void PreviewJob::run() {
-    initGraphics();
-    drawBorder();
+    if (!this->sidebarPreview->isInVisibleRange()) {
+        // Scrolled away before the job was run, the preview is scheduled again when it is drawn
+        this->sidebarPreview->releaseBuffer();
+        return;
+    }
 
     Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
     doc->lock();
@@ -97,13 +122,47 @@ void PreviewJob::run() {
         layer = (dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview))->getLayer();
     }
 
-    if (this->sidebarPreview->page->getBackgroundType().isPdfPage()) {
-        drawBackgroundPdf(doc);
+    // Page previews of saved documents are cached on disk, so reopening the document does not render all pages
+    string cacheKey;
+    if (RENDER_TYPE_PAGE_PREVIEW == type) {
+        cacheKey = PreviewCache::computePageKey(doc, this->sidebarPreview->page, this->sidebarPreview->getWidgetWidth(),
+                                                this->sidebarPreview->getWidgetHeight(),
+                                                this->sidebarPreview->sidebar->getZoom());
     }
 
-    drawPage(layer);
+    if (!cacheKey.empty()) {
+        crBuffer = PreviewCache::getInstance().lookupSurface(cacheKey);
+    }
+
+    bool rendered = false;
+    if (crBuffer == nullptr) {
+        initGraphics();
+        drawBorder();
+
+        // The cached background already contains the PDF
+        bool cached = RENDER_TYPE_PAGE_LAYER == type && layer == -1 && drawCachedLayer(layer);
+
+        if (!cached) {
+            if (this->sidebarPreview->page->getBackgroundType().isPdfPage()) {
+                drawBackgroundPdf(doc);
+            }
+
+            cached = RENDER_TYPE_PAGE_LAYER == type && layer >= 0 && drawCachedLayer(layer);
+        }
+
+        if (cached) {
+            cairo_destroy(cr2);
+        } else {
+            drawPage(layer);
+        }
+        rendered = true;
+    }
 
     doc->unlock();
 
+    if (rendered && this->storeInCache && !cacheKey.empty()) {
+        PreviewCache::getInstance().storeSurface(cacheKey, crBuffer);
+    }
+
     finishPaint();
 }
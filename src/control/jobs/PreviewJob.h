@@ -27,7 +27,11 @@ class Document;
  */
 class PreviewJob: public Job {
 public:
-    PreviewJob(SidebarPreviewBaseEntry* sidebar);
+    /**
+     * @param storeInCache If the rendered page preview is written to the PreviewCache. Only previews of pages which are
+     * unchanged since the document was saved can be found again, when the document is opened the next time.
+     */
+    PreviewJob(SidebarPreviewBaseEntry* sidebar, bool storeInCache);
 
 protected:
     virtual ~PreviewJob();
@@ -45,6 +49,7 @@ private:
     void finishPaint();
     void drawBackgroundPdf(Document* doc);
     void drawPage(int layer);
+    bool drawCachedLayer(int layer);
 
 private:
     /**
@@ -66,4 +71,6 @@ private:
      * Sidebar preview
      */
     SidebarPreviewBaseEntry* sidebarPreview = nullptr;
+
+    bool storeInCache = false;
 };
@@ -10,6 +10,7 @@
 #include "gui/XournalView.h"
 #include "model/Document.h"
 #include "view/DocumentView.h"
+#include "view/LayerCache.h"
 #include "view/PdfView.h"
 
 #include "Rectangle.h"
@@ -119,11 +120,17 @@ void RenderJob::run() {
         int width = this->view->page->getWidth();
         int height = this->view->page->getHeight();
 
-        bool backgroundVisible = this->view->page->isLayerVisible(0);
-        if (backgroundVisible) {
-            PdfView::drawPage(this->view->xournal->getCache(), popplerPage, cr2, zoom, width, height);
+        // Layers are shown and hidden on the selected page, keep them separately so this only composites them
+        bool composited = this->view->isSelected() &&
+                          this->view->layerCache->render(view, this->view->page, popplerPage,
+                                                         this->view->xournal->getCache(), crBuffer, zoom);
+        if (!composited) {
+            bool backgroundVisible = this->view->page->isLayerVisible(0);
+            if (backgroundVisible) {
+                PdfView::drawPage(this->view->xournal->getCache(), popplerPage, cr2, zoom, width, height);
+            }
+            view.drawPage(this->view->page, cr2, false);
         }
-        view.drawPage(this->view->page, cr2, false);
 
         cairo_destroy(cr2);
 
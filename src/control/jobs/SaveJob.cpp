@@ -83,6 +83,7 @@ auto SaveJob::save() -> bool {
     Document* doc = this->control->getDocument();
 
     SaveHandler h;
+    h.setCompressionLevel(Settings::getCompressionLevel(control->getSettings()->getSaveStorageProfile()));
 
     doc->lock();
     h.prepareSave(doc);
@@ -92,11 +93,12 @@ auto SaveJob::save() -> bool {
     doc->unlock();
 
     if (doc->shouldCreateBackupOnSave()) {
-        Path backup = filename;
-        backup += "~";
-
-        if (!PathUtil::copy(doc->getFilename(), backup)) {
-            g_warning(_("Could not create backup! (The file was created from an older Xournal version)"));
+        // The original file is only replaced if it has the same name, and then
+        // it's renamed to the backup instead of copied
+        if (doc->getFilename() == filename) {
+            Path backup = filename;
+            backup += "~";
+            h.setBackupFilename(backup);
         }
 
         doc->setCreateBackupOnSave(false);
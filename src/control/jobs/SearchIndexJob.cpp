@@ -0,0 +1,25 @@
+#include "SearchIndexJob.h"
+
+#include "control/SearchIndex.h"
+
+SearchIndexJob::SearchIndexJob(SearchIndex* index, size_t pdfPage, int generation):
+        index(index), pdfPage(pdfPage), generation(generation) {}
+
+SearchIndexJob::~SearchIndexJob() { this->index = nullptr; }
+
+auto SearchIndexJob::getSource() -> void* { return this->index; }
+
+auto SearchIndexJob::getType() -> JobType { return JOB_TYPE_SEARCH_INDEX; }
+
+void SearchIndexJob::run() {
+    if (!this->index->indexPdfPage(this->pdfPage, this->generation)) {
+        // Outdated
+        return;
+    }
+
+    if (!this->index->scheduleIndexJob(this->pdfPage + 1, this->generation)) {
+        callAfterRun();
+    }
+}
+
+void SearchIndexJob::afterRun() { this->index->indexFinished(this->generation); }
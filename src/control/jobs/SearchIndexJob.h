@@ -0,0 +1,49 @@
+/*
+ * Xournal++
+ *
+ * A job which adds the text of one PDF page to the search index
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Job.h"
+#include "XournalType.h"
+
+class SearchIndex;
+
+/**
+ * @brief Indexes one PDF page and schedules the next one, so the index is built without blocking the scheduler
+ */
+class SearchIndexJob: public Job {
+public:
+    SearchIndexJob(SearchIndex* index, size_t pdfPage, int generation);
+
+protected:
+    virtual ~SearchIndexJob();
+
+public:
+    virtual void* getSource();
+
+    virtual void run();
+
+    virtual void afterRun();
+
+    virtual JobType getType();
+
+private:
+    SearchIndex* index = nullptr;
+    size_t pdfPage = 0;
+
+    /**
+     * The index generation this job belongs to, if the index was rebuilt in the meantime the job does nothing
+     */
+    int generation = 0;
+};
@@ -0,0 +1,136 @@
+#include "SearchJob.h"
+
+#include <utility>
+
+#include "control/Control.h"
+#include "control/SearchIndex.h"
+#include "gui/SearchBar.h"
+#include "model/Document.h"
+
+#include "Util.h"
+
+/**
+ * Time in µs after which the job gives the scheduler the chance to run other jobs
+ */
+constexpr gint64 SEARCH_SLICE_TIME = 20000;
+
+SearchJob::SearchJob(Control* control, SearchBar* searchBar, string text, size_t startPage, SearchOrder order,
+                     bool stopAtFirst):
+        control(control),
+        searchBar(searchBar),
+        text(std::move(text)),
+        startPage(startPage),
+        order(order),
+        stopAtFirst(stopAtFirst) {}
+
+SearchJob::~SearchJob() {
+    this->control = nullptr;
+    this->searchBar = nullptr;
+}
+
+auto SearchJob::getSource() -> void* { return this->searchBar; }
+
+auto SearchJob::getType() -> JobType { return JOB_TYPE_SEARCH; }
+
+void SearchJob::cancel() { this->cancelled = true; }
+
+auto SearchJob::getText() -> const string& { return this->text; }
+
+auto SearchJob::hasResults() -> bool { return this->found; }
+
+auto SearchJob::searchCount(size_t pageCount) -> size_t {
+    if (this->order == SEARCH_ORDER_OUTWARD) {
+        // Every second position is outside of the document if the start page is near the start or the end
+        return 2 * pageCount;
+    }
+
+    // The start page itself is not searched again
+    return pageCount > 0 ? pageCount - 1 : 0;
+}
+
+auto SearchJob::pageAt(size_t n, size_t pageCount) -> size_t {
+    switch (this->order) {
+        case SEARCH_ORDER_FORWARD:
+            return (this->startPage + 1 + n) % pageCount;
+        case SEARCH_ORDER_BACKWARD:
+            return (this->startPage + pageCount - 1 - n) % pageCount;
+        case SEARCH_ORDER_OUTWARD:
+        default:
+            break;
+    }
+
+    size_t distance = (n + 1) / 2;
+    if (n % 2 == 1) {
+        size_t page = this->startPage + distance;
+        return page < pageCount ? page : npos;
+    }
+
+    if (distance > this->startPage) {
+        return npos;
+    }
+    size_t page = this->startPage - distance;
+    return page < pageCount ? page : npos;
+}
+
+void SearchJob::reportResult(size_t page, size_t count) {
+    this->ref();
+    Util::execInUiThread([this, page, count]() {
+        // Cancelling happens in the UI thread, too, so nothing is reported after cancel() returned
+        if (!this->cancelled) {
+            this->searchBar->searchResultFound(this, page, count);
+        }
+        this->unref();
+    });
+}
+
+void SearchJob::run() {
+    Document* doc = this->control->getDocument();
+    SearchIndex* index = this->control->getSearchIndex();
+    gint64 sliceEnd = g_get_monotonic_time() + SEARCH_SLICE_TIME;
+
+    while (!this->cancelled) {
+        doc->lock();
+        size_t pageCount = doc->getPageCount();
+        size_t n = this->position;
+        PageRef page = nullptr;
+        size_t pageNr = npos;
+        if (n < searchCount(pageCount)) {
+            pageNr = pageAt(n, pageCount);
+            if (pageNr != npos) {
+                page = doc->getPage(pageNr);
+            }
+        }
+        doc->unlock();
+
+        if (n >= searchCount(pageCount)) {
+            callAfterRun();
+            return;
+        }
+        this->position++;
+
+        if (page) {
+            size_t count = index->countOnPage(page, this->text);
+            if (count > 0) {
+                this->found = true;
+                reportResult(pageNr, count);
+
+                if (this->stopAtFirst) {
+                    callAfterRun();
+                    return;
+                }
+            }
+        }
+
+        if (g_get_monotonic_time() > sliceEnd) {
+            // Continue later, the scheduler may have more urgent jobs
+            this->control->getScheduler()->addSearch(this);
+            return;
+        }
+    }
+}
+
+void SearchJob::afterRun() {
+    if (!this->cancelled) {
+        this->searchBar->searchFinished(this);
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Xournal++
+ *
+ * A job which searches text in the document pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Job.h"
+#include "XournalType.h"
+
+class Control;
+class SearchBar;
+
+enum SearchOrder {
+    /**
+     * The start page first, then the pages next to it, alternating after and before
+     */
+    SEARCH_ORDER_OUTWARD,
+
+    /**
+     * The pages after the start page, wrapping around at the end of the document
+     */
+    SEARCH_ORDER_FORWARD,
+
+    /**
+     * The pages before the start page, wrapping around at the start of the document
+     */
+    SEARCH_ORDER_BACKWARD
+};
+
+/**
+ * @brief Searches the pages in the given order and reports every page with results to the SearchBar
+ *
+ * The pages are processed in slices, after each slice the job adds itself again to the scheduler, so
+ * rendering is not blocked by long searches. The job can be cancelled from the UI thread at any time,
+ * no results are reported after it was cancelled.
+ */
+class SearchJob: public Job {
+public:
+    SearchJob(Control* control, SearchBar* searchBar, string text, size_t startPage, SearchOrder order,
+              bool stopAtFirst);
+
+protected:
+    virtual ~SearchJob();
+
+public:
+    virtual void* getSource();
+
+    virtual void run();
+
+    virtual void afterRun();
+
+    virtual JobType getType();
+
+public:
+    /**
+     * Stop searching and drop all results which are not yet reported, call from the UI thread
+     */
+    void cancel();
+
+    const string& getText();
+
+    /**
+     * @return true if any result was found
+     */
+    bool hasResults();
+
+private:
+    /**
+     * @return the page to search at position n of the search order
+     */
+    size_t pageAt(size_t n, size_t pageCount);
+
+    /**
+     * @return the number of pages to search, depending on the order
+     */
+    size_t searchCount(size_t pageCount);
+
+    void reportResult(size_t page, size_t count);
+
+private:
+    Control* control = nullptr;
+    SearchBar* searchBar = nullptr;
+
+    string text;
+    size_t startPage = 0;
+    SearchOrder order = SEARCH_ORDER_OUTWARD;
+    bool stopAtFirst = false;
+
+    /**
+     * Position in the search order of the next page to search
+     */
+    size_t position = 0;
+
+    bool found = false;
+
+    std::atomic<bool> cancelled{false};
+};
@@ -13,6 +13,7 @@ XournalScheduler::~XournalScheduler() = default;
 
 void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
     removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH);
+    removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_LOW);
 }
 
 void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
@@ -87,13 +88,14 @@ auto XournalScheduler::existsSource(void* source, JobType type, JobPriority prio
     return exists;
 }
 
-void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview) {
-    if (existsSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH)) {
+void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview, JobPriority priority, bool storeInCache) {
+    if (existsSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH) ||
+        existsSource(preview, JOB_TYPE_PREVIEW, priority)) {
         return;
     }
 
-    auto* job = new PreviewJob(preview);
-    addJob(job, JOB_PRIORITY_HIGH);
+    auto* job = new PreviewJob(preview, storeInCache);
+    addJob(job, priority);
     job->unref();
 }
 
@@ -106,3 +108,5 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::addSearch(SearchJob* job) { addJob(job, JOB_PRIORITY_HIGH); }
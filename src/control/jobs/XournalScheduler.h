@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "control/jobs/Scheduler.h"
+#include "control/jobs/SearchJob.h"
 #include "gui/PageView.h"
 #include "gui/sidebar/previews/page/SidebarPreviewPageEntry.h"
 
@@ -39,9 +40,19 @@ public:
      */
     void removeAllJobs();
 
-    void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
+    /**
+     * @param priority JOB_PRIORITY_LOW if the preview only needs to be updated in the background
+     * @param storeInCache If a rendered page preview is written to the PreviewCache
+     */
+    void addRepaintSidebar(SidebarPreviewBaseEntry* preview, JobPriority priority = JOB_PRIORITY_HIGH,
+                           bool storeInCache = false);
     void addRerenderPage(XojPageView* view);
 
+    /**
+     * Add a text search, the job is cancelled with SearchJob::cancel()
+     */
+    void addSearch(SearchJob* job);
+
     /**
      * Blocks until all currently running Job%s have been executed
      */
@@ -12,22 +12,11 @@
 #pragma once
 
 #include <string>
-#include <vector>
 
-#include "XournalType.h"
-
-class MetadataEntry {
-public:
-    MetadataEntry();
+#include <glib.h>
 
-public:
-    string metadataFile;
-    bool valid;
-    string path;
-    double zoom;
-    int page;
-    gint64 time;
-};
+#include "MetadataStore.h"
+#include "XournalType.h"
 
 class MetadataManager {
 public:
@@ -52,26 +41,9 @@ public:
 
 private:
     /**
-     * Delete an old metadata file
-     */
-    static void deleteMetadataFile(const string& path);
-
-    /**
-     * Parse a single metadata file
+     * The store shared by all windows
      */
-    static MetadataEntry loadMetadataFile(const string& path, const string& file);
-
-    /**
-     * Store metadata to file
-     */
-    static void storeMetadata(MetadataEntry* m);
-
-private:
-    /**
-     * Load the metadata list (sorted)
-     */
-    static vector<MetadataEntry> loadList();
-
+    static MetadataStore& getStore();
 
 private:
     GMutex mutex{};
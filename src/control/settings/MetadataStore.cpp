@@ -0,0 +1,311 @@
+#include "MetadataStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include <glib/gstdio.h>
+
+constexpr const char* LOG_HEADER = "XOJ-METADATA-LOG/1.0";
+constexpr const char* LEGACY_HEADER = "XOJ-METADATA/1.0";
+constexpr const char* LEGACY_EXTENSION = ".metadata";
+
+MetadataEntry::MetadataEntry(): valid(false), zoom(1), page(0), time(0) {}
+
+MetadataStore::MetadataStore(Path logFile, Path legacyFolder):
+        logFile(std::move(logFile)), legacyFolder(std::move(legacyFolder)) {
+    g_mutex_init(&this->mutex);
+}
+
+MetadataStore::~MetadataStore() { g_mutex_clear(&this->mutex); }
+
+auto MetadataStore::get(const string& path) -> MetadataEntry {
+    g_mutex_lock(&this->mutex);
+    load();
+    readLog();
+
+    MetadataEntry entry;
+    auto it = this->entries.find(path);
+    if (it != this->entries.end()) {
+        entry = it->second;
+    }
+    g_mutex_unlock(&this->mutex);
+
+    return entry;
+}
+
+void MetadataStore::put(const MetadataEntry& entry) {
+    g_mutex_lock(&this->mutex);
+    load();
+    // Read the records of other instances first, so the own record directly follows the part which was read
+    readLog();
+    addEntry(entry);
+
+    std::ofstream out(this->logFile.c_str(), std::ios::app | std::ios::ate | std::ios::binary);
+    bool created = out && out.tellp() == 0;
+
+    string data;
+    if (created) {
+        this->header = createHeader();
+        data = this->header + "\n";
+    }
+    data += formatRecord(entry);
+    data += "\n";
+
+    out << data;
+    out.flush();
+    auto end = static_cast<size_t>(out.tellp());
+    out.close();
+
+    if (!out) {
+        g_warning("Could not write metadata file %s", this->logFile.c_str());
+    } else if (created) {
+        this->offset = data.length();
+        this->records = 1;
+        this->validHeader = true;
+    } else if (end == this->offset + data.length()) {
+        this->offset = end;
+        this->records++;
+    }
+    // else another instance appended in the meantime, the own record is read again with theirs
+
+    g_mutex_unlock(&this->mutex);
+}
+
+auto MetadataStore::getCount() -> size_t {
+    g_mutex_lock(&this->mutex);
+    load();
+    size_t count = this->entries.size();
+    g_mutex_unlock(&this->mutex);
+    return count;
+}
+
+void MetadataStore::load() {
+    if (this->loaded) {
+        return;
+    }
+    this->loaded = true;
+
+    readLog();
+
+    bool migrated = g_file_test(this->legacyFolder.c_str(), G_FILE_TEST_IS_DIR);
+    if (migrated) {
+        migrateLegacyFolder();
+    }
+
+    if (migrated || (this->offset > 0 && !this->validHeader) || this->entries.size() > MAX_ENTRIES ||
+        this->records > 2 * this->entries.size() + 1000) {
+        compact();
+    }
+}
+
+void MetadataStore::readLog() {
+    std::ifstream in(this->logFile.c_str(), std::ios::binary);
+    if (!in) {
+        return;
+    }
+
+    in.seekg(0, std::ios::end);
+    auto size = static_cast<size_t>(in.tellg());
+    in.seekg(0);
+
+    string line;
+    if (!std::getline(in, line) || in.eof()) {
+        // Empty, or the header is not completely written yet
+        return;
+    }
+
+    // Each compaction writes a new header, so a log rewritten by another instance is detected even if it did not
+    // shrink. The entries in memory are still valid, the new log is read from the beginning.
+    if (this->offset > 0 && (line != this->header || size < this->offset)) {
+        this->offset = 0;
+        this->records = 0;
+    }
+
+    if (this->offset == 0) {
+        this->header = line;
+        this->validHeader = isHeader(line);
+        this->offset = line.length() + 1;
+    }
+    in.seekg(this->offset);
+
+    while (std::getline(in, line)) {
+        if (in.eof()) {
+            // Not completely written yet
+            break;
+        }
+
+        MetadataEntry entry;
+        if (parseRecord(line, entry)) {
+            addEntry(entry);
+        }
+        this->records++;
+        this->offset += line.length() + 1;
+    }
+}
+
+void MetadataStore::addEntry(const MetadataEntry& entry) {
+    MetadataEntry& e = this->entries[entry.path];
+    // Instances may append in any order
+    if (!e.valid || e.time <= entry.time) {
+        e = entry;
+    }
+}
+
+void MetadataStore::compact() {
+    if (this->entries.size() > MAX_ENTRIES) {
+        std::vector<std::pair<gint64, string>> byAge;
+        byAge.reserve(this->entries.size());
+        for (auto& e: this->entries) {
+            byAge.emplace_back(e.second.time, e.first);
+        }
+        std::sort(byAge.begin(), byAge.end());
+
+        for (size_t i = 0; i < byAge.size() - MAX_ENTRIES; i++) {
+            this->entries.erase(byAge[i].second);
+        }
+    }
+
+    string newHeader = createHeader();
+    string contents = newHeader;
+    contents += "\n";
+    for (auto& e: this->entries) {
+        contents += formatRecord(e.second);
+        contents += "\n";
+    }
+
+    GError* err = nullptr;
+    if (!g_file_set_contents(this->logFile.c_str(), contents.c_str(), contents.length(), &err)) {
+        g_warning("Could not write metadata file %s: %s", this->logFile.c_str(), err->message);
+        g_error_free(err);
+        return;
+    }
+
+    this->header = newHeader;
+    this->offset = contents.length();
+    this->records = this->entries.size();
+    this->validHeader = true;
+}
+
+void MetadataStore::migrateLegacyFolder() {
+    GDir* dir = g_dir_open(this->legacyFolder.c_str(), 0, nullptr);
+    if (dir == nullptr) {
+        return;
+    }
+
+    const gchar* file = nullptr;
+    while ((file = g_dir_read_name(dir)) != nullptr) {
+        if (!g_str_has_suffix(file, LEGACY_EXTENSION)) {
+            continue;
+        }
+
+        string path = (this->legacyFolder / file).str();
+        MetadataEntry entry = loadLegacyFile(path, file);
+        if (entry.valid) {
+            addEntry(entry);
+        }
+
+        // be careful, delete the Metadata file, NOT the Document!
+        if (g_unlink(path.c_str()) != 0) {
+            g_warning("Could not delete metadata file %s", path.c_str());
+        }
+    }
+    g_dir_close(dir);
+
+    g_rmdir(this->legacyFolder.c_str());
+}
+
+/**
+ * Parse a single metadata file of older versions
+ */
+auto MetadataStore::loadLegacyFile(const string& path, const string& file) -> MetadataEntry {
+    MetadataEntry entry;
+
+    string line;
+    std::ifstream infile(path.c_str());
+
+    string time = file.substr(0, file.size() - strlen(LEGACY_EXTENSION));
+    entry.time = strtoll(time.c_str(), nullptr, 10);
+
+    if (!getline(infile, line) || line != LEGACY_HEADER) {
+        return entry;
+    }
+
+    if (!getline(infile, line)) {
+        return entry;
+    }
+    entry.path = line;
+
+    if (!getline(infile, line) || line.length() < 6 || line.substr(0, 5) != "page=") {
+        return entry;
+    }
+    entry.page = strtoll(line.substr(5).c_str(), nullptr, 10);
+
+    if (!getline(infile, line) || line.length() < 6 || line.substr(0, 5) != "zoom=") {
+        return entry;
+    }
+    entry.zoom = g_ascii_strtod(line.substr(5).c_str(), nullptr);
+
+    entry.valid = true;
+    return entry;
+}
+
+/**
+ * The header is "XOJ-METADATA-LOG/1.0 generation", the generation is unique for each write of a new log
+ */
+auto MetadataStore::createHeader() -> string {
+    string header = LOG_HEADER;
+    header += " ";
+    header += std::to_string(g_get_real_time());
+    header += "-";
+    header += std::to_string(g_random_int());
+    return header;
+}
+
+auto MetadataStore::isHeader(const string& line) -> bool {
+    size_t length = strlen(LOG_HEADER);
+    return line.compare(0, length, LOG_HEADER) == 0 && (line.length() == length || line[length] == ' ');
+}
+
+/**
+ * A record is "time page zoom path", the path is escaped so it does not contain a newline
+ */
+auto MetadataStore::parseRecord(const string& line, MetadataEntry& entry) -> bool {
+    gchar** parts = g_strsplit(line.c_str(), " ", 4);
+    if (g_strv_length(parts) != 4) {
+        g_strfreev(parts);
+        return false;
+    }
+
+    entry.time = g_ascii_strtoll(parts[0], nullptr, 10);
+    entry.page = g_ascii_strtoll(parts[1], nullptr, 10);
+    entry.zoom = g_ascii_strtod(parts[2], nullptr);
+
+    gchar* path = g_strcompress(parts[3]);
+    entry.path = path;
+    g_free(path);
+    g_strfreev(parts);
+
+    entry.valid = !entry.path.empty();
+    return entry.valid;
+}
+
+auto MetadataStore::formatRecord(const MetadataEntry& entry) -> string {
+    gchar zoom[G_ASCII_DTOSTR_BUF_SIZE];
+    g_ascii_dtostr(zoom, sizeof(zoom), entry.zoom);
+
+    gchar* path = g_strescape(entry.path.c_str(), nullptr);
+
+    string record = std::to_string(entry.time);
+    record += " ";
+    record += std::to_string(entry.page);
+    record += " ";
+    record += zoom;
+    record += " ";
+    record += path;
+    g_free(path);
+
+    return record;
+}
@@ -0,0 +1,115 @@
+/*
+ * Xournal++
+ *
+ * Storage of the last page and zoom of opened files
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include <glib.h>
+
+#include "Path.h"
+#include "XournalType.h"
+
+class MetadataEntry {
+public:
+    MetadataEntry();
+
+public:
+    bool valid;
+    string path;
+    double zoom;
+    int page;
+    gint64 time;
+};
+
+/**
+ * All entries are kept in one log file, new entries are appended and the newest entry of a path wins. The log is read
+ * once into a hash map, and compacted when it is read and contains many outdated entries.
+ *
+ * Other instances of the application append to the same log, their entries are read before each lookup. A log
+ * compacted by another instance is recognized by its new header and read again.
+ *
+ * The metadata folder with one file per entry of older versions is migrated on first use.
+ */
+class MetadataStore {
+public:
+    MetadataStore(Path logFile, Path legacyFolder);
+    virtual ~MetadataStore();
+
+private:
+    MetadataStore(const MetadataStore& store) = delete;
+    void operator=(const MetadataStore& store) = delete;
+
+public:
+    /**
+     * @return The entry of the file, not valid if there is none
+     */
+    MetadataEntry get(const string& path);
+
+    void put(const MetadataEntry& entry);
+
+    size_t getCount();
+
+private:
+    void load();
+
+    /**
+     * Read the entries appended since the last call
+     */
+    void readLog();
+
+    void addEntry(const MetadataEntry& entry);
+
+    /**
+     * Rewrite the log with the current entries, without the oldest ones if there are more than MAX_ENTRIES
+     */
+    void compact();
+
+    /**
+     * Read and delete the metadata files of older versions
+     */
+    void migrateLegacyFolder();
+
+    static string createHeader();
+    static bool isHeader(const string& line);
+    static MetadataEntry loadLegacyFile(const string& path, const string& file);
+    static bool parseRecord(const string& line, MetadataEntry& entry);
+    static string formatRecord(const MetadataEntry& entry);
+
+public:
+    static constexpr size_t MAX_ENTRIES = 10000;
+
+private:
+    GMutex mutex{};
+
+    Path logFile;
+    Path legacyFolder;
+
+    std::unordered_map<string, MetadataEntry> entries;
+    bool loaded = false;
+
+    /**
+     * The header of the log which was read, it changes when the log is rewritten
+     */
+    string header;
+
+    /**
+     * The part of the log which was read
+     */
+    size_t offset = 0;
+
+    /**
+     * The number of records in the log, including outdated ones
+     */
+    size_t records = 0;
+    bool validHeader = false;
+};
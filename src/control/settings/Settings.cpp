@@ -3,6 +3,7 @@
 #include <utility>
 
 #include <config.h>
+#include <zlib.h>
 
 #include "model/FormatDefinitions.h"
 #include "util/DeviceListHelper.h"
@@ -23,6 +24,32 @@
 
 const char* BUTTON_NAMES[] = {"middle", "right", "eraser", "touch", "default", "stylus", "stylus2"};
 
+static auto storageProfileToString(StorageProfile profile) -> const char* {
+    switch (profile) {
+        case STORAGE_PROFILE_STORE:
+            return "store";
+        case STORAGE_PROFILE_FAST:
+            return "fast";
+        case STORAGE_PROFILE_COMPACT:
+            return "compact";
+        default:
+            return "default";
+    }
+}
+
+static auto storageProfileFromString(const xmlChar* value) -> StorageProfile {
+    if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("store")) == 0) {
+        return STORAGE_PROFILE_STORE;
+    }
+    if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("fast")) == 0) {
+        return STORAGE_PROFILE_FAST;
+    }
+    if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("compact")) == 0) {
+        return STORAGE_PROFILE_COMPACT;
+    }
+    return STORAGE_PROFILE_DEFAULT;
+}
+
 Settings::Settings(Path filename): filename(std::move(filename)) { loadDefault(); }
 
 Settings::~Settings() {
@@ -80,6 +107,9 @@ void Settings::loadDefault() {
     this->autosaveTimeout = 3;
     this->autosaveEnabled = true;
 
+    this->saveStorageProfile = STORAGE_PROFILE_COMPACT;
+    this->autosaveStorageProfile = STORAGE_PROFILE_FAST;
+
     this->addHorizontalSpace = false;
     this->addHorizontalSpaceAmount = 150;
     this->addVerticalSpace = false;
@@ -141,6 +171,8 @@ void Settings::loadDefault() {
     this->inputSystemTPCButton = false;
     this->inputSystemDrawOutsideWindow = true;
 
+    this->latexPrecompiledPreamble = false;
+
     this->strokeFilterIgnoreTime = 150;
     this->strokeFilterIgnoreLength = 1;
     this->strokeFilterSuccessiveTime = 500;
@@ -350,6 +382,10 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->autosaveEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autosaveTimeout")) == 0) {
         this->autosaveTimeout = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveStorageProfile")) == 0) {
+        this->saveStorageProfile = storageProfileFromString(value);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autosaveStorageProfile")) == 0) {
+        this->autosaveStorageProfile = storageProfileFromString(value);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("fullscreenHideElements")) == 0) {
         this->fullscreenHideElements = reinterpret_cast<const char*>(value);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("presentationHideElements")) == 0) {
@@ -414,6 +450,8 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->inputSystemTPCButton = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("inputSystemDrawOutsideWindow")) == 0) {
         this->inputSystemDrawOutsideWindow = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexPrecompiledPreamble")) == 0) {
+        this->latexPrecompiledPreamble = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeFilterIgnoreTime")) == 0) {
         this->strokeFilterIgnoreTime = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeFilterIgnoreLength")) == 0) {
@@ -730,6 +768,10 @@ void Settings::save() {
     WRITE_BOOL_PROP(autosaveEnabled);
     WRITE_INT_PROP(autosaveTimeout);
 
+    xmlNode = saveProperty("saveStorageProfile", storageProfileToString(this->saveStorageProfile), root);
+    WRITE_COMMENT("Compression of saved files, allowed values: \"store\", \"fast\", \"default\", \"compact\"");
+    xmlNode = saveProperty("autosaveStorageProfile", storageProfileToString(this->autosaveStorageProfile), root);
+
     WRITE_BOOL_PROP(addHorizontalSpace);
     WRITE_INT_PROP(addHorizontalSpaceAmount);
     WRITE_BOOL_PROP(addVerticalSpace);
@@ -780,6 +822,8 @@ void Settings::save() {
     WRITE_BOOL_PROP(inputSystemTPCButton);
     WRITE_BOOL_PROP(inputSystemDrawOutsideWindow);
 
+    WRITE_BOOL_PROP(latexPrecompiledPreamble);
+
     xmlNodePtr xmlFont = nullptr;
     xmlFont = xmlNewChild(root, nullptr, reinterpret_cast<const xmlChar*>("property"), nullptr);
     xmlSetProp(xmlFont, reinterpret_cast<const xmlChar*>("name"), reinterpret_cast<const xmlChar*>("font"));
@@ -930,6 +974,43 @@ void Settings::setAutosaveEnabled(bool autosave) {
     save();
 }
 
+auto Settings::getSaveStorageProfile() const -> StorageProfile { return this->saveStorageProfile; }
+
+void Settings::setSaveStorageProfile(StorageProfile profile) {
+    if (this->saveStorageProfile == profile) {
+        return;
+    }
+
+    this->saveStorageProfile = profile;
+
+    save();
+}
+
+auto Settings::getAutosaveStorageProfile() const -> StorageProfile { return this->autosaveStorageProfile; }
+
+void Settings::setAutosaveStorageProfile(StorageProfile profile) {
+    if (this->autosaveStorageProfile == profile) {
+        return;
+    }
+
+    this->autosaveStorageProfile = profile;
+
+    save();
+}
+
+auto Settings::getCompressionLevel(StorageProfile profile) -> int {
+    switch (profile) {
+        case STORAGE_PROFILE_STORE:
+            return Z_NO_COMPRESSION;
+        case STORAGE_PROFILE_FAST:
+            return Z_BEST_SPEED;
+        case STORAGE_PROFILE_COMPACT:
+            return Z_BEST_COMPRESSION;
+        default:
+            return Z_DEFAULT_COMPRESSION;
+    }
+}
+
 auto Settings::getAddVerticalSpace() const -> bool { return this->addVerticalSpace; }
 
 void Settings::setAddVerticalSpace(bool space) { this->addVerticalSpace = space; }
@@ -1577,6 +1658,16 @@ void Settings::setInputSystemDrawOutsideWindowEnabled(bool drawOutsideWindowEnab
 
 auto Settings::getInputSystemDrawOutsideWindowEnabled() const -> bool { return this->inputSystemDrawOutsideWindow; }
 
+void Settings::setLatexPrecompiledPreamble(bool precompiledPreamble) {
+    if (this->latexPrecompiledPreamble == precompiledPreamble) {
+        return;
+    }
+    this->latexPrecompiledPreamble = precompiledPreamble;
+    save();
+}
+
+auto Settings::getLatexPrecompiledPreamble() const -> bool { return this->latexPrecompiledPreamble; }
+
 void Settings::setDeviceClassForDevice(GdkDevice* device, int deviceClass) {
     this->setDeviceClassForDevice(gdk_device_get_name(device), gdk_device_get_source(device), deviceClass);
 }
@@ -39,6 +39,31 @@ enum ScrollbarHideType {
     SCROLLBAR_HIDE_BOTH = SCROLLBAR_HIDE_HORIZONTAL | SCROLLBAR_HIDE_VERTICAL
 };
 
+/**
+ * How documents are compressed when they are written
+ */
+enum StorageProfile {
+    /**
+     * No compression at all, the zip entries are only stored
+     */
+    STORAGE_PROFILE_STORE = 0,
+
+    /**
+     * Fastest compression (zlib level 1)
+     */
+    STORAGE_PROFILE_FAST,
+
+    /**
+     * zlib default compression level
+     */
+    STORAGE_PROFILE_DEFAULT,
+
+    /**
+     * Smallest files (zlib level 9)
+     */
+    STORAGE_PROFILE_COMPACT
+};
+
 class ButtonConfig;
 class InputDevice;
 
@@ -260,6 +285,16 @@ public:
     bool isAutosaveEnabled() const;
     void setAutosaveEnabled(bool autosave);
 
+    StorageProfile getSaveStorageProfile() const;
+    void setSaveStorageProfile(StorageProfile profile);
+    StorageProfile getAutosaveStorageProfile() const;
+    void setAutosaveStorageProfile(StorageProfile profile);
+
+    /**
+     * @return The zlib compression level to use for the profile
+     */
+    static int getCompressionLevel(StorageProfile profile);
+
     bool getAddVerticalSpace() const;
     void setAddVerticalSpace(bool space);
     int getAddVerticalSpaceAmount() const;
@@ -367,6 +402,9 @@ public:
     bool getInputSystemDrawOutsideWindowEnabled() const;
     void setInputSystemDrawOutsideWindowEnabled(bool drawOutsideWindowEnabled);
 
+    bool getLatexPrecompiledPreamble() const;
+    void setLatexPrecompiledPreamble(bool precompiledPreamble);
+
     void loadDeviceClasses();
     void saveDeviceClasses();
     void setDeviceClassForDevice(GdkDevice* device, int deviceClass);
@@ -645,6 +683,16 @@ private:
      */
     bool autosaveEnabled{};
 
+    /**
+     * Compression used when the user saves the document
+     */
+    StorageProfile saveStorageProfile{};
+
+    /**
+     * Compression used for autosave, speed matters more than size here
+     */
+    StorageProfile autosaveStorageProfile{};
+
     /**
      * Allow scroll outside the page display area (horizontal)
      */
@@ -820,6 +868,11 @@ private:
 
     bool inputSystemDrawOutsideWindow{};
 
+    /**
+     * Whether the LaTeX preview uses a format file with the preamble, which is dumped once per session
+     */
+    bool latexPrecompiledPreamble{};
+
     std::map<string, std::pair<int, GdkInputSource>> inputDeviceClasses = {};
 
     /**
@@ -78,6 +78,24 @@ void Inertia::increase(Point p1, Point p2, int coef) {
     this->sxy += dm * p1.x * p1.y;
 }
 
+void Inertia::add(const Inertia& other, int coef) {
+    this->mass += coef * other.mass;
+    this->sx += coef * other.sx;
+    this->sy += coef * other.sy;
+    this->sxx += coef * other.sxx;
+    this->syy += coef * other.syy;
+    this->sxy += coef * other.sxy;
+}
+
+void Inertia::translate(double dx, double dy) {
+    // The second moments use the old first moments
+    this->sxx += 2 * dx * this->sx + this->mass * dx * dx;
+    this->syy += 2 * dy * this->sy + this->mass * dy * dy;
+    this->sxy += dx * this->sy + dy * this->sx + this->mass * dx * dy;
+    this->sx += this->mass * dx;
+    this->sy += this->mass * dy;
+}
+
 void Inertia::calc(const Point* pt, int start, int end) {
     this->mass = this->sx = this->sy = this->sxx = this->sxy = this->syy = 0.;
     for (int i = start; i < end - 1; i++) {
@@ -41,6 +41,16 @@ public:
     void increase(Point p1, Point p2, int coef);
     void calc(const Point* pt, int start, int end);
 
+    /**
+     * Add (coef = 1) or subtract (coef = -1) the sums of another inertia
+     */
+    void add(const Inertia& other, int coef);
+
+    /**
+     * Move the origin the sums are relative to by (-dx, -dy), i.e. the points by (dx, dy)
+     */
+    void translate(double dx, double dy);
+
 private:
     double mass{};
     double sx{};
@@ -0,0 +1,48 @@
+#include "InertiaSums.h"
+
+#include "model/Stroke.h"
+
+InertiaSums::InertiaSums() = default;
+
+InertiaSums::~InertiaSums() = default;
+
+void InertiaSums::addPoint(const Point& p) {
+    if (this->sums.empty()) {
+        this->origin = Point(p.x, p.y);
+        this->last = Point(0, 0);
+        this->sums.emplace_back();
+        return;
+    }
+
+    Point relative(p.x - this->origin.x, p.y - this->origin.y);
+    Inertia s = this->sums.back();
+    s.increase(this->last, relative, 1);
+    this->sums.push_back(s);
+    this->last = relative;
+}
+
+void InertiaSums::calc(Stroke* stroke) {
+    clear();
+
+    int count = stroke->getPointCount();
+    this->sums.reserve(count);
+    for (int i = 0; i < count; i++) {
+        addPoint(stroke->getPoint(i));
+    }
+}
+
+void InertiaSums::clear() { this->sums.clear(); }
+
+auto InertiaSums::getPointCount() const -> int { return this->sums.size(); }
+
+auto InertiaSums::get(int start, int end) const -> Inertia {
+    Inertia s;
+    if (end - 1 <= start) {
+        return s;
+    }
+
+    s = this->sums[end - 1];
+    s.add(this->sums[start], -1);
+    s.translate(this->origin.x, this->origin.y);
+    return s;
+}
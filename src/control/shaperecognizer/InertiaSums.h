@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * Part of the Xournal shape recognizer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "model/Point.h"
+
+#include "Inertia.h"
+#include "XournalType.h"
+
+class Stroke;
+
+/**
+ * Prefix sums of the inertia of a stroke, which are updated point by point while the stroke is drawn. The inertia of
+ * any part of the stroke is then computed in constant time.
+ *
+ * The sums are relative to the first point, so long strokes far from the origin don't lose precision.
+ */
+class InertiaSums {
+public:
+    InertiaSums();
+    virtual ~InertiaSums();
+
+public:
+    void addPoint(const Point& p);
+
+    /**
+     * Replace the sums with the points of the stroke
+     */
+    void calc(Stroke* stroke);
+
+    void clear();
+
+    int getPointCount() const;
+
+    /**
+     * @return The same inertia as Inertia::calc(pt, start, end)
+     */
+    Inertia get(int start, int end) const;
+
+private:
+    /**
+     * sums[i] is the inertia of the first i segments
+     */
+    vector<Inertia> sums;
+
+    Point origin;
+    Point last;
+};
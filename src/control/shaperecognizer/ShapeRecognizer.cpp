@@ -262,7 +262,7 @@ auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsi
     for (; k < nsides; k++) {
         i1 = start + (k * (end - start)) / nsides;
         i2 = start + ((k + 1) * (end - start)) / nsides;
-        s.calc(pt, i1, i2);
+        s = this->sums.get(i1, i2);
         if (s.det() < LINE_MAX_DET) {
             break;
         }
@@ -381,6 +381,29 @@ void ShapeRecognizer::optimizePolygonal(const Point* pt, int nsides, int* breaks
     }
 }
 
+void ShapeRecognizer::setDrawnStroke(Stroke* stroke) {
+    this->drawnStroke = stroke;
+    this->sums.clear();
+    if (stroke) {
+        this->sums.calc(stroke);
+    }
+}
+
+void ShapeRecognizer::addDrawnPoint(const Point& p) {
+    if (this->drawnStroke) {
+        this->sums.addPoint(p);
+    }
+}
+
+void ShapeRecognizer::calcInertiaSums(Stroke* stroke) {
+    if (this->drawnStroke == stroke && this->sums.getPointCount() == stroke->getPointCount()) {
+        return;
+    }
+
+    // Points were changed after drawing, or the stroke was not drawn
+    this->sums.calc(stroke);
+}
+
 /**
  * The main pattern recognition function
  */
@@ -394,10 +417,15 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> ShapeRecognizerResult
     Inertia ss[4];
     int brk[5] = {0};
 
+    vector<Point> points = stroke->getPointVector();
+    calcInertiaSums(stroke);
+    // The sums are only valid for this call
+    this->drawnStroke = nullptr;
+
     // first see if it's a polygon
-    int n = findPolygonal(stroke->getPoints(), 0, stroke->getPointCount() - 1, MAX_POLYGON_SIDES, brk, ss);
+    int n = findPolygonal(points.data(), 0, stroke->getPointCount() - 1, MAX_POLYGON_SIDES, brk, ss);
     if (n > 0) {
-        optimizePolygonal(stroke->getPoints(), n, brk, ss);
+        optimizePolygonal(points.data(), n, brk, ss);
 #ifdef DEBUG_RECOGNIZER
         g_message("--");
         g_message("ShapeReco:: Polygon, %d edges:", n);
@@ -425,7 +453,7 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> ShapeRecognizerResult
         for (int i = 0; i < n; i++) {
             rs[i].startpt = brk[i];
             rs[i].endpt = brk[i + 1];
-            rs[i].calcSegmentGeometry(stroke->getPoints(), brk[i], brk[i + 1], ss + i);
+            rs[i].calcSegmentGeometry(points.data(), brk[i], brk[i + 1], ss + i);
         }
 
         Stroke* tmp = nullptr;
@@ -490,7 +518,8 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> ShapeRecognizerResult
     }
 
     // not a polygon: maybe a circle ?
-    Stroke* s = CircleRecognizer::recognize(stroke);
+    Inertia inertia = this->sums.get(0, stroke->getPointCount());
+    Stroke* s = CircleRecognizer::recognize(stroke, inertia);
     if (s) {
         RDEBUG("return circle");
         return new ShapeRecognizerResult(s);
@@ -14,6 +14,7 @@
 #include <array>
 
 #include "CircleRecognizer.h"
+#include "InertiaSums.h"
 #include "RecoSegment.h"
 #include "ShapeRecognizerConfig.h"
 
@@ -29,6 +30,17 @@ public:
     ShapeRecognizerResult* recognizePatterns(Stroke* stroke);
     void resetRecognizer();
 
+    /**
+     * Start collecting the points of a stroke which is being drawn, so recognizePatterns() does not need to look at
+     * all points again. nullptr stops collecting.
+     */
+    void setDrawnStroke(Stroke* stroke);
+
+    /**
+     * Called for every point added to the drawn stroke
+     */
+    void addDrawnPoint(const Point& p);
+
 private:
     Stroke* tryRectangle();
     Stroke* tryArrow();
@@ -37,11 +49,22 @@ private:
 
     int findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss);
 
+    /**
+     * Prepare the inertia sums of the stroke, if they were not collected while drawing
+     */
+    void calcInertiaSums(Stroke* stroke);
+
 private:
     std::array<RecoSegment, MAX_POLYGON_SIDES + 1> queue{};
     int queueLength;
 
     Stroke* stroke;
 
+    /**
+     * The stroke the points of which are collected, and their inertia
+     */
+    Stroke* drawnStroke = nullptr;
+    InertiaSums sums;
+
     friend class ShapeRecognizerResult;
 };
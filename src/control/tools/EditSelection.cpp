@@ -40,12 +40,9 @@ EditSelection::EditSelection(UndoRedoHandler* undo, Selection* selection, XojPag
 
     contstruct(undo, view, view->getPage());
 
-    for (Element* e: selection->selectedElements) {
-        addElement(e, this->sourceLayer->indexOf(e));
-        this->sourceLayer->removeElement(e, false);
-    }
+    addElementsFromLayer(selection->selectedElements);
 
-    view->rerenderPage();
+    view->rerenderLayer(this->sourceLayer);
 }
 
 EditSelection::EditSelection(UndoRedoHandler* undo, Element* e, XojPageView* view, const PageRef& page) {
@@ -68,12 +65,9 @@ EditSelection::EditSelection(UndoRedoHandler* undo, const vector<Element*>& elem
 
     contstruct(undo, view, page);
 
-    for (Element* e: elements) {
-        addElement(e, this->sourceLayer->indexOf(e));
-        this->sourceLayer->removeElement(e, false);
-    }
+    addElementsFromLayer(elements);
 
-    view->rerenderPage();
+    view->rerenderLayer(this->sourceLayer);
 }
 
 void EditSelection::calcSizeFromElements(vector<Element*> elements) {
@@ -290,6 +284,13 @@ void EditSelection::addElement(Element* e, Layer::ElementIndex order) {
     }
 }
 
+void EditSelection::addElementsFromLayer(const vector<Element*>& elements) {
+    vector<Layer::ElementIndex> positions = this->sourceLayer->removeElements(elements, false);
+    for (size_t i = 0; i < elements.size(); i++) {
+        addElement(elements[i], positions[i]);
+    }
+}
+
 /**
  * Returns all containig elements of this selections
  */
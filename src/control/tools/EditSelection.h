@@ -241,6 +241,11 @@ private:
      */
     void finalizeSelection();
 
+    /**
+     * Move the elements from the source layer to this selection
+     */
+    void addElementsFromLayer(const vector<Element*>& elements);
+
     /**
      * Gets the PageView under the cursor
      */
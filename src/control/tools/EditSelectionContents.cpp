@@ -63,11 +63,7 @@ EditSelectionContents::~EditSelectionContents() {
 void EditSelectionContents::addElement(Element* e, Layer::ElementIndex order) {
     g_assert(this->selected.size() == this->insertOrder.size());
     this->selected.emplace_back(e);
-    if (order == Layer::InvalidElementIndex) {
-        this->insertOrder.emplace_back(e, order);
-    } else {
-        this->insertOrder.emplace_front(e, order);
-    }
+    this->insertOrder.emplace_back(e, order);
 }
 
 /**
@@ -335,6 +331,8 @@ void EditSelectionContents::finalizeSelection(double x, double y, double width,
     bool move = mx != 0 || my != 0;
 
     g_assert(this->selected.size() == this->insertOrder.size());
+    vector<std::pair<Element*, Layer::ElementIndex>> restored;
+    vector<Element*> added;
     for (auto&& [e, index]: this->insertOrder) {
         if (move) {
             e->move(mx, my);
@@ -347,11 +345,16 @@ void EditSelectionContents::finalizeSelection(double x, double y, double width,
         }
         if (index == Layer::InvalidElementIndex) {
             // if the element didn't have a source layer (e.g, clipboard)
-            layer->addElement(e);
+            added.push_back(e);
         } else {
-            layer->insertElement(e, index);
+            restored.emplace_back(e, index);
         }
     }
+
+    layer->insertElements(restored);
+    for (Element* e: added) {
+        layer->addElement(e);
+    }
 }
 
 auto EditSelectionContents::getOriginalX() const -> double { return this->originalX; }
@@ -501,7 +504,7 @@ auto EditSelectionContents::copySelection(PageRef page, XojPageView* view, doubl
         new_elems.push_back(ec);
     }
 
-    view->rerenderPage();
+    view->rerenderLayer(layer);
 
     return new InsertsUndoAction(page, layer, new_elems);
 }
@@ -11,7 +11,6 @@
 
 #pragma once
 
-#include <deque>
 #include <utility>
 #include <vector>
 
@@ -178,10 +177,10 @@ private:
     std::vector<Element*> selected;
 
     /**
-     * Mapping of elements in the selection to the indexes from the original selection layer.
-     * Defines a insert order over the selection.
+     * Mapping of elements in the selection to the indexes from the original selection layer,
+     * the indexes before the elements were removed from the layer.
      */
-    std::deque<std::pair<Element*, Layer::ElementIndex>> insertOrder;
+    std::vector<std::pair<Element*, Layer::ElementIndex>> insertOrder;
 
     /**
      * The rendered elements
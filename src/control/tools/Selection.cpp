@@ -67,6 +67,14 @@ auto RectSelection::contains(double x, double y) -> bool {
     return true;
 }
 
+auto RectSelection::containsRect(double x1, double y1, double x2, double y2) -> bool {
+    return x1 >= this->x1 && x2 <= this->x2 && y1 >= this->y1 && y2 <= this->y2;
+}
+
+auto RectSelection::intersectsRect(double x1, double y1, double x2, double y2) -> bool {
+    return x2 >= this->x1 && x1 <= this->x2 && y2 >= this->y1 && y1 <= this->y2;
+}
+
 void RectSelection::currentPos(double x, double y) {
     double aX = std::min(x, this->ex);
     aX = std::min(aX, this->sx) - 10;
@@ -265,6 +273,61 @@ auto RegionSelect::contains(double x, double y) -> bool {
     return (hits & 1) != 0;
 }
 
+auto RegionSelect::intersectsRect(double x1, double y1, double x2, double y2) -> bool {
+    return x2 >= this->x1Box && x1 <= this->x2Box && y2 >= this->y1Box && y1 <= this->y2Box;
+}
+
+auto RegionSelect::containsRect(double x1, double y1, double x2, double y2) -> bool {
+    if (this->points == nullptr || !contains(x1, y1)) {
+        return false;
+    }
+
+    // One corner is inside, so the whole rectangle is inside if the border of the region does not touch it
+    auto* last = static_cast<RegionPoint*>(g_list_last(this->points)->data);
+    for (GList* l = this->points; l != nullptr; l = l->next) {
+        auto* p = static_cast<RegionPoint*>(l->data);
+        if (segmentIntersectsRect(last->x, last->y, p->x, p->y, x1, y1, x2, y2)) {
+            return false;
+        }
+        last = p;
+    }
+
+    return true;
+}
+
+/**
+ * Liang-Barsky line clipping, the segment intersects if a part of it is left after clipping
+ */
+auto RegionSelect::segmentIntersectsRect(double ax, double ay, double bx, double by, double x1, double y1, double x2,
+                                         double y2) -> bool {
+    double t0 = 0;
+    double t1 = 1;
+    double dx = bx - ax;
+    double dy = by - ay;
+
+    auto clip = [&t0, &t1](double p, double q) {
+        if (p == 0) {
+            return q >= 0;
+        }
+
+        double r = q / p;
+        if (p < 0) {
+            if (r > t1) {
+                return false;
+            }
+            t0 = std::max(t0, r);
+        } else {
+            if (r < t0) {
+                return false;
+            }
+            t1 = std::min(t1, r);
+        }
+        return true;
+    };
+
+    return clip(-dx, ax - x1) && clip(dx, x2 - ax) && clip(-dy, ay - y1) && clip(dy, y2 - ay);
+}
+
 auto RegionSelect::finalize(PageRef page) -> bool {
     this->page = page;
 
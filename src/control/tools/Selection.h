@@ -55,6 +55,8 @@ public:
     virtual void paint(cairo_t* cr, GdkRectangle* rect, double zoom);
     virtual void currentPos(double x, double y);
     virtual bool contains(double x, double y);
+    virtual bool containsRect(double x1, double y1, double x2, double y2);
+    virtual bool intersectsRect(double x1, double y1, double x2, double y2);
 
 private:
     double sx;
@@ -81,6 +83,12 @@ public:
     virtual void paint(cairo_t* cr, GdkRectangle* rect, double zoom);
     virtual void currentPos(double x, double y);
     virtual bool contains(double x, double y);
+    virtual bool containsRect(double x1, double y1, double x2, double y2);
+    virtual bool intersectsRect(double x1, double y1, double x2, double y2);
+
+private:
+    static bool segmentIntersectsRect(double ax, double ay, double bx, double by, double x1, double y1, double x2,
+                                      double y2);
 
 private:
     GList* points;
@@ -7,6 +7,7 @@
 #include "control/Control.h"
 #include "control/layer/LayerController.h"
 #include "control/settings/Settings.h"
+#include "control/shaperecognizer/ShapeRecognizer.h"
 #include "control/shaperecognizer/ShapeRecognizerResult.h"
 #include "gui/PageView.h"
 #include "gui/XournalView.h"
@@ -73,6 +74,10 @@ auto StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos) -> bool {
 
     stroke->addPoint(currentPoint);
 
+    if (reco) {
+        reco->addDrawnPoint(currentPoint);
+    }
+
     if ((stroke->getFill() != -1 || stroke->getLineStyle().hasDashes()) &&
         !(stroke->getFill() != -1 && stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER)) {
         // Clear surface
@@ -155,8 +160,8 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos) {
     // Backward compatibility and also easier to handle for me;-)
     // I cannot draw a line with one point, to draw a visible line I need two points,
     // twice the same Point is also OK
-    if (auto const& pv = stroke->getPointVector(); pv.size() == 1) {
-        stroke->addPoint(pv.front());
+    if (stroke->getPointCount() == 1) {
+        stroke->addPoint(stroke->getPoint(0));
         // Todo: check if the following is the reason for a bug, that single points have no pressure:
         // No pressure sensitivity,
         stroke->clearPressure();
@@ -273,6 +278,15 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos) {
         this->buttonDownPoint.y = pos.y / zoom;
 
         createStroke(Point(this->buttonDownPoint.x, this->buttonDownPoint.y));
+
+        if (xournal->getControl()->getToolHandler()->getDrawingType() == DRAWING_TYPE_STROKE_RECOGNIZER) {
+            if (reco == nullptr) {
+                reco = new ShapeRecognizer();
+            }
+            reco->setDrawnStroke(stroke);
+        } else if (reco) {
+            reco->setDrawnStroke(nullptr);
+        }
     }
 
     this->startStrokeTime = pos.timestamp;
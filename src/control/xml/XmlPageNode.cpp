@@ -0,0 +1,27 @@
+#include "XmlPageNode.h"
+
+#include <utility>
+
+XmlPageNode::XmlPageNode(): XmlNode("page") {}
+
+XmlPageNode::~XmlPageNode() = default;
+
+void XmlPageNode::setEntryName(string entryName) { this->entryName = std::move(entryName); }
+
+auto XmlPageNode::getEntryName() -> const string& { return this->entryName; }
+
+void XmlPageNode::writeOut(OutputStream* out) {
+    if (this->entryName.empty()) {
+        writeContent(out);
+        return;
+    }
+
+    out->write("<");
+    out->write(tag);
+    writeAttributes(out);
+    out->write(" src=\"");
+    out->write(this->entryName);
+    out->write("\"/>\n");
+}
+
+void XmlPageNode::writeContent(OutputStream* out) { XmlNode::writeOut(out, nullptr); }
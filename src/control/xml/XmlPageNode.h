@@ -0,0 +1,41 @@
+/*
+ * Xournal++
+ *
+ * XML Writer helper class
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "XmlNode.h"
+
+/**
+ * A <page> node, which can be written to its own zip entry
+ */
+class XmlPageNode: public XmlNode {
+public:
+    XmlPageNode();
+    virtual ~XmlPageNode();
+
+public:
+    /**
+     * If an entry name is set, only a reference to the entry is written
+     * inline, the content has to be written with writeContent()
+     */
+    void setEntryName(string entryName);
+    const string& getEntryName();
+
+    virtual void writeOut(OutputStream* out);
+
+    /**
+     * Write the whole page, independent of the entry name
+     */
+    void writeContent(OutputStream* out);
+
+private:
+    string entryName;
+};
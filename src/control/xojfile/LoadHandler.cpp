@@ -115,10 +115,10 @@ auto LoadHandler::openFile(const string& filename) -> bool {
             this->lastError = FS(_F("The file is no valid .xopp file (Mimetype missing): \"{1}\"") % filename);
             return false;
         }
-        char mimetype[25];
+        char mimetype[25] = {};
         // read the mimetype and a few more bytes to make sure we do not only read a subset
-        zip_fread(mimetypeFp, mimetype, 25);
-        if (!strcmp(mimetype, "application/xournal++")) {
+        zip_fread(mimetypeFp, mimetype, sizeof(mimetype) - 1);
+        if (strstr(mimetype, "application/xournal++") == nullptr) {
             this->lastError = FS(_F("The file is no valid .xopp file (Mimetype wrong): \"{1}\"") % filename);
             return false;
         }
@@ -130,8 +130,8 @@ auto LoadHandler::openFile(const string& filename) -> bool {
             this->lastError = FS(_F("The file is no valid .xopp file (Version missing): \"{1}\"") % filename);
             return false;
         }
-        char versionString[50];
-        zip_fread(versionFp, versionString, 50);
+        char versionString[50] = {};
+        zip_fread(versionFp, versionString, sizeof(versionString) - 1);
         std::string versions(versionString);
         std::regex versionRegex("current=(\\d+?)(?:\n|\r\n)min=(\\d+?)");
         std::smatch match;
@@ -145,6 +145,14 @@ auto LoadHandler::openFile(const string& filename) -> bool {
         }
         zip_fclose(versionFp);
 
+        // Version 5 stores each page in its own entry
+        if (this->minimalFileVersion > 5) {
+            this->lastError = FS(_F("The file was created with a newer version of Xournal++ and cannot be read: "
+                                    "\"{1}\"") %
+                                 filename);
+            return false;
+        }
+
         // open the main content file
         this->zipContentFile = zip_fopen(this->zipFp, "content.xml", 0);
     }
@@ -183,9 +191,12 @@ auto LoadHandler::readContentFile(char* buffer, zip_uint64_t len) -> zip_int64_t
     return -1;
 }
 
+auto LoadHandler::getMarkupParser() -> GMarkupParser {
+    return {LoadHandler::parserStartElement, LoadHandler::parserEndElement, LoadHandler::parserText, nullptr, nullptr};
+}
+
 auto LoadHandler::parseXml() -> bool {
-    const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
-                                  LoadHandler::parserText, nullptr, nullptr};
+    const GMarkupParser parser = getMarkupParser();
     this->error = nullptr;
     gboolean valid = true;
 
@@ -281,12 +292,20 @@ void LoadHandler::parseStart() {
 
 void LoadHandler::parseContents() {
     if (strcmp(elementName, "page") == 0) {
+        const char* src = LoadHandlerHelper::getAttrib("src", true, this);
+        if (src) {
+            // The page is stored in its own zip entry
+            parsePageEntry(src);
+            return;
+        }
+
         this->pos = PARSER_POS_IN_PAGE;
 
         double width = LoadHandlerHelper::getAttribDouble("width", this);
         double height = LoadHandlerHelper::getAttribDouble("height", this);
 
         this->page = new XojPage(width, height);
+        this->arena.reset(new ElementArena());
 
         this->doc.addPage(this->page);
     } else if (strcmp(elementName, "audio") == 0) {
@@ -300,6 +319,49 @@ void LoadHandler::parseContents() {
     }
 }
 
+/**
+ * Parse a page stored in its own zip entry, the entry contains a single <page> element
+ */
+void LoadHandler::parsePageEntry(const string& entryName) {
+    if (this->isGzFile) {
+        error("%s", FC(_F("Page references are only allowed in .xopp containers: {1}") % entryName));
+        return;
+    }
+
+    gpointer data = nullptr;
+    gsize dataLength = 0;
+    if (!readZipAttachment(entryName, data, dataLength)) {
+        return;
+    }
+
+    // The nested parser overwrites the attributes of the referencing element
+    const gchar** refAttributeNames = this->attributeNames;
+    const gchar** refAttributeValues = this->attributeValues;
+    const gchar* refElementName = this->elementName;
+
+    const GMarkupParser parser = getMarkupParser();
+    GMarkupParseContext* context =
+            g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
+
+    GError* entryError = nullptr;
+    if (g_markup_parse_context_parse(context, static_cast<const gchar*>(data), dataLength, &entryError)) {
+        g_markup_parse_context_end_parse(context, &entryError);
+    }
+    g_markup_parse_context_free(context);
+    g_free(data);
+
+    if (entryError) {
+        error("%s", FC(_F("XML Parser error in {1}: {2}") % entryName % entryError->message));
+        g_error_free(entryError);
+    } else if (this->pos != PARSER_POS_STARTED) {
+        error("%s", FC(_F("Page entry is not complete: {1}") % entryName));
+    }
+
+    this->attributeNames = refAttributeNames;
+    this->attributeValues = refAttributeValues;
+    this->elementName = refElementName;
+}
+
 void LoadHandler::parseBgSolid() {
     PageType bg;
     const char* style = LoadHandlerHelper::getAttrib("style", false, this);
@@ -495,7 +557,7 @@ void LoadHandler::parsePage() {
 }
 
 void LoadHandler::parseStroke() {
-    this->stroke = new Stroke();
+    this->stroke = new (this->arena.get()) Stroke(this->arena.get());
     this->layer->addElement(this->stroke);
 
     const char* width = LoadHandlerHelper::getAttrib("width", false, this);
@@ -593,7 +655,7 @@ void LoadHandler::parseStroke() {
 }
 
 void LoadHandler::parseText() {
-    this->text = new Text();
+    this->text = new (this->arena.get()) Text();
     this->layer->addElement(this->text);
 
     const char* sFont = LoadHandlerHelper::getAttrib("font", false, this);
@@ -636,7 +698,7 @@ void LoadHandler::parseImage() {
     double right = LoadHandlerHelper::getAttribDouble("right", this);
     double bottom = LoadHandlerHelper::getAttribDouble("bottom", this);
 
-    this->image = new Image();
+    this->image = new (this->arena.get()) Image();
     this->layer->addElement(this->image);
     this->image->setX(left);
     this->image->setY(top);
@@ -657,7 +719,7 @@ void LoadHandler::parseTexImage() {
         imTextLen = LoadHandlerHelper::getAttribInt("texlength", this);
     }
 
-    this->teximage = new TexImage();
+    this->teximage = new (this->arena.get()) TexImage();
     this->layer->addElement(this->teximage);
     this->teximage->setX(left);
     this->teximage->setY(top);
@@ -836,6 +898,7 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
     } else if (handler->pos == PARSER_POS_IN_PAGE && strcmp(elementName, "page") == 0) {
         handler->pos = PARSER_POS_STARTED;
         handler->page = nullptr;
+        handler->arena.reset();
     } else if (handler->pos == PARSER_POS_IN_LAYER && strcmp(elementName, "layer") == 0) {
         handler->pos = PARSER_POS_IN_PAGE;
         handler->layer = nullptr;
@@ -887,10 +950,11 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
                 x = tmp;
             } else {
                 xRead = false;
-                handler->stroke->addPoint(Point(x, tmp));
+                handler->pointBuffer.emplace_back(x, tmp);
             }
         }
-        handler->stroke->freeUnusedPointItems();
+        handler->stroke->addPoints(handler->pointBuffer);
+        handler->pointBuffer.clear();
 
         if (n < 4 || (n & 1)) {
             error2(*error, "%s", FC(_F("Wrong count of points ({1})") % n));
@@ -965,7 +1029,11 @@ auto LoadHandler::loadDocument(const string& filename) -> Document* {
 
     this->pdfFilenameParsed = false;
 
-    if (!parseXml()) {
+    bool parsed = parseXml();
+    // Only set if the last page is not complete
+    this->arena.reset();
+
+    if (!parsed) {
         closeFile();
         return nullptr;
     }
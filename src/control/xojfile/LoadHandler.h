@@ -57,6 +57,7 @@ public:
 private:
     void parseStart();
     void parseContents();
+    void parsePageEntry(const string& entryName);
     void parsePage();
     void parseLayer();
     void parseAudio();
@@ -74,6 +75,7 @@ private:
     bool closeFile();
     bool openFile(const string& filename);
     bool parseXml();
+    static GMarkupParser getMarkupParser();
 
     static void parserText(GMarkupParseContext* context, const gchar* text, gsize textLen, gpointer userdata,
                            GError** error);
@@ -125,7 +127,18 @@ private:
 
     vector<double> pressureBuffer;
 
+    /**
+     * The points of a stroke are read first, so they can be added with the exact size
+     */
+    vector<Point> pointBuffer;
+
     PageRef page;
+
+    /**
+     * The elements of the current page are allocated together
+     */
+    ElementArenaPtr arena;
+
     Layer* layer;
     Stroke* stroke;
     Text* text;
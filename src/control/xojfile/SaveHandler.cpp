@@ -1,11 +1,20 @@
 #include "SaveHandler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
 #include <config.h>
+#include <glib/gstdio.h>
 
 #include "control/jobs/ProgressListener.h"
 #include "control/pagetype/PageTypeHandler.h"
 #include "control/xml/XmlImageNode.h"
 #include "control/xml/XmlNode.h"
+#include "control/xml/XmlPageNode.h"
 #include "control/xml/XmlPointNode.h"
 #include "control/xml/XmlTexNode.h"
 #include "control/xml/XmlTextNode.h"
@@ -18,6 +27,7 @@
 #include "model/TexImage.h"
 #include "model/Text.h"
 
+#include "PathUtil.h"
 #include "i18n.h"
 
 SaveHandler::SaveHandler() {
@@ -27,28 +37,37 @@ SaveHandler::SaveHandler() {
     this->backgroundImages = nullptr;
 }
 
-SaveHandler::~SaveHandler() {
+SaveHandler::~SaveHandler() { cleanup(); }
+
+void SaveHandler::cleanup() {
     delete this->root;
+    this->root = nullptr;
+    this->pages.clear();
 
     for (GList* l = this->backgroundImages; l != nullptr; l = l->next) {
         delete static_cast<BackgroundImage*>(l->data);
     }
     g_list_free(this->backgroundImages);
     this->backgroundImages = nullptr;
-}
 
-void SaveHandler::prepareSave(Document* doc) {
-    if (this->root) {
-        // cleanup old data
-        delete this->root;
-        this->root = nullptr;
+    if (this->preview) {
+        cairo_surface_destroy(this->preview);
+        this->preview = nullptr;
+    }
 
-        for (GList* l = this->backgroundImages; l != nullptr; l = l->next) {
-            delete static_cast<BackgroundImage*>(l->data);
-        }
-        g_list_free(this->backgroundImages);
-        this->backgroundImages = nullptr;
+    if (!this->attachedPdf.isEmpty()) {
+        g_unlink(this->attachedPdf.c_str());
+        this->attachedPdf = Path();
     }
+}
+
+auto SaveHandler::isZipContainer() -> bool { return true; }
+
+void SaveHandler::setCompressionLevel(int level) { this->compressionLevel = level; }
+
+void SaveHandler::prepareSave(Document* doc) {
+    // cleanup old data
+    cleanup();
 
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
@@ -59,9 +78,14 @@ void SaveHandler::prepareSave(Document* doc) {
 
     cairo_surface_t* preview = doc->getPreview();
     if (preview) {
-        auto* image = new XmlImageNode("preview");
-        image->setImage(preview);
-        this->root->addChild(image);
+        if (isZipContainer()) {
+            // Written as separate PNG entry, see XojPreviewExtractor
+            this->preview = cairo_surface_reference(preview);
+        } else {
+            auto* image = new XmlImageNode("preview");
+            image->setImage(preview);
+            this->root->addChild(image);
+        }
     }
 
     for (size_t i = 0; i < doc->getPageCount(); i++) {
@@ -198,8 +222,9 @@ void SaveHandler::visitLayer(XmlNode* page, Layer* l) {
 }
 
 void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
-    auto* page = new XmlNode("page");
+    auto* page = new XmlPageNode();
     root->addChild(page);
+    this->pages.push_back(page);
     page->setAttrib("width", p->getWidth());
     page->setAttrib("height", p->getHeight());
 
@@ -216,7 +241,36 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
         if (!firstPdfPageVisited) {
             firstPdfPageVisited = true;
 
-            if (doc->isAttachPdf()) {
+            if (doc->isAttachPdf() && isZipContainer()) {
+                // The PDF is added to the zip container, save a temporary copy until then
+                background->setAttrib("domain", "attach");
+                background->setAttrib("filename", "attachments/bg.pdf");
+
+                GError* error = nullptr;
+                GFileIOStream* fileStream = nullptr;
+                GFile* tmpFile = g_file_new_tmp("xournalpp-XXXXXX.bg.pdf", &fileStream, &error);
+                if (tmpFile) {
+                    g_io_stream_close(G_IO_STREAM(fileStream), nullptr, nullptr);
+                    g_object_unref(fileStream);
+
+                    char* tmpFilename = g_file_get_path(tmpFile);
+                    this->attachedPdf = Path(tmpFilename);
+                    g_free(tmpFilename);
+                    g_object_unref(tmpFile);
+
+                    doc->getPdfDocument().save(this->attachedPdf, &error);
+                }
+
+                if (error) {
+                    if (!this->errorMessage.empty()) {
+                        this->errorMessage += "\n";
+                    }
+                    this->errorMessage += FS(_F("Could not write background \"{1}\", {2}") %
+                                             this->attachedPdf.str() % error->message);
+
+                    g_error_free(error);
+                }
+            } else if (doc->isAttachPdf()) {
                 background->setAttrib("domain", "attach");
                 Path filename = Path(doc->getFilename().str() + ".bg.pdf");
                 background->setAttrib("filename", filename.str());
@@ -249,7 +303,8 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
             background->setAttrib("filename", filename);
             g_free(filename);
         } else if (p->getBackgroundImage().isAttached() && p->getBackgroundImage().getPixbuf()) {
-            char* filename = g_strdup_printf("bg_%d.png", this->attachBgId++);
+            char* filename = g_strdup_printf(isZipContainer() ? "attachments/bg_%d.png" : "bg_%d.png",
+                                             this->attachBgId++);
             background->setAttrib("domain", "attach");
             background->setAttrib("filename", filename);
             p->getBackgroundImage().setFilename(filename);
@@ -293,21 +348,72 @@ void SaveHandler::writeSolidBackground(XmlNode* background, PageRef p) {
     }
 }
 
+void SaveHandler::setBackupFilename(Path backup) { this->backupFilename = std::move(backup); }
+
+/**
+ * The document is written to a temporary file next to the target, flushed to disk
+ * and then renamed over the target, so a crash never leaves a truncated document
+ */
 void SaveHandler::saveTo(const Path& filename, ProgressListener* listener) {
-    GzOutputStream out(filename);
+    gint64 startTime = g_get_monotonic_time();
+
+    // Replace the file a link points to, not the link
+    Path target = PathUtil::resolveSymlinks(filename);
+    Path tmpFilename = target.getParentPath() / ("." + target.getFilename() + ".tmp");
+    bool written = false;
+
+    if (isZipContainer()) {
+        written = saveToZip(tmpFilename, listener);
+    } else {
+        GzOutputStream out(tmpFilename, this->compressionLevel);
+
+        if (!out.getLastError().empty()) {
+            this->errorMessage = out.getLastError();
+            return;
+        }
+
+        // The filename is used for the attached background images
+        saveTo(&out, filename, listener);
+
+        out.close();
+
+        written = out.getLastError().empty();
+        if (this->errorMessage.empty()) {
+            this->errorMessage = out.getLastError();
+        }
+    }
 
-    if (!out.getLastError().empty()) {
-        this->errorMessage = out.getLastError();
+    if (!written) {
+        // Keep the previous version of the document
+        g_unlink(tmpFilename.c_str());
         return;
     }
 
-    saveTo(&out, filename, listener);
+    if (!PathUtil::syncFile(tmpFilename)) {
+        g_warning("%s", FC(FORMAT_STR("Could not flush \"{1}\" to disk") % tmpFilename.str()));
+    }
 
-    out.close();
+    // The old document stays as backup. It is linked or copied, so the document is never missing if replacing it
+    // fails.
+    if (!this->backupFilename.isEmpty() && target.exists()) {
+        if (!PathUtil::createBackup(target, this->backupFilename)) {
+            g_warning(_("Could not create backup! (The file was created from an older Xournal version)"));
+        }
+    }
 
-    if (this->errorMessage.empty()) {
-        this->errorMessage = out.getLastError();
+    if (!PathUtil::replaceFile(tmpFilename, target)) {
+        g_unlink(tmpFilename.c_str());
+        if (!this->errorMessage.empty()) {
+            this->errorMessage += "\n";
+        }
+        this->errorMessage += FS(_F("Could not write file \"{1}\", the previous version was kept") % filename.str());
+        return;
     }
+
+    GStatBuf fileStat;
+    gint64 size = g_stat(filename.c_str(), &fileStat) == 0 ? fileStat.st_size : -1;
+    g_debug("%s", FC(FORMAT_STR("Saved \"{1}\" in {2} ms, {3} bytes (compression level {4})") % filename.str() %
+                     ((g_get_monotonic_time() - startTime) / 1000) % size % this->compressionLevel));
 }
 
 void SaveHandler::saveTo(OutputStream* out, const Path& filename, ProgressListener* listener) {
@@ -330,4 +436,151 @@ void SaveHandler::saveTo(OutputStream* out, const Path& filename, ProgressListen
     }
 }
 
+static cairo_status_t pngWriteToString(string* png, const unsigned char* data, unsigned int length) {
+    png->append(reinterpret_cast<const char*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+auto SaveHandler::saveToZip(const Path& filename, ProgressListener* listener) -> bool {
+    ZipWriter zip(filename);
+
+    if (!zip.getLastError().empty()) {
+        this->errorMessage = zip.getLastError();
+        return false;
+    }
+
+    // The mimetype has to be the first entry, and is stored uncompressed
+    zip.addEntry(ZipWriter::createEntry("mimetype", "application/xournal++", 0));
+    zip.addEntry(ZipWriter::createEntry("META-INF/version", "current=5\nmin=5\n", 0));
+
+    if (this->preview) {
+        string png;
+        cairo_surface_write_to_png_stream(this->preview, reinterpret_cast<cairo_write_func_t>(&pngWriteToString),
+                                          &png);
+        zip.addEntry(ZipWriter::createEntry("thumbnails/thumbnail.png", png, 0));
+    }
+
+    // The content only contains references to the page entries
+    for (size_t i = 0; i < this->pages.size(); i++) {
+        this->pages[i]->setEntryName("pages/page" + std::to_string(i + 1) + ".xml");
+    }
+
+    StringOutputStream content;
+    content.write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
+    root->writeOut(&content, nullptr);
+    zip.addEntry(ZipWriter::createEntry("content.xml", content.getString(), this->compressionLevel));
+
+    writePageEntries(zip, listener);
+
+    for (GList* l = this->backgroundImages; l != nullptr; l = l->next) {
+        auto* img = static_cast<BackgroundImage*>(l->data);
+
+        gchar* buffer = nullptr;
+        gsize bufferSize = 0;
+        if (gdk_pixbuf_save_to_buffer(img->getPixbuf(), &buffer, &bufferSize, "png", nullptr, nullptr)) {
+            zip.addEntry(ZipWriter::createEntry(img->getFilename(), string(buffer, bufferSize), 0));
+            g_free(buffer);
+        } else {
+            if (!this->errorMessage.empty()) {
+                this->errorMessage += "\n";
+            }
+
+            this->errorMessage +=
+                    FS(_F("Could not write background \"{1}\". Continuing anyway.") % img->getFilename());
+        }
+    }
+
+    if (!this->attachedPdf.isEmpty()) {
+        gchar* pdf = nullptr;
+        gsize pdfSize = 0;
+        if (g_file_get_contents(this->attachedPdf.c_str(), &pdf, &pdfSize, nullptr)) {
+            zip.addEntry(ZipWriter::createEntry("attachments/bg.pdf", string(pdf, pdfSize), this->compressionLevel));
+            g_free(pdf);
+        } else {
+            if (!this->errorMessage.empty()) {
+                this->errorMessage += "\n";
+            }
+            this->errorMessage +=
+                    FS(_F("Could not write background \"{1}\". Continuing anyway.") % this->attachedPdf.str());
+        }
+    }
+
+    zip.close();
+
+    if (zip.getLastError().empty()) {
+        return true;
+    }
+
+    // The save failed, which is more important than the skipped backgrounds
+    if (!this->errorMessage.empty()) {
+        this->errorMessage = zip.getLastError() + "\n" + this->errorMessage;
+    } else {
+        this->errorMessage = zip.getLastError();
+    }
+    return false;
+}
+
+/**
+ * Serialize and compress the pages on all cores, the entries are
+ * appended to the archive in page order as soon as they are ready
+ */
+void SaveHandler::writePageEntries(ZipWriter& zip, ProgressListener* listener) {
+    size_t count = this->pages.size();
+    if (count == 0) {
+        return;
+    }
+
+    vector<ZipEntry> entries(count);
+    vector<bool> finished(count, false);
+    std::mutex mutex;
+    std::condition_variable entryFinished;
+    std::atomic<size_t> nextPage{0};
+
+    auto compressPages = [&]() {
+        for (size_t i = nextPage++; i < count; i = nextPage++) {
+            StringOutputStream out;
+            out.write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
+            this->pages[i]->writeContent(&out);
+            ZipEntry entry = ZipWriter::createEntry(this->pages[i]->getEntryName(), out.getString(),
+                                                    this->compressionLevel);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                entries[i] = std::move(entry);
+                finished[i] = true;
+            }
+            entryFinished.notify_one();
+        }
+    };
+
+    size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U), count);
+    vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(compressPages);
+    }
+
+    if (listener) {
+        listener->setMaximumState(count);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        ZipEntry entry;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            entryFinished.wait(lock, [&]() { return finished[i]; });
+            entry = std::move(entries[i]);
+        }
+
+        zip.addEntry(entry);
+
+        if (listener) {
+            listener->setCurrentState(i + 1);
+        }
+    }
+
+    for (std::thread& t: threads) {
+        t.join();
+    }
+}
+
 auto SaveHandler::getErrorMessage() -> string { return this->errorMessage; }
@@ -21,8 +21,10 @@
 
 #include "OutputStream.h"
 #include "XournalType.h"
+#include "ZipWriter.h"
 
 class XmlNode;
+class XmlPageNode;
 class XmlPointNode;
 class ProgressListener;
 
@@ -33,7 +35,21 @@ public:
 
 public:
     void prepareSave(Document* doc);
+
+    /**
+     * zlib compression level, 0 stores the data uncompressed
+     */
+    void setCompressionLevel(int level);
     void saveTo(const Path& filename, ProgressListener* listener = nullptr);
+
+    /**
+     * Keep the previous version of the file with this name, instead of replacing it
+     */
+    void setBackupFilename(Path backup);
+
+    /**
+     * Write the document as single XML stream, as used by the .xoj format
+     */
     void saveTo(OutputStream* out, const Path& filename, ProgressListener* listener = nullptr);
     string getErrorMessage();
 
@@ -53,6 +69,17 @@ protected:
     virtual void writeSolidBackground(XmlNode* background, PageRef p);
     virtual void writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode);
 
+    /**
+     * If true the document is written as zip container, with each page in its own entry,
+     * else as single gzipped XML file
+     */
+    virtual bool isZipContainer();
+
+private:
+    bool saveToZip(const Path& filename, ProgressListener* listener);
+    void writePageEntries(ZipWriter& zip, ProgressListener* listener);
+    void cleanup();
+
 protected:
     XmlNode* root;
     bool firstPdfPageVisited;
@@ -60,5 +87,21 @@ protected:
 
     string errorMessage;
 
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
+
+    Path backupFilename;
+
     GList* backgroundImages;
+
+    /**
+     * The page nodes, they are owned by root
+     */
+    vector<XmlPageNode*> pages;
+
+    cairo_surface_t* preview = nullptr;
+
+    /**
+     * Temporary copy of the attached PDF, which is added to the zip container
+     */
+    Path attachedPdf;
 };
@@ -58,3 +58,5 @@ void XojExportHandler::writeSolidBackground(XmlNode* background, PageRef p) {
 void XojExportHandler::writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode) {
     // Do nothing since timestamp are not supported by Xournal
 }
+
+auto XojExportHandler::isZipContainer() -> bool { return false; }
@@ -33,5 +33,10 @@ protected:
     virtual void writeSolidBackground(XmlNode* background, PageRef p);
     virtual void writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode);
 
+    /**
+     * Xournal only reads gzipped XML files
+     */
+    virtual bool isZipContainer();
+
 private:
 };
@@ -33,6 +33,7 @@
 #include "undo/TextBoxUndoAction.h"
 #include "util/XojMsgBox.h"
 #include "util/cpp14memory.h"
+#include "view/LayerCache.h"
 #include "view/TextView.h"
 #include "widgets/XournalWidget.h"
 
@@ -59,6 +60,8 @@ XojPageView::XojPageView(XournalView* xournal, const PageRef& page) {
 
     g_mutex_init(&this->repaintRectMutex);
 
+    this->layerCache = std::make_shared<LayerCache>();
+
     // this does not have to be deleted afterwards:
     // (we need it for undo commands)
     this->oldtext = nullptr;
@@ -113,6 +116,8 @@ void XojPageView::deleteViewBuffer() {
         this->crBuffer = nullptr;
     }
     g_mutex_unlock(&this->drawingMutex);
+
+    this->layerCache->clear();
 }
 
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
@@ -144,7 +149,7 @@ auto XojPageView::searchTextOnPage(string& text, int* occures, double* top) -> b
             pdf = doc->getPdfPage(pNr);
             doc->unlock();
         }
-        this->search = new SearchControl(page, pdf);
+        this->search = new SearchControl(page, pdf, xournal->getControl()->getSearchIndex());
     }
 
     bool found = this->search->search(text, occures, top);
@@ -192,7 +197,7 @@ void XojPageView::endText() {
 
     delete this->textEditor;
     this->textEditor = nullptr;
-    this->rerenderPage();
+    this->rerenderLayer(this->page->getSelectedLayer());
 }
 
 void XojPageView::startText(double x, double y) {
@@ -268,7 +273,7 @@ void XojPageView::startText(double x, double y) {
             this->textEditor->mousePressed(x - text->getX(), y - text->getY());
         }
 
-        this->rerenderPage();
+        this->rerenderLayer(this->page->getSelectedLayer());
     }
 }
 
@@ -604,6 +609,24 @@ auto XojPageView::onKeyReleaseEvent(GdkEventKey* event) -> bool {
 }
 
 void XojPageView::rerenderPage() {
+    this->layerCache->clear();
+
+    this->rerenderComplete = true;
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+}
+
+void XojPageView::rerenderLayers() {
+    // Layers are toggled on this page, from now on the layers are worth keeping
+    this->layerCache->setEnabled(true);
+    this->layerCache->removeDeletedLayers(this->page);
+
+    this->rerenderComplete = true;
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+}
+
+void XojPageView::rerenderLayer(Layer* layer) {
+    this->layerCache->invalidate(layer);
+
     this->rerenderComplete = true;
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
@@ -617,11 +640,17 @@ void XojPageView::repaintArea(double x1, double y1, double x2, double y2) {
 }
 
 void XojPageView::rerenderRect(double x, double y, double width, double height) {
+    // Called by the tools, which edit the selected layer
+    rerenderLayerRect(this->page->getSelectedLayer(), x, y, width, height);
+}
+
+void XojPageView::rerenderLayerRect(Layer* layer, double x, double y, double width, double height) {
     int rx = std::lround(std::max(x - 10, 0.0));
     int ry = std::lround(std::max(y - 10, 0.0));
     int rwidth = std::lround(width + 20);
     int rheight = std::lround(height + 20);
 
+    this->layerCache->invalidate(layer, Rectangle(rx, ry, rwidth, rheight));
     addRerenderRect(rx, ry, rwidth, rheight);
 }
 
@@ -660,6 +689,8 @@ void XojPageView::setSelected(bool selected) {
     if (selected) {
         this->xournal->requestFocus();
         this->xournal->getRepaintHandler()->repaintPageBorder(this);
+    } else {
+        this->layerCache->setEnabled(false);
     }
 }
 
@@ -829,6 +860,8 @@ auto XojPageView::getBufferPixels() -> int {
     return 0;
 }
 
+auto XojPageView::getLayerCache() const -> std::shared_ptr<LayerCache> { return this->layerCache; }
+
 auto XojPageView::getSelectionColor() -> GtkColorWrapper { return settings->getSelectionColor(); }
 
 auto XojPageView::getTextEditor() -> TextEditor* { return textEditor; }
@@ -901,9 +934,17 @@ auto XojPageView::getRect() const -> Rectangle {
     return Rectangle(getX(), getY(), getDisplayWidth(), getDisplayHeight());
 }
 
-void XojPageView::rectChanged(Rectangle& rect) { rerenderRect(rect.x, rect.y, rect.width, rect.height); }
+/**
+ * Undo actions may change any layer, not only the selected one
+ */
+void XojPageView::rectChanged(Rectangle& rect) { rerenderLayerRect(nullptr, rect.x, rect.y, rect.width, rect.height); }
 
-void XojPageView::rangeChanged(Range& range) { rerenderRange(range); }
+/**
+ * Undo actions may change any layer, not only the selected one
+ */
+void XojPageView::rangeChanged(Range& range) {
+    rerenderLayerRect(nullptr, range.getX(), range.getY(), range.getWidth(), range.getHeight());
+}
 
 void XojPageView::pageChanged() { rerenderPage(); }
 
@@ -919,6 +960,16 @@ void XojPageView::elementChanged(Element* elem) {
 
         g_mutex_unlock(&this->drawingMutex);
     } else {
-        rerenderElement(elem);
+        Layer* layer = nullptr;
+        for (Layer* l: *this->page->getLayers()) {
+            if (l->indexOf(elem) != Layer::InvalidElementIndex) {
+                layer = l;
+                break;
+            }
+        }
+
+        // A removed element is in no layer, then the area is rendered again for all layers
+        rerenderLayerRect(layer, elem->getX() - 1, elem->getY() - 1, elem->getElementWidth() + 2,
+                          elem->getElementHeight() + 2);
     }
 }
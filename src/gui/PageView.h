@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "gui/inputdevices/PositionInputData.h"
 #include "model/PageListener.h"
 #include "model/PageRef.h"
@@ -23,6 +25,8 @@
 class EditSelection;
 class EraseHandler;
 class InputHandler;
+class Layer;
+class LayerCache;
 class SearchControl;
 class Selection;
 class Settings;
@@ -42,6 +46,17 @@ public:
     virtual void rerenderPage();
     virtual void rerenderRect(double x, double y, double width, double height);
 
+    /**
+     * Render the page again after a layer was shown, hidden, added or removed. The content of the other layers did
+     * not change, so their cached surfaces are composited again.
+     */
+    void rerenderLayers();
+
+    /**
+     * Render the page again after many elements of a layer changed, the other layers are kept
+     */
+    void rerenderLayer(Layer* layer);
+
     virtual void repaintPage();
     virtual void repaintArea(double x1, double y1, double x2, double y2);
 
@@ -89,6 +104,8 @@ public:
     GtkColorWrapper getSelectionColor();
     int getBufferPixels();
 
+    std::shared_ptr<LayerCache> getLayerCache() const;
+
     /**
      * 0 if currently visible
      * -1 if no image is saved (never visible or cleanup)
@@ -174,6 +191,11 @@ private:
 
     void addRerenderRect(double x, double y, double width, double height);
 
+    /**
+     * @param layer The changed layer, nullptr if it is not known
+     */
+    void rerenderLayerRect(Layer* layer, double x, double y, double width, double height);
+
     void drawLoadingPage(cairo_t* cr);
 
     void setX(int x);
@@ -231,6 +253,11 @@ private:
 
     GMutex drawingMutex{};
 
+    /**
+     * Background and layers rendered separately, only used for the selected page
+     */
+    std::shared_ptr<LayerCache> layerCache;
+
     int dispX{};  // position on display - set in Layout::layoutPages
     int dispY{};
 
@@ -43,7 +43,10 @@ SearchBar::SearchBar(Control* control): control(control) {
                                    GTK_STYLE_PROVIDER(cssTextFild), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 }
 
-SearchBar::~SearchBar() { this->control = nullptr; }
+SearchBar::~SearchBar() {
+    cancelSearch();
+    this->control = nullptr;
+}
 
 auto SearchBar::searchTextonCurrentPage(const char* text, int* occures, double* top) -> bool {
     int p = control->getCurrentPageNo();
@@ -51,30 +54,30 @@ auto SearchBar::searchTextonCurrentPage(const char* text, int* occures, double*
     return control->searchTextOnPage(text, p, occures, top);
 }
 
-void SearchBar::search(const char* text) {
-    MainWindow* win = control->getWindow();
-    GtkWidget* lbSearchState = win->get("lbSearchState");
+void SearchBar::releaseJob(SearchJob*& job) {
+    if (job) {
+        job->cancel();
+        job->unref();
+        job = nullptr;
+    }
+}
 
-    bool found = true;
-    int occures = 0;
+void SearchBar::cancelSearch() {
+    releaseJob(this->countJob);
+    releaseJob(this->navigateJob);
+}
 
-    if (*text != 0) {
-        found = searchTextonCurrentPage(text, &occures, nullptr);
-        if (found) {
-            if (occures == 1) {
-                gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text found on this page"));
-            } else {
-                char* msg = g_strdup_printf(_("Text %i times found on this page"), occures);
-                gtk_label_set_text(GTK_LABEL(lbSearchState), msg);
-                g_free(msg);
-            }
-        } else {
-            gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found"));
-        }
-    } else {
-        searchTextonCurrentPage("", nullptr, nullptr);
-        gtk_label_set_text(GTK_LABEL(lbSearchState), "");
-    }
+auto SearchBar::startSearch(const char* text, size_t startPage, SearchOrder order, bool stopAtFirst) -> SearchJob* {
+    // The initial reference is kept until the search is finished or cancelled
+    auto* job = new SearchJob(control, this, text, startPage, order, stopAtFirst);
+    control->getScheduler()->addSearch(job);
+
+    return job;
+}
+
+void SearchBar::setSearchState(const string& state, bool found) {
+    MainWindow* win = control->getWindow();
+    gtk_label_set_text(GTK_LABEL(win->get("lbSearchState")), state.c_str());
 
     if (found) {
         gtk_css_provider_load_from_data(cssTextFild, "GtkSearchEntry {}", -1, nullptr);
@@ -83,59 +86,115 @@ void SearchBar::search(const char* text) {
     }
 }
 
-void SearchBar::searchTextChangedCallback(GtkEntry* entry, SearchBar* searchBar) {
-    const char* text = gtk_entry_get_text(entry);
-    searchBar->search(text);
+void SearchBar::updateDocumentState(bool finished) {
+    string state;
+    if (this->resultCount == 0) {
+        if (finished) {
+            setSearchState(_("Text not found"), false);
+            return;
+        }
+        state = _("Searching...");
+    } else if (this->currentPageResults > 0) {
+        state = FS(_F("Text {1} times found on this page, {2} times on {3} pages") % this->currentPageResults %
+                   this->resultCount % this->resultPages);
+    } else {
+        state = FS(_F("Text {1} times found on {2} pages") % this->resultCount % this->resultPages);
+    }
+
+    if (!finished && this->resultCount > 0) {
+        state = FS(_F("{1} (searching...)") % state);
+    }
+
+    setSearchState(state, true);
 }
 
-void SearchBar::buttonCloseSearchClicked(GtkButton* button, SearchBar* searchBar) { searchBar->showSearchBar(false); }
+void SearchBar::search(const char* text) {
+    cancelSearch();
 
-void SearchBar::searchNext() {
-    int page = control->getCurrentPageNo();
-    int count = control->getDocument()->getPageCount();
-    if (count < 2) {
-        // Nothing to do
+    if (*text == 0) {
+        searchTextonCurrentPage("", nullptr, nullptr);
+        setSearchState("", true);
         return;
     }
 
+    countResults(text);
+}
+
+void SearchBar::countResults(const char* text) {
+    releaseJob(this->countJob);
+
+    // The current page is shown immediately, the rest of the document is searched in the background
+    int occures = 0;
+    searchTextonCurrentPage(text, &occures, nullptr);
+
+    this->currentPageResults = occures;
+    this->resultCount = 0;
+    this->resultPages = 0;
+    updateDocumentState(false);
+
+    this->countJob = startSearch(text, control->getCurrentPageNo(), SEARCH_ORDER_OUTWARD, false);
+}
+
+void SearchBar::updateDocumentResults() {
     MainWindow* win = control->getWindow();
-    int x = page + 1;
-    GtkWidget* searchTextField = win->get("searchTextField");
-    const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
-    GtkWidget* lbSearchState = win->get("lbSearchState");
-    if (*text == 0) {
+    GtkWidget* searchBar = win->get("searchBar");
+    if (!gtk_widget_get_visible(searchBar)) {
         return;
     }
 
-    if (x >= count) {
-        x = 0;
+    const char* text = gtk_entry_get_text(GTK_ENTRY(win->get("searchTextField")));
+    if (*text != 0) {
+        // A running navigation to the next / previous result continues
+        countResults(text);
     }
+}
 
-    double top = 0;
-    int occures = 0;
+void SearchBar::searchResultFound(SearchJob* job, size_t page, size_t count) {
+    if (job == this->countJob) {
+        this->resultCount += count;
+        this->resultPages++;
+        updateDocumentState(false);
+        return;
+    }
 
-    while (x != page) {
+    if (job != this->navigateJob) {
+        return;
+    }
 
-        bool found = control->searchTextOnPage(text, x, &occures, &top);
-        if (found) {
-            control->getScrollHandler()->scrollToPage(x, top);
-            gtk_label_set_text(GTK_LABEL(lbSearchState),
-                               (occures == 1 ? FC(_F("Text found once on page {1}") % (x + 1)) :
-                                               FC(_F("Text found {1} times on page {2}") % occures % (x + 1))));
-            return;
-        }
+    int occures = 0;
+    double top = 0;
+    control->searchTextOnPage(job->getText(), page, &occures, &top);
+    control->getScrollHandler()->scrollToPage(page, top);
 
-        x++;
-        if (x >= count) {
-            x = 0;
+    setSearchState(occures == 1 ? FS(_F("Text found once on page {1}") % (page + 1)) :
+                                  FS(_F("Text found {1} times on page {2}") % occures % (page + 1)),
+                   true);
+}
+
+void SearchBar::searchFinished(SearchJob* job) {
+    if (job == this->countJob) {
+        updateDocumentState(true);
+        releaseJob(this->countJob);
+    } else if (job == this->navigateJob) {
+        if (!job->hasResults()) {
+            setSearchState(_("Text not found, searched on all pages"), false);
         }
+        releaseJob(this->navigateJob);
     }
+}
 
-    gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
+void SearchBar::searchTextChangedCallback(GtkEntry* entry, SearchBar* searchBar) {
+    const char* text = gtk_entry_get_text(entry);
+    searchBar->search(text);
 }
 
-void SearchBar::searchPrevious() {
-    int page = control->getCurrentPageNo();
+void SearchBar::buttonCloseSearchClicked(GtkButton* button, SearchBar* searchBar) { searchBar->showSearchBar(false); }
+
+void SearchBar::searchNext() { searchFromCurrentPage(SEARCH_ORDER_FORWARD); }
+
+void SearchBar::searchPrevious() { searchFromCurrentPage(SEARCH_ORDER_BACKWARD); }
+
+void SearchBar::searchFromCurrentPage(SearchOrder order) {
     int count = control->getDocument()->getPageCount();
     if (count < 2) {
         // Nothing to do
@@ -143,39 +202,14 @@ void SearchBar::searchPrevious() {
     }
 
     MainWindow* win = control->getWindow();
-    int x = page - 1;
     GtkWidget* searchTextField = win->get("searchTextField");
     const char* text = gtk_entry_get_text(GTK_ENTRY(searchTextField));
-    GtkWidget* lbSearchState = win->get("lbSearchState");
     if (*text == 0) {
         return;
     }
 
-    if (x < 0) {
-        x = count - 1;
-    }
-
-    double top = 0;
-    int occures = 0;
-
-    while (x != page) {
-
-        bool found = control->searchTextOnPage(text, x, &occures, &top);
-        if (found) {
-            control->getScrollHandler()->scrollToPage(x, top);
-            gtk_label_set_text(GTK_LABEL(lbSearchState),
-                               (occures == 1 ? FC(_F("Text found once on page {1}") % (x + 1)) :
-                                               FC(_F("Text found {1} times on page {2}") % occures % (x + 1))));
-            return;
-        }
-
-        x--;
-        if (x < 0) {
-            x = count - 1;
-        }
-    }
-
-    gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found, searched on all pages"));
+    releaseJob(this->navigateJob);
+    this->navigateJob = startSearch(text, control->getCurrentPageNo(), order, true);
 }
 
 void SearchBar::showSearchBar(bool show) {
@@ -187,6 +221,7 @@ void SearchBar::showSearchBar(bool show) {
         gtk_widget_grab_focus(searchTextField);
         gtk_widget_show_all(searchBar);
     } else {
+        cancelSearch();
         gtk_widget_hide(searchBar);
         for (int i = control->getDocument()->getPageCount() - 1; i >= 0; i--) {
             control->searchTextOnPage("", i, nullptr, nullptr);
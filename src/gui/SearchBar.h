@@ -16,6 +16,8 @@
 
 #include <gtk/gtk.h>
 
+#include "control/jobs/SearchJob.h"
+
 #include "XournalType.h"
 
 class Control;
@@ -27,6 +29,21 @@ public:
 
     void showSearchBar(bool show);
 
+    /**
+     * The search index has changed, update the number of results in the document
+     */
+    void updateDocumentResults();
+
+    /**
+     * A running search found results on a page, called from the UI thread
+     */
+    void searchResultFound(SearchJob* job, size_t page, size_t count);
+
+    /**
+     * A running search has searched all pages (or stopped at the first result)
+     */
+    void searchFinished(SearchJob* job);
+
 private:
     static void buttonCloseSearchClicked(GtkButton* button, SearchBar* searchBar);
     static void searchTextChangedCallback(GtkEntry* entry, SearchBar* searchBar);
@@ -36,11 +53,39 @@ private:
 
     void searchNext();
     void searchPrevious();
+    void searchFromCurrentPage(SearchOrder order);
 
     void search(const char* text);
+
+    /**
+     * Highlight the results of the current page and count the results of the document again, without cancelling the
+     * navigation
+     */
+    void countResults(const char* text);
     bool searchTextonCurrentPage(const char* text, int* occures, double* top);
 
+    SearchJob* startSearch(const char* text, size_t startPage, SearchOrder order, bool stopAtFirst);
+    void cancelSearch();
+    static void releaseJob(SearchJob*& job);
+
+    void setSearchState(const string& state, bool found);
+    void updateDocumentState(bool finished);
+
 private:
     Control* control;
     GtkCssProvider* cssTextFild;
+
+    /**
+     * Counts the results in the whole document, started when the search text changes
+     */
+    SearchJob* countJob = nullptr;
+
+    /**
+     * Finds the next / previous page with results
+     */
+    SearchJob* navigateJob = nullptr;
+
+    int currentPageResults = 0;
+    size_t resultCount = 0;
+    size_t resultPages = 0;
 };
@@ -427,7 +427,7 @@ void XournalView::endTextAllPages(XojPageView* except) {
 
 void XournalView::layerChanged(size_t page) {
     if (page != npos && page < this->viewPages.size()) {
-        this->viewPages[page]->rerenderPage();
+        this->viewPages[page]->rerenderLayers();
     }
 }
 
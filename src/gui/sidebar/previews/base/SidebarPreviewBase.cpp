@@ -1,5 +1,8 @@
 #include "SidebarPreviewBase.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "control/Control.h"
 #include "control/PdfCache.h"
 
@@ -32,6 +35,10 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, GladeGui* gui, SidebarT
 
     g_signal_connect(this->scrollPreview, "size-allocate", G_CALLBACK(sizeChanged), this);
 
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    g_signal_connect(vadj, "value-changed", G_CALLBACK(scrollChanged), this);
+    g_signal_connect(vadj, "changed", G_CALLBACK(scrollChanged), this);
+
     gtk_widget_show_all(this->scrollPreview);
 
     g_signal_connect(this->iconViewPreview, "draw", G_CALLBACK(Util::paintBackgroundWhite), nullptr);
@@ -76,7 +83,55 @@ auto SidebarPreviewBase::getZoom() const -> double { return this->zoom; }
 
 auto SidebarPreviewBase::getCache() -> PdfCache* { return this->cache; }
 
-void SidebarPreviewBase::layout() { SidebarLayout::layout(this); }
+void SidebarPreviewBase::scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar) {
+    sidebar->updateVisibleRange();
+}
+
+void SidebarPreviewBase::updateVisibleRange() {
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollPreview));
+    double pageSize = gtk_adjustment_get_page_size(vadj);
+    double top = gtk_adjustment_get_value(vadj) - pageSize;
+    double bottom = gtk_adjustment_get_value(vadj) + 2 * pageSize;
+
+    size_t bufferSize = 0;
+    vector<std::pair<double, SidebarPreviewBaseEntry*>> outside;
+
+    for (SidebarPreviewBaseEntry* p: this->previews) {
+        int y = 0;
+        gtk_container_child_get(GTK_CONTAINER(this->iconViewPreview), p->getWidget(), "y", &y, nullptr);
+
+        bool inRange = y + p->getHeight() >= top && y <= bottom;
+        p->setInVisibleRange(inRange);
+
+        size_t size = p->getBufferSize();
+        bufferSize += size;
+        if (!inRange && size > 0) {
+            outside.emplace_back(std::max(top - (y + p->getHeight()), y - bottom), p);
+        }
+    }
+
+    if (bufferSize <= BUFFER_BUDGET) {
+        return;
+    }
+
+    std::sort(outside.begin(), outside.end(),
+              [](const std::pair<double, SidebarPreviewBaseEntry*>& a,
+                 const std::pair<double, SidebarPreviewBaseEntry*>& b) { return a.first > b.first; });
+
+    for (auto& e: outside) {
+        if (bufferSize <= BUFFER_BUDGET) {
+            break;
+        }
+
+        bufferSize -= e.second->getBufferSize();
+        e.second->releaseBuffer();
+    }
+}
+
+void SidebarPreviewBase::layout() {
+    SidebarLayout::layout(this);
+    updateVisibleRange();
+}
 
 auto SidebarPreviewBase::hasData() -> bool { return true; }
 
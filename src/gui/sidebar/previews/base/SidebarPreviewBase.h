@@ -82,6 +82,20 @@ protected:
      */
     static void sizeChanged(GtkWidget* widget, GtkAllocation* allocation, SidebarPreviewBase* sidebar);
 
+    /**
+     * The sidebar was scrolled
+     */
+    static void scrollChanged(GtkAdjustment* adjustment, SidebarPreviewBase* sidebar);
+
+    /**
+     * Mark the previews within one screen height of the visible area, only these are rendered. The buffers of the
+     * other previews are freed, the farthest first, if they use more than BUFFER_BUDGET.
+     */
+    void updateVisibleRange();
+
+public:
+    static constexpr size_t BUFFER_BUDGET = 16 * 1024 * 1024;
+
 private:
     /**
      * The scrollbar with the icons
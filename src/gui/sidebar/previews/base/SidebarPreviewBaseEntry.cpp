@@ -55,13 +55,47 @@ void SidebarPreviewBaseEntry::setSelected(bool selected) {
     gtk_widget_queue_draw(this->widget);
 }
 
-void SidebarPreviewBaseEntry::repaint() { sidebar->getControl()->getScheduler()->addRepaintSidebar(this); }
+void SidebarPreviewBaseEntry::repaint() {
+    // A modified page would fill the cache with previews which are never used again, unless the document is saved
+    Control* control = sidebar->getControl();
+    control->getScheduler()->addRepaintSidebar(this, JOB_PRIORITY_HIGH, !control->getUndoRedoHandler()->isChanged());
+}
 
-void SidebarPreviewBaseEntry::drawLoadingPage() {
-    GtkAllocation alloc;
-    gtk_widget_get_allocation(widget, &alloc);
+void SidebarPreviewBaseEntry::repaintChanged() {
+    // The page was just edited, the preview is not cached
+    sidebar->getControl()->getScheduler()->addRepaintSidebar(this, JOB_PRIORITY_LOW);
+}
+
+void SidebarPreviewBaseEntry::setInVisibleRange(bool inVisibleRange) { this->inVisibleRange = inVisibleRange; }
+
+auto SidebarPreviewBaseEntry::isInVisibleRange() const -> bool { return this->inVisibleRange; }
+
+auto SidebarPreviewBaseEntry::getBufferSize() -> size_t {
+    g_mutex_lock(&this->drawingMutex);
+
+    size_t size = 0;
+    if (this->crBuffer) {
+        size = static_cast<size_t>(cairo_image_surface_get_stride(this->crBuffer)) *
+               cairo_image_surface_get_height(this->crBuffer);
+    }
+
+    g_mutex_unlock(&this->drawingMutex);
+    return size;
+}
+
+void SidebarPreviewBaseEntry::releaseBuffer() {
+    g_mutex_lock(&this->drawingMutex);
+
+    if (this->crBuffer) {
+        cairo_surface_destroy(this->crBuffer);
+        this->crBuffer = nullptr;
+    }
+
+    g_mutex_unlock(&this->drawingMutex);
+}
 
-    this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, alloc.width, alloc.height);
+void SidebarPreviewBaseEntry::drawLoadingPage() {
+    this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, getWidgetWidth(), getWidgetHeight());
 
     double zoom = sidebar->getZoom();
 
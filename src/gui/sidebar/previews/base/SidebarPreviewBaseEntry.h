@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -49,8 +50,30 @@ public:
     virtual void setSelected(bool selected);
 
     virtual void repaint();
+
+    /**
+     * Render the preview of a changed page in the background, the old preview is shown until then
+     */
+    virtual void repaintChanged();
+
     virtual void updateSize();
 
+    /**
+     * Set if the preview is in or near the visible part of the sidebar. Previews outside are not rendered.
+     */
+    void setInVisibleRange(bool inVisibleRange);
+    bool isInVisibleRange() const;
+
+    /**
+     * @return The memory used by the rendered preview in bytes
+     */
+    size_t getBufferSize();
+
+    /**
+     * Free the rendered preview, it is rendered again when it is drawn
+     */
+    void releaseBuffer();
+
     /**
      * @return What should be renderered
      */
@@ -100,5 +123,10 @@ protected:
      */
     cairo_surface_t* crBuffer = nullptr;
 
+    /**
+     * Read by the PreviewJob
+     */
+    std::atomic<bool> inVisibleRange{true};
+
     friend class PreviewJob;
 };
@@ -1,5 +1,7 @@
 #include "SidebarPreviewLayerEntry.h"
 
+#include <utility>
+
 #include "gui/Shadow.h"
 #include "gui/sidebar/previews/layer/SidebarPreviewLayers.h"
 
@@ -7,10 +9,11 @@
 
 
 SidebarPreviewLayerEntry::SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar, const PageRef& page, int layer,
-                                                   size_t index):
+                                                   size_t index, std::shared_ptr<LayerCache> layerCache):
         SidebarPreviewBaseEntry(sidebar, page),
         index(index),
         layer(layer),
+        layerCache(std::move(layerCache)),
         box(gtk_box_new(GTK_ORIENTATION_VERTICAL, 2)) {
     GtkWidget* toolbar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 6);
 
@@ -11,14 +11,18 @@
 
 #pragma once
 
+#include <memory>
+
 #include "../base/SidebarPreviewBaseEntry.h"
 #include "model/PageRef.h"
 
+class LayerCache;
 class SidebarPreviewBase;
 
 class SidebarPreviewLayerEntry: public SidebarPreviewBaseEntry {
 public:
-    SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar, const PageRef& page, int layer, size_t index);
+    SidebarPreviewLayerEntry(SidebarPreviewBase* sidebar, const PageRef& page, int layer, size_t index,
+                             std::shared_ptr<LayerCache> layerCache);
     virtual ~SidebarPreviewLayerEntry();
 
 public:
@@ -57,6 +61,11 @@ private:
      */
     int layer;
 
+    /**
+     * Layers rendered by the main view, scaled down instead of rendering the layer again
+     */
+    std::shared_ptr<LayerCache> layerCache;
+
     /**
      * Toolbar with controls
      */
@@ -3,6 +3,9 @@
 #include "control/Control.h"
 #include "control/PdfCache.h"
 #include "control/layer/LayerController.h"
+#include "gui/MainWindow.h"
+#include "gui/PageView.h"
+#include "gui/XournalView.h"
 
 #include "SidebarPreviewLayerEntry.h"
 #include "i18n.h"
@@ -93,11 +96,16 @@ void SidebarPreviewLayers::updatePreviews() {
         return;
     }
 
+    // The main view keeps the layers of the selected page rendered, the previews are scaled from them
+    MainWindow* win = control->getWindow();
+    XojPageView* view = win ? win->getXournal()->getViewFor(lc->getCurrentPageId()) : nullptr;
+    std::shared_ptr<LayerCache> layerCache = view ? view->getLayerCache() : nullptr;
+
     int layerCount = page->getLayerCount();
 
     size_t index = 0;
     for (int i = layerCount; i >= 0; i--) {
-        SidebarPreviewBaseEntry* p = new SidebarPreviewLayerEntry(this, page, i - 1, index++);
+        SidebarPreviewBaseEntry* p = new SidebarPreviewLayerEntry(this, page, i - 1, index++, layerCache);
         this->previews.push_back(p);
         gtk_layout_put(GTK_LAYOUT(this->iconViewPreview), p->getWidget(), 0, 0);
     }
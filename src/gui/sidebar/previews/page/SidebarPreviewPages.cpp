@@ -201,7 +201,7 @@ void SidebarPreviewPages::pageChanged(size_t page) {
     }
 
     SidebarPreviewBaseEntry* p = this->previews[page];
-    p->repaint();
+    p->repaintChanged();
 }
 
 void SidebarPreviewPages::pageDeleted(size_t page) {
@@ -9,6 +9,14 @@ Element::Element(ElementType type): type(type) {}
 
 Element::~Element() = default;
 
+auto Element::operator new(size_t size) -> void* { return ElementArena::allocate(size, nullptr); }
+
+auto Element::operator new(size_t size, ElementArena* arena) -> void* { return ElementArena::allocate(size, arena); }
+
+void Element::operator delete(void* ptr) { ElementArena::free(ptr); }
+
+void Element::operator delete(void* ptr, ElementArena* arena) { ElementArena::free(ptr); }
+
 auto Element::getType() const -> ElementType { return this->type; }
 
 void Element::setX(double x) { this->x = x; }
@@ -18,6 +18,7 @@
 
 #include "serializing/Serializeable.h"
 
+#include "ElementArena.h"
 #include "Rectangle.h"
 #include "XournalType.h"
 
@@ -27,6 +28,16 @@ class ShapeContainer {
 public:
     virtual bool contains(double x, double y) = 0;
 
+    /**
+     * @return true if the rectangle is completely within the shape, false if it's not or if it's unknown
+     */
+    virtual bool containsRect(double x1, double y1, double x2, double y2) { return false; }
+
+    /**
+     * @return false if the rectangle is completely outside of the shape, true if it's not or if it's unknown
+     */
+    virtual bool intersectsRect(double x1, double y1, double x2, double y2) { return true; }
+
     virtual ~ShapeContainer() = default;
 };
 
@@ -37,6 +48,15 @@ protected:
 public:
     ~Element() override;
 
+public:
+    /**
+     * Elements are allocated from the heap, or with new (arena) from an ElementArena, and deleted with delete
+     */
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, ElementArena* arena);
+    static void operator delete(void* ptr);
+    static void operator delete(void* ptr, ElementArena* arena);
+
 public:
     ElementType getType() const;
 
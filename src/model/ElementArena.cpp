@@ -0,0 +1,204 @@
+#include "ElementArena.h"
+
+#include <algorithm>
+#include <new>
+
+/**
+ * Every element starts with the arena it belongs to, nullptr for heap allocations, and the size of its memory in the
+ * arena, so it can be reused when the element is deleted
+ */
+struct ElementHeader {
+    ElementArena* arena;
+    size_t size;
+};
+
+/**
+ * Everything is aligned like operator new. The header is padded to the alignment, so the element keeps it.
+ */
+constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+constexpr size_t HEADER_SIZE = (sizeof(ElementHeader) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+static_assert(sizeof(char*) <= ALIGNMENT, "A free chunk has to hold the pointer to the next one");
+
+/**
+ * The blocks grow from MIN_BLOCK_SIZE to MAX_BLOCK_SIZE, so a few pasted elements don't allocate a large block
+ */
+constexpr size_t MIN_BLOCK_SIZE = 4 * 1024;
+constexpr size_t MAX_BLOCK_SIZE = 64 * 1024;
+
+/**
+ * Larger allocations get their own block
+ */
+constexpr size_t LARGE_ELEMENT_SIZE = MAX_BLOCK_SIZE / 4;
+
+static auto alignSize(size_t size) -> size_t {
+    // A free chunk is never empty, it holds the pointer to the next one
+    return (std::max(size, size_t{1}) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+ElementArena::ElementArena(): nextBlockSize(MIN_BLOCK_SIZE) { g_mutex_init(&this->mutex); }
+
+ElementArena::~ElementArena() {
+    for (auto& block: this->blocks) {
+        ::operator delete(const_cast<char*>(block.first));
+    }
+    g_mutex_clear(&this->mutex);
+}
+
+void ElementArena::release() {
+    g_mutex_lock(&this->mutex);
+    this->released = true;
+    g_mutex_unlock(&this->mutex);
+
+    unref();
+}
+
+void ElementArena::ref() { this->refCount.fetch_add(1, std::memory_order_relaxed); }
+
+void ElementArena::unref() {
+    if (this->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+/**
+ * The size has to be aligned
+ */
+auto ElementArena::allocateBlock(size_t size) -> char* {
+    auto freed = this->freeChunks.find(size);
+    if (freed != this->freeChunks.end()) {
+        char* mem = freed->second;
+        char* next = *reinterpret_cast<char**>(mem);
+        if (next) {
+            freed->second = next;
+        } else {
+            this->freeChunks.erase(freed);
+        }
+        return mem;
+    }
+
+    if (size > LARGE_ELEMENT_SIZE) {
+        // Don't waste the rest of the current block
+        char* mem = static_cast<char*>(::operator new(size));
+        this->blocks[mem] = size;
+        this->memoryUsage += size;
+        return mem;
+    }
+
+    if (size > this->currentFree) {
+        size_t blockSize = std::max(this->nextBlockSize, size);
+        this->nextBlockSize = std::min(this->nextBlockSize * 2, MAX_BLOCK_SIZE);
+
+        this->current = static_cast<char*>(::operator new(blockSize));
+        this->currentFree = blockSize;
+        this->blocks[this->current] = blockSize;
+        this->memoryUsage += blockSize;
+    }
+
+    char* mem = this->current;
+    this->current += size;
+    this->currentFree -= size;
+    return mem;
+}
+
+void ElementArena::addFreeChunk(char* mem, size_t size) {
+    char*& head = this->freeChunks[size];
+    *reinterpret_cast<char**>(mem) = head;
+    head = mem;
+}
+
+auto ElementArena::allocate(size_t size) -> void* {
+    size = alignSize(HEADER_SIZE + size);
+
+    g_mutex_lock(&this->mutex);
+    char* mem = allocateBlock(size);
+    g_mutex_unlock(&this->mutex);
+
+    ref();
+    this->elementCount.fetch_add(1, std::memory_order_relaxed);
+
+    auto* header = reinterpret_cast<ElementHeader*>(mem);
+    header->arena = this;
+    header->size = size;
+    return mem + HEADER_SIZE;
+}
+
+auto ElementArena::allocateData(size_t size) -> void* {
+    g_mutex_lock(&this->mutex);
+    char* mem = this->released ? nullptr : allocateBlock(alignSize(size));
+    g_mutex_unlock(&this->mutex);
+    return mem;
+}
+
+auto ElementArena::allocate(size_t size, ElementArena* arena) -> void* {
+    if (arena) {
+        return arena->allocate(size);
+    }
+
+    char* mem = static_cast<char*>(::operator new(HEADER_SIZE + size));
+    auto* header = reinterpret_cast<ElementHeader*>(mem);
+    header->arena = nullptr;
+    header->size = 0;
+    return mem + HEADER_SIZE;
+}
+
+void ElementArena::free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    char* mem = static_cast<char*>(ptr) - HEADER_SIZE;
+    auto* header = reinterpret_cast<ElementHeader*>(mem);
+    ElementArena* arena = header->arena;
+    if (arena == nullptr) {
+        ::operator delete(mem);
+        return;
+    }
+
+    g_mutex_lock(&arena->mutex);
+    if (!arena->released) {
+        arena->addFreeChunk(mem, header->size);
+    }
+    g_mutex_unlock(&arena->mutex);
+
+    arena->elementCount.fetch_sub(1, std::memory_order_relaxed);
+    arena->unref();
+}
+
+auto ElementArena::freeData(void* ptr, size_t size) -> bool {
+    g_mutex_lock(&this->mutex);
+    bool owned = ownsLocked(ptr);
+    if (owned && !this->released) {
+        addFreeChunk(static_cast<char*>(ptr), alignSize(size));
+    }
+    g_mutex_unlock(&this->mutex);
+
+    return owned;
+}
+
+auto ElementArena::ownsLocked(const void* ptr) -> bool {
+    const char* mem = static_cast<const char*>(ptr);
+
+    auto it = this->blocks.upper_bound(mem);
+    if (it == this->blocks.begin()) {
+        return false;
+    }
+    --it;
+    return mem < it->first + it->second;
+}
+
+auto ElementArena::owns(const void* ptr) -> bool {
+    g_mutex_lock(&this->mutex);
+    bool owned = ownsLocked(ptr);
+    g_mutex_unlock(&this->mutex);
+
+    return owned;
+}
+
+auto ElementArena::getElementCount() const -> size_t { return this->elementCount.load(); }
+
+auto ElementArena::getMemoryUsage() -> size_t {
+    g_mutex_lock(&this->mutex);
+    size_t usage = this->memoryUsage;
+    g_mutex_unlock(&this->mutex);
+    return usage;
+}
@@ -0,0 +1,218 @@
+/*
+ * Xournal++
+ *
+ * Block storage for elements which are created together
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <glib.h>
+
+/**
+ * Allocates the elements of e.g. one loaded page next to each other in large blocks, with new (arena) Stroke().
+ *
+ * The elements are deleted as usual with delete, wherever they are moved to (other layers, undo actions...). While the
+ * creator still allocates, the memory of deleted elements and data is kept in free lists by size and reused. The blocks
+ * are freed at once when the arena was released by its creator and the last element and allocator referencing it are
+ * gone. Deleting still runs the destructor of each element, only the memory is freed in bulk.
+ *
+ * The data of an element can be stored in the arena, too (see ArenaAllocator), then deleting the element frees no
+ * memory at all. Once the creator released the arena, data is allocated from the heap, so growing the data of an
+ * element later does not waste arena memory again.
+ */
+class ElementArena {
+public:
+    ElementArena();
+
+private:
+    ~ElementArena();
+    ElementArena(const ElementArena& arena) = delete;
+    void operator=(const ElementArena& arena) = delete;
+
+public:
+    /**
+     * Called by the creator if no more elements are allocated, the arena is deleted with its last reference
+     */
+    void release();
+
+    /**
+     * Keep the arena alive, e.g. for an allocator which may still allocate or free from it
+     */
+    void ref();
+    void unref();
+
+    /**
+     * Allocate memory for an element, thread safe
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Allocate memory for an element, from the arena if it's not nullptr, else from the heap
+     */
+    static void* allocate(size_t size, ElementArena* arena);
+
+    /**
+     * Allocate memory for the data of an element, which is freed with the arena. Thread safe
+     *
+     * @return nullptr if the arena was released by its creator, then the data has to be allocated from the heap
+     */
+    void* allocateData(size_t size);
+
+    /**
+     * Free memory from allocate(), thread safe
+     */
+    static void free(void* ptr);
+
+    /**
+     * Free memory from allocateData(), it's reused if the arena was not released yet. Thread safe
+     *
+     * @return false if the memory was not allocated from this arena
+     */
+    bool freeData(void* ptr, size_t size);
+
+    /**
+     * @return true if the memory was allocated from this arena
+     */
+    bool owns(const void* ptr);
+
+    /**
+     * @return The number of elements which are still allocated from this arena
+     */
+    size_t getElementCount() const;
+
+    /**
+     * @return The size of the allocated blocks in bytes
+     */
+    size_t getMemoryUsage();
+
+private:
+    /**
+     * The mutex has to be locked for these
+     */
+    char* allocateBlock(size_t size);
+    void addFreeChunk(char* mem, size_t size);
+    bool ownsLocked(const void* ptr);
+
+private:
+    /**
+     * The creator holds one reference, each allocated element and each ArenaAllocator another one
+     */
+    std::atomic<size_t> refCount{1};
+    std::atomic<size_t> elementCount{0};
+
+    GMutex mutex{};
+    bool released = false;
+
+    /**
+     * The start address and size of each block
+     */
+    std::map<const char*, size_t> blocks;
+    size_t memoryUsage = 0;
+
+    /**
+     * Freed memory by its aligned size. Each free chunk starts with the pointer to the next one of the same size
+     */
+    std::unordered_map<size_t, char*> freeChunks;
+
+    char* current = nullptr;
+    size_t currentFree = 0;
+    size_t nextBlockSize;
+};
+
+struct ElementArenaRelease {
+    void operator()(ElementArena* arena) const { arena->release(); }
+};
+
+/**
+ * The reference of the creator, releases the arena when it goes out of scope
+ */
+using ElementArenaPtr = std::unique_ptr<ElementArena, ElementArenaRelease>;
+
+/**
+ * Allocator for the data of an element which is allocated from the same arena, or for the heap if arena is nullptr.
+ * The allocator holds a reference to the arena, so a container moved into an element outside of the arena can still
+ * free its data. Data allocated after the arena was released, and copies of a container, are on the heap.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+
+    ArenaAllocator(ElementArena* arena = nullptr): arena(arena) {
+        if (this->arena) {
+            this->arena->ref();
+        }
+    }
+
+    ArenaAllocator(const ArenaAllocator& other): ArenaAllocator(other.getArena()) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other): ArenaAllocator(other.getArena()) {}
+
+    ~ArenaAllocator() {
+        if (this->arena) {
+            this->arena->unref();
+        }
+    }
+
+    ArenaAllocator& operator=(const ArenaAllocator& other) {
+        if (other.arena) {
+            other.arena->ref();
+        }
+        if (this->arena) {
+            this->arena->unref();
+        }
+        this->arena = other.arena;
+        return *this;
+    }
+
+    T* allocate(size_t count) {
+        if (this->arena) {
+            void* mem = this->arena->allocateData(count * sizeof(T));
+            if (mem) {
+                return static_cast<T*>(mem);
+            }
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        // Arena memory is reused or freed with the arena
+        if (this->arena == nullptr || !this->arena->freeData(ptr, count * sizeof(T))) {
+            ::operator delete(ptr);
+        }
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+    ElementArena* getArena() const { return this->arena; }
+
+private:
+    ElementArena* arena;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() != b.getArena();
+}
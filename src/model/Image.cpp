@@ -47,6 +47,11 @@ auto Image::cairoReadFunction(Image* image, unsigned char* data, unsigned int le
     return CAIRO_STATUS_SUCCESS;
 }
 
+auto Image::cairoWriteFunction(Image* image, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    image->data.append(reinterpret_cast<const char*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
 void Image::setImage(string data) {
     if (this->image) {
         cairo_surface_destroy(this->image);
@@ -64,6 +69,7 @@ void Image::setImage(cairo_surface_t* image) {
     }
 
     this->image = image;
+    this->data.clear();
 }
 
 auto Image::getImage() -> cairo_surface_t* {
@@ -76,6 +82,28 @@ auto Image::getImage() -> cairo_surface_t* {
     return this->image;
 }
 
+auto Image::getPngData() -> const string& {
+    if (this->data.empty() && this->image) {
+        cairo_status_t status = cairo_surface_write_to_png_stream(
+                this->image, reinterpret_cast<cairo_write_func_t>(&cairoWriteFunction), this);
+        if (status != CAIRO_STATUS_SUCCESS) {
+            g_warning("Could not encode image: %s", cairo_status_to_string(status));
+            this->data.clear();
+        }
+    }
+
+    return this->data;
+}
+
+auto Image::getMemoryUsage() const -> size_t {
+    size_t usage = this->data.capacity();
+    if (this->image) {
+        usage += static_cast<size_t>(cairo_image_surface_get_stride(this->image)) *
+                 cairo_image_surface_get_height(this->image);
+    }
+    return usage;
+}
+
 void Image::scale(double x0, double y0, double fx, double fy) {
     this->x -= x0;
     this->x *= fx;
@@ -98,7 +126,8 @@ void Image::serialize(ObjectOutputStream& out) {
     out.writeDouble(this->width);
     out.writeDouble(this->height);
 
-    out.writeImage(this->image);
+    // Copying an image does not encode it again
+    out.writeImage(getPngData());
 
     out.endObject();
 }
@@ -111,12 +140,8 @@ void Image::readSerialized(ObjectInputStream& in) {
     this->width = in.readDouble();
     this->height = in.readDouble();
 
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
-    this->image = in.readImage();
+    // Decoded when it is drawn
+    setImage(in.readImage());
 
     in.endObject();
 }
@@ -31,6 +31,16 @@ public:
     void setImage(GdkPixbuf* img);
     cairo_surface_t* getImage();
 
+    /**
+     * @return The image as PNG, only encoded the first time if the image was not loaded from PNG
+     */
+    const string& getPngData();
+
+    /**
+     * @return The memory of the encoded and the decoded image in bytes
+     */
+    size_t getMemoryUsage() const;
+
     virtual void scale(double x0, double y0, double fx, double fy);
     virtual void rotate(double x0, double y0, double xo, double yo, double th);
 
@@ -48,10 +58,14 @@ private:
     virtual void calcSize();
 
     static cairo_status_t cairoReadFunction(Image* image, unsigned char* data, unsigned int length);
+    static cairo_status_t cairoWriteFunction(Image* image, const unsigned char* data, unsigned int length);
 
 private:
     cairo_surface_t* image = nullptr;
 
+    /**
+     * The image as PNG, empty if not encoded yet
+     */
     string data;
 
     string::size_type read = false;
@@ -1,7 +1,17 @@
 #include "Layer.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "Stacktrace.h"
 
+/**
+ * The index is rebuilt after EDITS_PER_SQRT * sqrt(n) edits, but not for every few edits of a small layer. Applying
+ * the edits is cheap compared to rebuilding, so more edits are kept.
+ */
+constexpr size_t MIN_EDITS = 32;
+constexpr double EDITS_PER_SQRT = 8;
+
 Layer::Layer() = default;
 
 Layer::~Layer() {
@@ -28,11 +38,11 @@ void Layer::addElement(Element* e) {
         return;
     }
 
-    for (Element* elem2: this->elements) {
-        if (e == elem2) {
-            g_warning("Layer::addElement: Element is already on this layer!");
-            return;
-        }
+    // Appending does not move any other element
+    auto pos = static_cast<ElementIndex>(this->elements.size());
+    if (!this->elementIndex.emplace(e, IndexEntry{pos, this->edits.size()}).second) {
+        g_warning("Layer::addElement: Element is already on this layer!");
+        return;
     }
 
     this->elements.push_back(e);
@@ -45,12 +55,10 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
         return;
     }
 
-    for (Element* elem2: this->elements) {
-        if (e == elem2) {
-            g_warning("Layer::insertElement() try to add an element twice!");
-            Stacktrace::printStracktrace();
-            return;
-        }
+    if (this->elementIndex.count(e)) {
+        g_warning("Layer::insertElement() try to add an element twice!");
+        Stacktrace::printStracktrace();
+        return;
     }
 
     // prevent crash, even if this never should happen,
@@ -60,38 +68,214 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
     }
 
     // If the element should be inserted at the top
-    if (pos >= static_cast<int>(this->elements.size())) {
+    if (pos >= static_cast<ElementIndex>(this->elements.size())) {
+        pos = this->elements.size();
         this->elements.push_back(e);
     } else {
         this->elements.insert(this->elements.begin() + pos, e);
+        addEdit(pos, 1);
+    }
+
+    this->elementIndex[e] = IndexEntry{pos, this->edits.size()};
+}
+
+void Layer::insertElements(const vector<std::pair<Element*, ElementIndex>>& elements) {
+    vector<std::pair<Element*, ElementIndex>> sorted;
+    sorted.reserve(elements.size());
+
+    for (auto [e, pos]: elements) {
+        if (e == nullptr) {
+            g_warning("insertElements(nullptr)!");
+            Stacktrace::printStracktrace();
+            continue;
+        }
+
+        // The position is set after the merge
+        if (!this->elementIndex.emplace(e, IndexEntry{0, 0}).second) {
+            g_warning("Layer::insertElements() try to add an element twice!");
+            Stacktrace::printStracktrace();
+            continue;
+        }
+
+        sorted.emplace_back(e, std::max(pos, static_cast<ElementIndex>(0)));
+    }
+
+    if (sorted.empty()) {
+        return;
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto& a, auto& b) { return a.second < b.second; });
+
+    vector<Element*> merged;
+    merged.reserve(this->elements.size() + sorted.size());
+
+    // The actual positions, ascending
+    vector<ElementIndex> positions;
+    positions.reserve(sorted.size());
+
+    auto old = this->elements.begin();
+    for (auto [e, pos]: sorted) {
+        while (static_cast<ElementIndex>(merged.size()) < pos && old != this->elements.end()) {
+            merged.push_back(*old++);
+        }
+        positions.push_back(merged.size());
+        merged.push_back(e);
+    }
+    merged.insert(merged.end(), old, this->elements.end());
+    this->elements.swap(merged);
+
+    if (!canAddEdits(positions.size())) {
+        rebuildIndex();
+        return;
+    }
+
+    // Inserting in ascending order of the final positions gives the same list
+    for (ElementIndex pos: positions) {
+        this->edits.push_back(Edit{pos, 1, this->shiftSum++});
+    }
+    for (size_t i = 0; i < sorted.size(); i++) {
+        this->elementIndex[sorted[i].first] = IndexEntry{positions[i], this->edits.size()};
     }
 }
 
 auto Layer::indexOf(Element* e) -> ElementIndex {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
-        if (this->elements[i] == e) {
-            return i;
+    auto it = this->elementIndex.find(e);
+    if (it == this->elementIndex.end()) {
+        return InvalidElementIndex;
+    }
+
+    IndexEntry& entry = it->second;
+
+    // Usually all edits since were in front of the element (e.g. removing in ascending order), or all behind it
+    ElementIndex shift = 0;
+    if (entry.edit < this->edits.size()) {
+        shift = this->shiftSum - this->edits[entry.edit].shiftBefore;
+    }
+    for (ElementIndex pos: {entry.pos + shift, entry.pos}) {
+        if (pos >= 0 && pos < static_cast<ElementIndex>(this->elements.size()) && this->elements[pos] == e) {
+            entry.pos = pos;
+            entry.edit = this->edits.size();
+            return pos;
         }
     }
 
-    return InvalidElementIndex;
+    ElementIndex pos = entry.pos;
+    for (size_t i = entry.edit; i < this->edits.size(); i++) {
+        const Edit& edit = this->edits[i];
+        // An insertion moves the element at its position, a removal only the elements behind it
+        if (edit.shift > 0 ? pos >= edit.pos : pos > edit.pos) {
+            pos += edit.shift;
+        }
+    }
+    entry.pos = pos;
+    entry.edit = this->edits.size();
+
+    if (pos >= static_cast<ElementIndex>(this->elements.size()) || this->elements[pos] != e) {
+        g_warning("Layer::indexOf: Element index is inconsistent!");
+        rebuildIndex();
+        pos = this->elementIndex[e].pos;
+        bool found = pos < static_cast<ElementIndex>(this->elements.size()) && this->elements[pos] == e;
+        return found ? pos : InvalidElementIndex;
+    }
+
+    return pos;
+}
+
+void Layer::addEdit(ElementIndex pos, int shift) {
+    if (canAddEdits(1)) {
+        this->edits.push_back(Edit{pos, shift, this->shiftSum});
+        this->shiftSum += shift;
+    } else {
+        rebuildIndex();
+    }
+}
+
+auto Layer::canAddEdits(size_t count) const -> bool {
+    auto maxEdits = std::max(MIN_EDITS, static_cast<size_t>(EDITS_PER_SQRT * std::sqrt(this->elements.size())));
+    return this->edits.size() + count <= maxEdits;
+}
+
+void Layer::rebuildIndex() {
+    this->edits.clear();
+    this->shiftSum = 0;
+    for (size_t i = 0; i < this->elements.size(); i++) {
+        this->elementIndex[this->elements[i]] = IndexEntry{static_cast<ElementIndex>(i), 0};
+    }
 }
 
 auto Layer::removeElement(Element* e, bool free) -> ElementIndex {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
-        if (e == this->elements[i]) {
-            this->elements.erase(this->elements.begin() + i);
+    ElementIndex pos = indexOf(e);
+    if (pos == InvalidElementIndex) {
+        g_warning("Could not remove element from layer, it's not on the layer!");
+        Stacktrace::printStracktrace();
+        return InvalidElementIndex;
+    }
+
+    this->elements.erase(this->elements.begin() + pos);
+    this->elementIndex.erase(e);
+    if (pos < static_cast<ElementIndex>(this->elements.size())) {
+        addEdit(pos, -1);
+    }
 
+    if (free) {
+        delete e;
+    }
+    return pos;
+}
+
+auto Layer::removeElements(const vector<Element*>& elements, bool free) -> vector<ElementIndex> {
+    vector<ElementIndex> positions;
+    positions.reserve(elements.size());
+
+    vector<bool> removed(this->elements.size(), false);
+    auto first = static_cast<ElementIndex>(this->elements.size());
+
+    for (Element* e: elements) {
+        ElementIndex pos = indexOf(e);
+        if (pos == InvalidElementIndex || removed[pos]) {
+            g_warning("Could not remove element from layer, it's not on the layer!");
+            Stacktrace::printStracktrace();
+            positions.push_back(InvalidElementIndex);
+            continue;
+        }
+
+        removed[pos] = true;
+        first = std::min(first, pos);
+        positions.push_back(pos);
+    }
+
+    // The removed positions, ascending
+    vector<ElementIndex> removedPositions;
+
+    size_t count = first;
+    for (size_t i = first; i < this->elements.size(); i++) {
+        if (removed[i]) {
+            removedPositions.push_back(i);
+        } else {
+            this->elements[count++] = this->elements[i];
+        }
+    }
+    this->elements.resize(count);
+
+    for (size_t i = 0; i < elements.size(); i++) {
+        if (positions[i] != InvalidElementIndex) {
+            this->elementIndex.erase(elements[i]);
             if (free) {
-                delete e;
+                delete elements[i];
             }
-            return i;
         }
     }
 
-    g_warning("Could not remove element from layer, it's not on the layer!");
-    Stacktrace::printStracktrace();
-    return InvalidElementIndex;
+    if (!canAddEdits(removedPositions.size())) {
+        rebuildIndex();
+    } else {
+        // Removing in descending order does not move the positions which are still to be removed
+        for (auto it = removedPositions.rbegin(); it != removedPositions.rend(); ++it) {
+            this->edits.push_back(Edit{*it, -1, this->shiftSum--});
+        }
+    }
+
+    return positions;
 }
 
 auto Layer::isAnnotated() -> bool { return !this->elements.empty(); }
@@ -12,12 +12,13 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Element.h"
 #include "XournalType.h"
 
-
 class Layer {
 public:
     Layer();
@@ -43,6 +44,9 @@ public:
 
     /**
      * Returns the index of the given Element with respect to the internal list
+     *
+     * @note O(1) until the Layer is modified. The stored position of an Element is moved by each insertion and removal
+     * since it was last looked up. The index is rebuilt after a multiple of sqrt(n) edits, so the lookup is O(sqrt(n)).
      */
     ElementIndex indexOf(Element* e);
 
@@ -51,8 +55,25 @@ public:
      */
     ElementIndex removeElement(Element* e, bool free);
 
+    /**
+     * Inserts the Element%s in one pass over the internal list. The positions are the indices of the Element%s after
+     * the insertion (e.g. returned by removeElements), the Element%s don't need to be sorted.
+     *
+     * @note Element%s which are already contained in the Layer are skipped
+     */
+    void insertElements(const vector<std::pair<Element*, ElementIndex>>& elements);
+
+    /**
+     * Removes the Element%s from the Layer in one pass over the internal list and optionally deletes them
+     *
+     * @return The indices of the Element%s before the removal, InvalidElementIndex for Element%s not on the Layer
+     */
+    vector<ElementIndex> removeElements(const vector<Element*>& elements, bool free);
+
     /**
      * Returns an iterator over the Element%s contained in this Layer
+     *
+     * @note The list must not be modified, use the methods of the Layer
      */
     vector<Element*>* getElements();
 
@@ -76,8 +97,53 @@ public:
      */
     Layer* clone();
 
+private:
+    /**
+     * The position of an Element after the first edit edits, the later ones still have to be applied
+     */
+    struct IndexEntry {
+        ElementIndex pos;
+        size_t edit;
+    };
+
+    /**
+     * An Element was inserted at pos (shift +1) or removed from it (shift -1)
+     */
+    struct Edit {
+        ElementIndex pos;
+        int shift;
+
+        /**
+         * The sum of the shifts of the edits before
+         */
+        ElementIndex shiftBefore;
+    };
+
+    /**
+     * Records an edit of the list, or rebuilds the index if there are too many edits
+     */
+    void addEdit(ElementIndex pos, int shift);
+
+    /**
+     * @return true if count more edits can be recorded before the index has to be rebuilt
+     */
+    bool canAddEdits(size_t count) const;
+
+    void rebuildIndex();
+
 private:
     vector<Element*> elements;
 
+    /**
+     * Contains every Element of the layer, the positions are moved lazily by the edits since they were stored
+     */
+    std::unordered_map<Element*, IndexEntry> elementIndex;
+
+    /**
+     * The insertions and removals since the index was rebuilt, in order
+     */
+    vector<Edit> edits;
+    ElementIndex shiftSum = 0;
+
     bool visible = true;
 };
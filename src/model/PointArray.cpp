@@ -0,0 +1,113 @@
+#include "PointArray.h"
+
+PointArray::PointArray(ElementArena* arena): x(arena), y(arena), pressure(arena) {}
+
+auto PointArray::getArena() const -> ElementArena* {
+    // Points added after the arena was released are on the heap
+    ElementArena* arena = this->x.get_allocator().getArena();
+    return (arena && !this->x.empty() && arena->owns(this->x.data())) ? arena : nullptr;
+}
+
+auto PointArray::getPressureData() const -> const Coordinate* {
+    return this->pressure.empty() ? nullptr : this->pressure.data();
+}
+
+auto PointArray::getPressureData() -> Coordinate* { return this->pressure.empty() ? nullptr : this->pressure.data(); }
+
+void PointArray::push_back(const Point& p) {
+    this->x.push_back(p.x);
+    this->y.push_back(p.y);
+
+    if (!this->pressure.empty()) {
+        this->pressure.push_back(p.z);
+    } else if (p.z != Point::NO_PRESSURE) {
+        // The first point with pressure, the points before have none
+        this->pressure.reserve(this->x.capacity());
+        this->pressure.resize(this->x.size() - 1, Point::NO_PRESSURE);
+        this->pressure.push_back(p.z);
+    }
+}
+
+void PointArray::set(size_t index, const Point& p) {
+    setPosition(index, p.x, p.y);
+    setPressure(index, p.z);
+}
+
+void PointArray::setPosition(size_t index, double x, double y) {
+    this->x[index] = x;
+    this->y[index] = y;
+}
+
+void PointArray::setPressure(size_t index, double pressure) {
+    if (this->pressure.empty()) {
+        if (pressure == Point::NO_PRESSURE) {
+            return;
+        }
+        this->pressure.resize(this->x.size(), Point::NO_PRESSURE);
+    }
+
+    this->pressure[index] = pressure;
+}
+
+void PointArray::assign(const Point* points, size_t count) {
+    clear();
+    append(points, count);
+}
+
+void PointArray::append(const Point* points, size_t count) {
+    reserve(size() + count);
+    for (size_t i = 0; i < count; i++) {
+        push_back(points[i]);
+    }
+}
+
+void PointArray::erase(size_t index) {
+    this->x.erase(this->x.begin() + index);
+    this->y.erase(this->y.begin() + index);
+    if (!this->pressure.empty()) {
+        this->pressure.erase(this->pressure.begin() + index);
+    }
+}
+
+void PointArray::resize(size_t count) {
+    this->x.resize(count);
+    this->y.resize(count);
+    if (!this->pressure.empty()) {
+        this->pressure.resize(count, Point::NO_PRESSURE);
+    }
+}
+
+void PointArray::reserve(size_t count) {
+    this->x.reserve(count);
+    this->y.reserve(count);
+}
+
+void PointArray::clear() {
+    this->x.clear();
+    this->y.clear();
+    this->pressure.clear();
+}
+
+void PointArray::shrink_to_fit() {
+    this->x.shrink_to_fit();
+    this->y.shrink_to_fit();
+    this->pressure.shrink_to_fit();
+}
+
+void PointArray::clearPressure() {
+    this->pressure.clear();
+    this->pressure.shrink_to_fit();
+}
+
+auto PointArray::toVector() const -> std::vector<Point> {
+    std::vector<Point> points;
+    points.reserve(size());
+    for (size_t i = 0; i < size(); i++) {
+        points.push_back((*this)[i]);
+    }
+    return points;
+}
+
+auto PointArray::getMemoryUsage() const -> size_t {
+    return (this->x.capacity() + this->y.capacity() + this->pressure.capacity()) * sizeof(Coordinate);
+}
@@ -0,0 +1,145 @@
+/*
+ * Xournal++
+ *
+ * The points of a stroke
+ *
+ * The coordinates are stored in separate x and y arrays, the pressure only
+ * if a point has a pressure. With ENABLE_FLOAT_COORDINATES the values are
+ * stored as float instead of double.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <config-features.h>
+
+#include "ElementArena.h"
+#include "Point.h"
+
+#ifdef ENABLE_FLOAT_COORDINATES
+using Coordinate = float;
+#else
+using Coordinate = double;
+#endif
+
+class PointArray {
+public:
+    /**
+     * Iterates the points by value
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Point;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Point*;
+        using reference = Point;
+
+        const_iterator(const PointArray* array, size_t index): array(array), index(index) {}
+
+        Point operator*() const { return (*array)[index]; }
+
+        const_iterator& operator++() {
+            index++;
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const PointArray* array;
+        size_t index;
+    };
+
+public:
+    /**
+     * @param arena The points are allocated from the arena of the stroke, heap if nullptr
+     */
+    explicit PointArray(ElementArena* arena = nullptr);
+
+public:
+    size_t size() const { return this->x.size(); }
+    bool empty() const { return this->x.empty(); }
+
+    double getX(size_t index) const { return this->x[index]; }
+    double getY(size_t index) const { return this->y[index]; }
+
+    /**
+     * @return The pressure, Point::NO_PRESSURE if the point has none
+     */
+    double getPressure(size_t index) const {
+        return this->pressure.empty() ? Point::NO_PRESSURE : static_cast<double>(this->pressure[index]);
+    }
+
+    Point operator[](size_t index) const { return Point(getX(index), getY(index), getPressure(index)); }
+    Point front() const { return (*this)[0]; }
+    Point back() const { return (*this)[size() - 1]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    const Coordinate* getXData() const { return this->x.data(); }
+    const Coordinate* getYData() const { return this->y.data(); }
+    Coordinate* getXData() { return this->x.data(); }
+    Coordinate* getYData() { return this->y.data(); }
+
+    /**
+     * @return The pressure values, nullptr if no point has a pressure
+     */
+    const Coordinate* getPressureData() const;
+    Coordinate* getPressureData();
+
+public:
+    void push_back(const Point& p);
+    void set(size_t index, const Point& p);
+    void setPosition(size_t index, double x, double y);
+    void setPressure(size_t index, double pressure);
+
+    void assign(const Point* points, size_t count);
+    void append(const Point* points, size_t count);
+    void erase(size_t index);
+    void resize(size_t count);
+    void reserve(size_t count);
+    void clear();
+    void shrink_to_fit();
+
+    /**
+     * Remove the pressure of all points
+     */
+    void clearPressure();
+
+    /**
+     * Copy the points, for code which needs a Point array
+     */
+    std::vector<Point> toVector() const;
+
+    /**
+     * @return The allocated memory in bytes
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @return The arena the points are stored in, nullptr if they are on the heap
+     */
+    ElementArena* getArena() const;
+
+private:
+    using CoordinateVector = std::vector<Coordinate, ArenaAllocator<Coordinate>>;
+
+    CoordinateVector x;
+    CoordinateVector y;
+
+    /**
+     * Either empty, or one value per point (Point::NO_PRESSURE for points without pressure)
+     */
+    CoordinateVector pressure;
+};
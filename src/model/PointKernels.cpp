@@ -0,0 +1,405 @@
+#include "PointKernels.h"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define POINT_KERNELS_X86
+#include <immintrin.h>
+
+// The functions are compiled for the instruction set, independent of the compiler flags,
+// and only called if the CPU supports it
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace PointKernels {
+
+static auto calcBoundsScalar(const Coordinate* x, const Coordinate* y, const Coordinate* pressure, size_t count,
+                             double halfWidth) -> Bounds {
+    Bounds bounds{x[0], y[0], x[0], y[0]};
+
+    for (size_t i = 0; i < count; i++) {
+        double px = x[i];
+        double py = y[i];
+        double halfThick = pressure ? pressure[i] / 2.0 : halfWidth;
+
+        bounds.minX = std::min(bounds.minX, px - halfThick);
+        bounds.minY = std::min(bounds.minY, py - halfThick);
+        bounds.maxX = std::max(bounds.maxX, px + halfThick);
+        bounds.maxY = std::max(bounds.maxY, py + halfThick);
+    }
+
+    return bounds;
+}
+
+static void transformScalar(Coordinate* x, Coordinate* y, size_t count, const Transformation& t) {
+    for (size_t i = 0; i < count; i++) {
+        double dx = x[i] - t.originX;
+        double dy = y[i] - t.originY;
+
+        x[i] = t.xx * dx + t.xy * dy + t.translateX;
+        y[i] = t.yx * dx + t.yy * dy + t.translateY;
+    }
+}
+
+static auto findEraserCandidateScalar(const Coordinate* x, const Coordinate* y, size_t begin, size_t end, double x1,
+                                      double y1, double x2, double y2, double minSegmentLength) -> size_t {
+    double minLengthSquared = minSegmentLength * minSegmentLength;
+
+    size_t start = begin > 0 ? begin - 1 : 0;
+    double lastX = x[start];
+    double lastY = y[start];
+    for (size_t i = begin; i < end; i++) {
+        double px = x[i];
+        double py = y[i];
+
+        if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
+            return i;
+        }
+
+        double dx = px - lastX;
+        double dy = py - lastY;
+        if (dx * dx + dy * dy >= minLengthSquared) {
+            return i;
+        }
+
+        lastX = px;
+        lastY = py;
+    }
+
+    return end;
+}
+
+#ifdef POINT_KERNELS_X86
+
+/*
+ * SSE2: two coordinates per vector. Float coordinates are converted to double on load,
+ * and rounded back on store, like the scalar version does.
+ */
+
+TARGET_SSE2 static inline auto load2(const double* p) -> __m128d { return _mm_loadu_pd(p); }
+
+TARGET_SSE2 static inline auto load2(const float* p) -> __m128d {
+    return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+TARGET_SSE2 static inline void store2(double* p, __m128d v) { _mm_storeu_pd(p, v); }
+
+TARGET_SSE2 static inline void store2(float* p, __m128d v) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_castps_si128(_mm_cvtpd_ps(v)));
+}
+
+TARGET_SSE2 static auto calcBoundsSse2(const Coordinate* x, const Coordinate* y, const Coordinate* pressure,
+                                       size_t count, double halfWidth) -> Bounds {
+    __m128d half = _mm_set1_pd(halfWidth);
+    __m128d two = _mm_set1_pd(2.0);
+
+    __m128d minX = _mm_set1_pd(x[0]);
+    __m128d maxX = minX;
+    __m128d minY = _mm_set1_pd(y[0]);
+    __m128d maxY = minY;
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d px = load2(x + i);
+        __m128d py = load2(y + i);
+        __m128d h = pressure ? _mm_div_pd(load2(pressure + i), two) : half;
+
+        minX = _mm_min_pd(minX, _mm_sub_pd(px, h));
+        maxX = _mm_max_pd(maxX, _mm_add_pd(px, h));
+        minY = _mm_min_pd(minY, _mm_sub_pd(py, h));
+        maxY = _mm_max_pd(maxY, _mm_add_pd(py, h));
+    }
+
+    double lanes[2];
+    Bounds bounds;
+    _mm_storeu_pd(lanes, minX);
+    bounds.minX = std::min(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, minY);
+    bounds.minY = std::min(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, maxX);
+    bounds.maxX = std::max(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, maxY);
+    bounds.maxY = std::max(lanes[0], lanes[1]);
+
+    if (i < count) {
+        Bounds rest = calcBoundsScalar(x + i, y + i, pressure ? pressure + i : nullptr, count - i, halfWidth);
+        bounds.minX = std::min(bounds.minX, rest.minX);
+        bounds.minY = std::min(bounds.minY, rest.minY);
+        bounds.maxX = std::max(bounds.maxX, rest.maxX);
+        bounds.maxY = std::max(bounds.maxY, rest.maxY);
+    }
+
+    return bounds;
+}
+
+TARGET_SSE2 static void transformSse2(Coordinate* x, Coordinate* y, size_t count, const Transformation& t) {
+    __m128d originX = _mm_set1_pd(t.originX);
+    __m128d originY = _mm_set1_pd(t.originY);
+    __m128d xx = _mm_set1_pd(t.xx);
+    __m128d xy = _mm_set1_pd(t.xy);
+    __m128d yx = _mm_set1_pd(t.yx);
+    __m128d yy = _mm_set1_pd(t.yy);
+    __m128d translateX = _mm_set1_pd(t.translateX);
+    __m128d translateY = _mm_set1_pd(t.translateY);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d dx = _mm_sub_pd(load2(x + i), originX);
+        __m128d dy = _mm_sub_pd(load2(y + i), originY);
+
+        store2(x + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(xx, dx), _mm_mul_pd(xy, dy)), translateX));
+        store2(y + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(yx, dx), _mm_mul_pd(yy, dy)), translateY));
+    }
+
+    transformScalar(x + i, y + i, count - i, t);
+}
+
+TARGET_SSE2 static auto findEraserCandidateSse2(const Coordinate* x, const Coordinate* y, size_t begin, size_t end,
+                                                double x1, double y1, double x2, double y2, double minSegmentLength)
+        -> size_t {
+    // Point 0 has no previous point to load
+    if (begin == 0 && end > 0) {
+        if (findEraserCandidateScalar(x, y, 0, 1, x1, y1, x2, y2, minSegmentLength) == 0) {
+            return 0;
+        }
+        begin = 1;
+    }
+
+    __m128d vx1 = _mm_set1_pd(x1);
+    __m128d vy1 = _mm_set1_pd(y1);
+    __m128d vx2 = _mm_set1_pd(x2);
+    __m128d vy2 = _mm_set1_pd(y2);
+    __m128d minLengthSquared = _mm_set1_pd(minSegmentLength * minSegmentLength);
+
+    size_t i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d px = load2(x + i);
+        __m128d py = load2(y + i);
+
+        __m128d inside = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(px, vx1), _mm_cmple_pd(px, vx2)),
+                                    _mm_and_pd(_mm_cmpge_pd(py, vy1), _mm_cmple_pd(py, vy2)));
+
+        __m128d dx = _mm_sub_pd(px, load2(x + i - 1));
+        __m128d dy = _mm_sub_pd(py, load2(y + i - 1));
+        __m128d length = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        __m128d longSegment = _mm_cmpge_pd(length, minLengthSquared);
+
+        int mask = _mm_movemask_pd(_mm_or_pd(inside, longSegment));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return findEraserCandidateScalar(x, y, i, end, x1, y1, x2, y2, minSegmentLength);
+}
+
+/*
+ * AVX2: four coordinates per vector
+ */
+
+TARGET_AVX2 static inline auto load4(const double* p) -> __m256d { return _mm256_loadu_pd(p); }
+
+TARGET_AVX2 static inline auto load4(const float* p) -> __m256d { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+
+TARGET_AVX2 static inline void store4(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+
+TARGET_AVX2 static inline void store4(float* p, __m256d v) { _mm_storeu_ps(p, _mm256_cvtpd_ps(v)); }
+
+TARGET_AVX2 static inline auto horizontalMin(__m256d v) -> double {
+    __m128d m = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    double lanes[2];
+    _mm_storeu_pd(lanes, m);
+    return std::min(lanes[0], lanes[1]);
+}
+
+TARGET_AVX2 static inline auto horizontalMax(__m256d v) -> double {
+    __m128d m = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    double lanes[2];
+    _mm_storeu_pd(lanes, m);
+    return std::max(lanes[0], lanes[1]);
+}
+
+TARGET_AVX2 static auto calcBoundsAvx2(const Coordinate* x, const Coordinate* y, const Coordinate* pressure,
+                                       size_t count, double halfWidth) -> Bounds {
+    __m256d half = _mm256_set1_pd(halfWidth);
+    __m256d two = _mm256_set1_pd(2.0);
+
+    __m256d minX = _mm256_set1_pd(x[0]);
+    __m256d maxX = minX;
+    __m256d minY = _mm256_set1_pd(y[0]);
+    __m256d maxY = minY;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d px = load4(x + i);
+        __m256d py = load4(y + i);
+        __m256d h = pressure ? _mm256_div_pd(load4(pressure + i), two) : half;
+
+        minX = _mm256_min_pd(minX, _mm256_sub_pd(px, h));
+        maxX = _mm256_max_pd(maxX, _mm256_add_pd(px, h));
+        minY = _mm256_min_pd(minY, _mm256_sub_pd(py, h));
+        maxY = _mm256_max_pd(maxY, _mm256_add_pd(py, h));
+    }
+
+    Bounds bounds{horizontalMin(minX), horizontalMin(minY), horizontalMax(maxX), horizontalMax(maxY)};
+
+    if (i < count) {
+        Bounds rest = calcBoundsScalar(x + i, y + i, pressure ? pressure + i : nullptr, count - i, halfWidth);
+        bounds.minX = std::min(bounds.minX, rest.minX);
+        bounds.minY = std::min(bounds.minY, rest.minY);
+        bounds.maxX = std::max(bounds.maxX, rest.maxX);
+        bounds.maxY = std::max(bounds.maxY, rest.maxY);
+    }
+
+    return bounds;
+}
+
+TARGET_AVX2 static void transformAvx2(Coordinate* x, Coordinate* y, size_t count, const Transformation& t) {
+    __m256d originX = _mm256_set1_pd(t.originX);
+    __m256d originY = _mm256_set1_pd(t.originY);
+    __m256d xx = _mm256_set1_pd(t.xx);
+    __m256d xy = _mm256_set1_pd(t.xy);
+    __m256d yx = _mm256_set1_pd(t.yx);
+    __m256d yy = _mm256_set1_pd(t.yy);
+    __m256d translateX = _mm256_set1_pd(t.translateX);
+    __m256d translateY = _mm256_set1_pd(t.translateY);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d dx = _mm256_sub_pd(load4(x + i), originX);
+        __m256d dy = _mm256_sub_pd(load4(y + i), originY);
+
+        store4(x + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(xx, dx), _mm256_mul_pd(xy, dy)), translateX));
+        store4(y + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(yx, dx), _mm256_mul_pd(yy, dy)), translateY));
+    }
+
+    transformScalar(x + i, y + i, count - i, t);
+}
+
+TARGET_AVX2 static auto findEraserCandidateAvx2(const Coordinate* x, const Coordinate* y, size_t begin, size_t end,
+                                                double x1, double y1, double x2, double y2, double minSegmentLength)
+        -> size_t {
+    // Point 0 has no previous point to load
+    if (begin == 0 && end > 0) {
+        if (findEraserCandidateScalar(x, y, 0, 1, x1, y1, x2, y2, minSegmentLength) == 0) {
+            return 0;
+        }
+        begin = 1;
+    }
+
+    __m256d vx1 = _mm256_set1_pd(x1);
+    __m256d vy1 = _mm256_set1_pd(y1);
+    __m256d vx2 = _mm256_set1_pd(x2);
+    __m256d vy2 = _mm256_set1_pd(y2);
+    __m256d minLengthSquared = _mm256_set1_pd(minSegmentLength * minSegmentLength);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d px = load4(x + i);
+        __m256d py = load4(y + i);
+
+        __m256d insideX = _mm256_and_pd(_mm256_cmp_pd(px, vx1, _CMP_GE_OQ), _mm256_cmp_pd(px, vx2, _CMP_LE_OQ));
+        __m256d insideY = _mm256_and_pd(_mm256_cmp_pd(py, vy1, _CMP_GE_OQ), _mm256_cmp_pd(py, vy2, _CMP_LE_OQ));
+        __m256d inside = _mm256_and_pd(insideX, insideY);
+
+        __m256d dx = _mm256_sub_pd(px, load4(x + i - 1));
+        __m256d dy = _mm256_sub_pd(py, load4(y + i - 1));
+        __m256d length = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        __m256d longSegment = _mm256_cmp_pd(length, minLengthSquared, _CMP_GE_OQ);
+
+        int mask = _mm256_movemask_pd(_mm256_or_pd(inside, longSegment));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return findEraserCandidateScalar(x, y, i, end, x1, y1, x2, y2, minSegmentLength);
+}
+
+#endif  // POINT_KERNELS_X86
+
+class Kernels {
+public:
+    Bounds (*calcBounds)(const Coordinate* x, const Coordinate* y, const Coordinate* pressure, size_t count,
+                         double halfWidth);
+    void (*transform)(Coordinate* x, Coordinate* y, size_t count, const Transformation& t);
+    size_t (*findEraserCandidate)(const Coordinate* x, const Coordinate* y, size_t begin, size_t end, double x1,
+                                  double y1, double x2, double y2, double minSegmentLength);
+};
+
+static const Kernels scalarKernels = {calcBoundsScalar, transformScalar, findEraserCandidateScalar};
+
+#ifdef POINT_KERNELS_X86
+static const Kernels sse2Kernels = {calcBoundsSse2, transformSse2, findEraserCandidateSse2};
+static const Kernels avx2Kernels = {calcBoundsAvx2, transformAvx2, findEraserCandidateAvx2};
+#endif
+
+class KernelSelection {
+public:
+    KernelSelection() { select(getSupportedInstructionSet()); }
+
+    void select(InstructionSet set) {
+        this->set = std::min(set, getSupportedInstructionSet());
+
+        switch (this->set) {
+#ifdef POINT_KERNELS_X86
+            case INSTRUCTION_SET_AVX2:
+                this->kernels = &avx2Kernels;
+                break;
+            case INSTRUCTION_SET_SSE2:
+                this->kernels = &sse2Kernels;
+                break;
+#endif
+            default:
+                this->kernels = &scalarKernels;
+                break;
+        }
+    }
+
+    InstructionSet set = INSTRUCTION_SET_SCALAR;
+    const Kernels* kernels = &scalarKernels;
+};
+
+static auto getSelection() -> KernelSelection& {
+    static KernelSelection selection;
+    return selection;
+}
+
+auto getSupportedInstructionSet() -> InstructionSet {
+#ifdef POINT_KERNELS_X86
+    static InstructionSet supported = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return INSTRUCTION_SET_AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return INSTRUCTION_SET_SSE2;
+        }
+        return INSTRUCTION_SET_SCALAR;
+    }();
+    return supported;
+#else
+    return INSTRUCTION_SET_SCALAR;
+#endif
+}
+
+auto getInstructionSet() -> InstructionSet { return getSelection().set; }
+
+void setInstructionSet(InstructionSet set) { getSelection().select(set); }
+
+auto calcBounds(const Coordinate* x, const Coordinate* y, const Coordinate* pressure, size_t count, double halfWidth)
+        -> Bounds {
+    return getSelection().kernels->calcBounds(x, y, pressure, count, halfWidth);
+}
+
+void transform(Coordinate* x, Coordinate* y, size_t count, const Transformation& t) {
+    getSelection().kernels->transform(x, y, count, t);
+}
+
+auto findEraserCandidate(const Coordinate* x, const Coordinate* y, size_t begin, size_t end, double x1, double y1,
+                         double x2, double y2, double minSegmentLength) -> size_t {
+    return getSelection().kernels->findEraserCandidate(x, y, begin, end, x1, y1, x2, y2, minSegmentLength);
+}
+
+}  // namespace PointKernels
@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * Vectorized loops over the points of a stroke
+ *
+ * Every kernel has a scalar version and SSE2 / AVX2 versions on x86, the
+ * best one supported by the CPU is selected at runtime. All versions return
+ * exactly the same results, the calculations are done in double precision
+ * for both coordinate types.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "PointArray.h"
+
+namespace PointKernels {
+
+enum InstructionSet { INSTRUCTION_SET_SCALAR, INSTRUCTION_SET_SSE2, INSTRUCTION_SET_AVX2 };
+
+/**
+ * The best instruction set supported by this CPU (and compiler)
+ */
+InstructionSet getSupportedInstructionSet();
+
+/**
+ * The instruction set currently used by the kernels
+ */
+InstructionSet getInstructionSet();
+
+/**
+ * Select the kernels, e.g. to compare them in tests. If the set is not supported the best supported set is used.
+ * Not thread safe, has to be called while no kernel is running.
+ */
+void setInstructionSet(InstructionSet set);
+
+/**
+ * Bounding box of the points
+ */
+class Bounds {
+public:
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+};
+
+/**
+ * An affine transformation relative to an origin:
+ *
+ * x' = xx * (x - originX) + xy * (y - originY) + translateX
+ * y' = yx * (x - originX) + yy * (y - originY) + translateY
+ */
+class Transformation {
+public:
+    double xx = 1;
+    double yx = 0;
+    double xy = 0;
+    double yy = 1;
+
+    double originX = 0;
+    double originY = 0;
+
+    double translateX = 0;
+    double translateY = 0;
+};
+
+/**
+ * Bounds of the points, each point is extended by half of its pressure, or by halfWidth if pressure is nullptr.
+ * The result is undefined if count is 0.
+ */
+Bounds calcBounds(const Coordinate* x, const Coordinate* y, const Coordinate* pressure, size_t count,
+                  double halfWidth);
+
+/**
+ * Transform the coordinates of the points
+ */
+void transform(Coordinate* x, Coordinate* y, size_t count, const Transformation& t);
+
+/**
+ * Find the first point in [begin, end) which is in the rectangle (x1, y1) - (x2, y2), or which is the end of a
+ * segment (i - 1, i) with a length of at least minSegmentLength. Point 0 has no segment.
+ *
+ * @return The index of the point, end if there is none
+ */
+size_t findEraserCandidate(const Coordinate* x, const Coordinate* y, size_t begin, size_t end, double x1, double y1,
+                           double x2, double y2, double minSegmentLength);
+
+}  // namespace PointKernels
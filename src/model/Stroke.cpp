@@ -1,15 +1,22 @@
 #include "Stroke.h"
 
 #include <cmath>
-#include <numeric>
 
 #include "serializing/ObjectInputStream.h"
 #include "serializing/ObjectOutputStream.h"
 
+#include "PointKernels.h"
 #include "i18n.h"
 
+/**
+ * Strokes with less points are tested without the segment tree
+ */
+constexpr size_t SEGMENT_TREE_MIN_POINTS = 64;
+
 Stroke::Stroke(): AudioElement(ELEMENT_STROKE) {}
 
+Stroke::Stroke(ElementArena* arena): AudioElement(ELEMENT_STROKE), points(arena) {}
+
 Stroke::~Stroke() = default;
 
 /**
@@ -29,6 +36,7 @@ auto Stroke::cloneStroke() const -> Stroke* {
     auto* s = new Stroke();
     s->applyStyleFrom(this);
     s->points = this->points;
+    s->segmentTree = std::atomic_load(&this->segmentTree);
     return s;
 }
 
@@ -45,7 +53,8 @@ void Stroke::serialize(ObjectOutputStream& out) {
 
     out.writeInt(fill);
 
-    out.writeData(this->points.data(), this->points.size(), sizeof(Point));
+    std::vector<Point> points = this->points.toVector();
+    out.writeData(points.data(), points.size(), sizeof(Point));
 
     this->lineStyle.serialize(out);
 
@@ -66,8 +75,9 @@ void Stroke::readSerialized(ObjectInputStream& in) {
     Point* p{};
     int count{};
     in.readData(reinterpret_cast<void**>(&p), &count);
-    this->points = std::vector<Point>{p, p + count};
+    this->points.assign(p, count);
     g_free(p);
+    pointsChanged();
     this->lineStyle.readSerialized(in);
 
     in.endObject();
@@ -96,11 +106,12 @@ void Stroke::setWidth(double width) { this->width = width; }
 auto Stroke::getWidth() const -> double { return this->width; }
 
 auto Stroke::isInSelection(ShapeContainer* container) -> bool {
-    for (auto&& p: this->points) {
-        double px = p.x;
-        double py = p.y;
+    if (std::shared_ptr<const StrokeSegmentTree> tree = getSegmentTree()) {
+        return tree->isInSelection(this->points, container);
+    }
 
-        if (!container->contains(px, py)) {
+    for (size_t i = 0; i < this->points.size(); i++) {
+        if (!container->contains(this->points.getX(i), this->points.getY(i))) {
             return false;
         }
     }
@@ -110,10 +121,9 @@ auto Stroke::isInSelection(ShapeContainer* container) -> bool {
 
 void Stroke::setFirstPoint(double x, double y) {
     if (!this->points.empty()) {
-        Point& p = this->points.front();
-        p.x = x;
-        p.y = y;
+        this->points.setPosition(0, x, y);
         this->sizeCalculated = false;
+        pointsChanged();
     }
 }
 
@@ -121,35 +131,49 @@ void Stroke::setLastPoint(double x, double y) { setLastPoint({x, y}); }
 
 void Stroke::setLastPoint(const Point& p) {
     if (!this->points.empty()) {
-        this->points.back() = p;
+        this->points.set(this->points.size() - 1, p);
         this->sizeCalculated = false;
+        pointsChanged();
     }
 }
 
 void Stroke::addPoint(const Point& p) {
-    this->points.emplace_back(p);
+    this->points.push_back(p);
     this->sizeCalculated = false;
+    pointsChanged();
+}
+
+void Stroke::addPoints(const vector<Point>& points) {
+    this->points.append(points.data(), points.size());
+    this->sizeCalculated = false;
+    pointsChanged();
 }
 
 auto Stroke::getPointCount() const -> int { return this->points.size(); }
 
-auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
+auto Stroke::getPointVector() const -> std::vector<Point> { return this->points.toVector(); }
+
+auto Stroke::getPointArray() const -> const PointArray& { return this->points; }
 
-void Stroke::deletePointsFrom(int index) { points.resize(std::min(size_t(index), points.size())); }
+void Stroke::deletePointsFrom(int index) {
+    points.resize(std::min(size_t(index), points.size()));
+    pointsChanged();
+}
 
-void Stroke::deletePoint(int index) { this->points.erase(std::next(begin(this->points), index)); }
+void Stroke::deletePoint(int index) {
+    this->points.erase(index);
+    pointsChanged();
+}
 
 auto Stroke::getPoint(int index) const -> Point {
     if (index < 0 || index >= this->points.size()) {
         g_warning("Stroke::getPoint(%i) out of bounds!", index);
         return Point(0, 0, Point::NO_PRESSURE);
     }
-    return points.at(index);
+    return this->points[index];
 }
 
-auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
-
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+void Stroke::freeUnusedPointItems() { this->points.shrink_to_fit(); }
 
 void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
 
@@ -160,89 +184,88 @@ void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
-        point.x += dx;
-        point.y += dy;
-    }
+    PointKernels::Transformation t;
+    t.translateX = dx;
+    t.translateY = dy;
+    PointKernels::transform(this->points.getXData(), this->points.getYData(), this->points.size(), t);
 
     this->sizeCalculated = false;
+    pointsChanged();
 }
 
 void Stroke::rotate(double x0, double y0, double xo, double yo, double th) {
-    for (auto&& p: points) {
-        p.x -= x0;  // move to origin
-        p.y -= y0;
-        double offset = 0.7;  // __DBL_EPSILON__;
-        p.x -= xo - offset;   // center to origin
-        p.y -= yo - offset;
-
-        double x1 = p.x * cos(th) - p.y * sin(th);
-        double y1 = p.y * cos(th) + p.x * sin(th);
-        p.x = x1;
-        p.y = y1;
-
-        p.x += x0;  // restore the position
-        p.y += y0;
-
-        p.x += xo - offset;  // center it
-        p.y += yo - offset;
-    }
+    double offset = 0.7;  // __DBL_EPSILON__;
+
+    // Rotate around the center
+    PointKernels::Transformation t;
+    t.xx = cos(th);
+    t.xy = -sin(th);
+    t.yx = sin(th);
+    t.yy = cos(th);
+    t.originX = t.translateX = x0 + xo - offset;
+    t.originY = t.translateY = y0 + yo - offset;
+    PointKernels::transform(this->points.getXData(), this->points.getYData(), this->points.size(), t);
+
     // Width and Height will likely be changed after this operation
     calcSize();
+    pointsChanged();
 }
 
 void Stroke::scale(double x0, double y0, double fx, double fy) {
     double fz = sqrt(fx * fy);
 
-    for (auto&& p: points) {
-        p.x -= x0;
-        p.x *= fx;
-        p.x += x0;
-
-        p.y -= y0;
-        p.y *= fy;
-        p.y += y0;
-
-        if (p.z != Point::NO_PRESSURE) {
-            p.z *= fz;
+    PointKernels::Transformation t;
+    t.xx = fx;
+    t.yy = fy;
+    t.originX = t.translateX = x0;
+    t.originY = t.translateY = y0;
+    PointKernels::transform(this->points.getXData(), this->points.getYData(), this->points.size(), t);
+
+    if (Coordinate* pressure = this->points.getPressureData()) {
+        for (size_t i = 0; i < this->points.size(); i++) {
+            if (pressure[i] != Point::NO_PRESSURE) {
+                pressure[i] *= fz;
+            }
         }
     }
     this->width *= fz;
 
     this->sizeCalculated = false;
+    pointsChanged();
 }
 
 auto Stroke::hasPressure() const -> bool {
     if (!this->points.empty()) {
-        return this->points[0].z != Point::NO_PRESSURE;
+        return this->points.getPressure(0) != Point::NO_PRESSURE;
     }
     return false;
 }
 
 auto Stroke::getAvgPressure() const -> double {
-    return std::accumulate(begin(this->points), end(this->points), 0.0,
-                           [](double l, Point const& p) { return l + p.z; }) /
-           this->points.size();
+    double sum = 0;
+    for (size_t i = 0; i < this->points.size(); i++) {
+        sum += this->points.getPressure(i);
+    }
+    return sum / this->points.size();
 }
 
 void Stroke::scalePressure(double factor) {
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) {
-        p.z *= factor;
+    Coordinate* pressure = this->points.getPressureData();
+    for (size_t i = 0; i < this->points.size(); i++) {
+        pressure[i] *= factor;
     }
 }
 
 void Stroke::clearPressure() {
-    for (auto&& p: points) {
-        p.z = Point::NO_PRESSURE;
-    }
+    this->points.clearPressure();
 }
 
 void Stroke::setLastPressure(double pressure) {
     if (!this->points.empty()) {
-        this->points.back().z = pressure;
+        this->points.setPressure(this->points.size() - 1, pressure);
     }
 }
 
@@ -255,7 +278,7 @@ void Stroke::setPressure(const vector<double>& pressure) {
 
     auto max_size = std::min(pressure.size(), this->points.size() - 1);
     for (size_t i = 0U; i != max_size; ++i) {
-        this->points[i].z = pressure[i];
+        this->points.setPressure(i, pressure[i]);
     }
 }
 
@@ -274,16 +297,49 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
         return false;
     }
 
+    std::shared_ptr<const StrokeSegmentTree> tree = getSegmentTree();
+    if (tree == nullptr) {
+        return intersectsRange(x, y, halfEraserSize, gap, 0, this->points.size());
+    }
+
+    // A segment may be hit up to its length plus this distance away, see intersectsRange
+    double distance = 2 * std::hypot(halfEraserSize, halfEraserSize) + 0.2;
+
+    vector<StrokeSegmentTree::IndexRange> ranges;
+    tree->findNear(x, y, distance, ranges);
+
+    // The ranges are ordered, so the first hit is the same as if all points are tested
+    for (const StrokeSegmentTree::IndexRange& range: ranges) {
+        if (intersectsRange(x, y, halfEraserSize, gap, range.first, range.second)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto Stroke::intersectsRange(double x, double y, double halfEraserSize, double* gap, size_t begin, size_t end) const
+        -> bool {
     double x1 = x - halfEraserSize;
     double x2 = x + halfEraserSize;
     double y1 = y - halfEraserSize;
     double y2 = y + halfEraserSize;
 
-    double lastX = points[0].x;
-    double lastY = points[0].y;
-    for (auto&& point: points) {
-        double px = point.x;
-        double py = point.y;
+    // Only points within the eraser, or with a segment long enough for the segment test, can be hit
+    double minSegmentLength = halfEraserSize * (1 - 1e-9);
+
+    for (size_t i = begin; i < end; i++) {
+        i = PointKernels::findEraserCandidate(this->points.getXData(), this->points.getYData(), i, end, x1, y1, x2,
+                                              y2, minSegmentLength);
+        if (i == end) {
+            break;
+        }
+
+        double px = this->points.getX(i);
+        double py = this->points.getY(i);
+        size_t last = i > 0 ? i - 1 : 0;
+        double lastX = this->points.getX(last);
+        double lastY = this->points.getY(last);
 
         if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
             if (gap) {
@@ -321,14 +377,30 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
                 }
             }
         }
-
-        lastX = px;
-        lastY = py;
     }
 
     return false;
 }
 
+auto Stroke::getSegmentTree() const -> std::shared_ptr<const StrokeSegmentTree> {
+    if (this->points.size() < SEGMENT_TREE_MIN_POINTS) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const StrokeSegmentTree> tree = std::atomic_load(&this->segmentTree);
+    if (tree == nullptr) {
+        // The UI and the render threads may build it at the same time, the first stored tree is kept
+        auto built = std::make_shared<const StrokeSegmentTree>(this->points);
+        if (std::atomic_compare_exchange_strong(&this->segmentTree, &tree, built)) {
+            tree = std::move(built);
+        }
+    }
+
+    return tree;
+}
+
+void Stroke::pointsChanged() { std::atomic_store(&this->segmentTree, std::shared_ptr<const StrokeSegmentTree>()); }
+
 /**
  * Updates the size
  * The size is needed to only redraw the requested part instead of redrawing
@@ -343,32 +415,19 @@ void Stroke::calcSize() {
         // The size of the rectangle, not the size of the pen!
         Element::width = 0;
         Element::height = 0;
+        return;
     }
 
-    double minX = DBL_MAX;
-    double maxX = DBL_MIN;
-    double minY = DBL_MAX;
-    double maxY = DBL_MIN;
-
-    bool hasPressure = points[0].z != Point::NO_PRESSURE;
+    const Coordinate* pressure = hasPressure() ? this->points.getPressureData() : nullptr;
     double halfThick = this->width / 2.0;  //  accommodate for pen width
 
-    for (auto&& p: points) {
-        if (hasPressure) {
-            halfThick = p.z / 2.0;
-        }
-
-        minX = std::min(minX, p.x - halfThick);
-        minY = std::min(minY, p.y - halfThick);
-
-        maxX = std::max(maxX, p.x + halfThick);
-        maxY = std::max(maxY, p.y + halfThick);
-    }
+    PointKernels::Bounds bounds = PointKernels::calcBounds(this->points.getXData(), this->points.getYData(), pressure,
+                                                           this->points.size(), halfThick);
 
-    Element::x = minX - 2;
-    Element::y = minY - 2;
-    Element::width = maxX - minX + 4;
-    Element::height = maxY - minY + 4;
+    Element::x = bounds.minX - 2;
+    Element::y = bounds.minY - 2;
+    Element::width = bounds.maxX - bounds.minX + 4;
+    Element::height = bounds.maxY - bounds.minY + 4;
 }
 
 auto Stroke::getEraseable() -> EraseableStroke* { return this->eraseable; }
@@ -378,8 +437,8 @@ void Stroke::setEraseable(EraseableStroke* eraseable) { this->eraseable = erasea
 void Stroke::debugPrint() {
     g_message("%s", FC(FORMAT_STR("Stroke {1} / hasPressure() = {2}") % (uint64_t)this % this->hasPressure()));
 
-    for (auto&& p: points) {
-        g_message("%lf / %lf", p.x, p.y);
+    for (size_t i = 0; i < this->points.size(); i++) {
+        g_message("%lf / %lf", this->points.getX(i), this->points.getY(i));
     }
 
     g_message("\n");
@@ -11,10 +11,14 @@
 
 #pragma once
 
+#include <memory>
+
 #include "AudioElement.h"
 #include "Element.h"
 #include "LineStyle.h"
 #include "Point.h"
+#include "PointArray.h"
+#include "StrokeSegmentTree.h"
 
 enum StrokeTool { STROKE_TOOL_PEN, STROKE_TOOL_ERASER, STROKE_TOOL_HIGHLIGHTER };
 
@@ -23,6 +27,13 @@ class EraseableStroke;
 class Stroke: public AudioElement {
 public:
     Stroke();
+
+    /**
+     * The points are allocated from the arena, the stroke has to be allocated from the same arena:
+     * new (arena) Stroke(arena)
+     */
+    explicit Stroke(ElementArena* arena);
+
     Stroke(Stroke const&) = default;
     Stroke(Stroke&&) = default;
 
@@ -61,14 +72,23 @@ public:
     void setFill(int fill);
 
     void addPoint(const Point& p);
+    void addPoints(const vector<Point>& points);
     void setLastPoint(double x, double y);
     void setFirstPoint(double x, double y);
     void setLastPoint(const Point& p);
     int getPointCount() const;
     void freeUnusedPointItems();
-    std::vector<Point> const& getPointVector() const;
     Point getPoint(int index) const;
-    const Point* getPoints() const;
+
+    /**
+     * The points of the stroke
+     */
+    const PointArray& getPointArray() const;
+
+    /**
+     * Copy of the points, for code which was not changed to use getPointArray()
+     */
+    std::vector<Point> getPointVector() const;
 
     void deletePoint(int index);
     void deletePointsFrom(int index);
@@ -109,6 +129,23 @@ public:
 protected:
     void calcSize() override;
 
+private:
+    /**
+     * Test the points begin to end (exclusive) and the segments to their previous point
+     */
+    bool intersectsRange(double x, double y, double halfEraserSize, double* gap, size_t begin, size_t end) const;
+
+    /**
+     * The segment tree, built on first use. Nullptr for short strokes, they are tested directly.
+     * The reference keeps the tree valid if the points change meanwhile.
+     */
+    std::shared_ptr<const StrokeSegmentTree> getSegmentTree() const;
+
+    /**
+     * Has to be called if the position of the points change
+     */
+    void pointsChanged();
+
 private:
     // The stroke width cannot be inherited from Element
     double width = 0;
@@ -116,7 +153,7 @@ private:
     StrokeTool toolType = STROKE_TOOL_PEN;
 
     // The array with the points
-    std::vector<Point> points{};
+    PointArray points;
 
     /**
      * Dashed line
@@ -125,6 +162,12 @@ private:
 
     EraseableStroke* eraseable = nullptr;
 
+    /**
+     * Lazy built, immutable, so copies of the stroke can share it until they are changed.
+     * Only accessed with std::atomic_load / std::atomic_store, the UI and the render threads use it.
+     */
+    mutable std::shared_ptr<const StrokeSegmentTree> segmentTree;
+
     /**
      * Option to fill the shape:
      *  -1: The shape is not filled
@@ -0,0 +1,131 @@
+#include "StrokeSegmentTree.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Element.h"
+
+/**
+ * Number of points in a leaf, testing a few points directly is faster than descending further
+ */
+constexpr size_t LEAF_SIZE = 16;
+
+StrokeSegmentTree::StrokeSegmentTree(const PointArray& points) {
+    if (points.empty()) {
+        return;
+    }
+
+    this->nodes.reserve(2 * (points.size() / LEAF_SIZE + 1));
+    build(points, 0, points.size());
+}
+
+auto StrokeSegmentTree::build(const PointArray& points, size_t begin, size_t end) -> uint32_t {
+    auto index = static_cast<uint32_t>(this->nodes.size());
+    this->nodes.emplace_back();
+
+    if (end - begin > LEAF_SIZE) {
+        size_t middle = begin + (end - begin) / 2;
+        uint32_t left = build(points, begin, middle);
+        uint32_t right = build(points, middle, end);
+
+        // No reference into nodes before, the vector may have been reallocated
+        Node& node = this->nodes[index];
+        const Node& l = this->nodes[left];
+        const Node& r = this->nodes[right];
+        node.begin = begin;
+        node.end = end;
+        node.left = left;
+        node.right = right;
+        node.x1 = std::min(l.x1, r.x1);
+        node.y1 = std::min(l.y1, r.y1);
+        node.x2 = std::max(l.x2, r.x2);
+        node.y2 = std::max(l.y2, r.y2);
+        node.maxSegmentLength = std::max(l.maxSegmentLength, r.maxSegmentLength);
+        return index;
+    }
+
+    Node& node = this->nodes[index];
+    node.begin = begin;
+    node.end = end;
+
+    // Include the start of the first segment
+    size_t first = begin > 0 ? begin - 1 : 0;
+    node.x1 = node.x2 = points.getX(first);
+    node.y1 = node.y2 = points.getY(first);
+
+    for (size_t i = first + 1; i < end; i++) {
+        double x = points.getX(i);
+        double y = points.getY(i);
+        node.x1 = std::min(node.x1, x);
+        node.y1 = std::min(node.y1, y);
+        node.x2 = std::max(node.x2, x);
+        node.y2 = std::max(node.y2, y);
+
+        double length = std::hypot(x - points.getX(i - 1), y - points.getY(i - 1));
+        node.maxSegmentLength = std::max(node.maxSegmentLength, length);
+    }
+
+    return index;
+}
+
+void StrokeSegmentTree::findNear(double x, double y, double distance, vector<IndexRange>& result) const {
+    if (!this->nodes.empty()) {
+        findNear(0, x, y, distance, result);
+    }
+}
+
+void StrokeSegmentTree::findNear(uint32_t index, double x, double y, double distance,
+                                 vector<IndexRange>& result) const {
+    const Node& node = this->nodes[index];
+
+    double d = distance + node.maxSegmentLength;
+    if (x < node.x1 - d || x > node.x2 + d || y < node.y1 - d || y > node.y2 + d) {
+        return;
+    }
+
+    if (node.left == 0) {
+        // Merge with the previous range, if they are consecutive
+        if (!result.empty() && result.back().second == node.begin) {
+            result.back().second = node.end;
+        } else {
+            result.emplace_back(node.begin, node.end);
+        }
+        return;
+    }
+
+    findNear(node.left, x, y, distance, result);
+    findNear(node.right, x, y, distance, result);
+}
+
+auto StrokeSegmentTree::isInSelection(const PointArray& points, ShapeContainer* container) const -> bool {
+    if (this->nodes.empty()) {
+        return true;
+    }
+
+    return isInSelection(0, points, container);
+}
+
+auto StrokeSegmentTree::isInSelection(uint32_t index, const PointArray& points, ShapeContainer* container) const
+        -> bool {
+    const Node& node = this->nodes[index];
+
+    // The box also contains the point before the range, this doesn't matter here:
+    // Outside the shape means all points are outside, and inside means all points are inside
+    if (!container->intersectsRect(node.x1, node.y1, node.x2, node.y2)) {
+        return false;
+    }
+    if (container->containsRect(node.x1, node.y1, node.x2, node.y2)) {
+        return true;
+    }
+
+    if (node.left == 0) {
+        for (size_t i = node.begin; i < node.end; i++) {
+            if (!container->contains(points.getX(i), points.getY(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return isInSelection(node.left, points, container) && isInSelection(node.right, points, container);
+}
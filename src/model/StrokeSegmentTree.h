@@ -0,0 +1,74 @@
+/*
+ * Xournal++
+ *
+ * Bounding volume hierarchy over the segments of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "PointArray.h"
+#include "XournalType.h"
+
+class ShapeContainer;
+
+/**
+ * The points of a stroke are grouped into consecutive ranges, every node stores the bounding box of its range.
+ * Point i is the end of the segment (i - 1, i), so the bounding box of a range also contains the point before it.
+ *
+ * The tree is immutable, it has to be rebuilt if the points change.
+ */
+class StrokeSegmentTree {
+public:
+    explicit StrokeSegmentTree(const PointArray& points);
+
+public:
+    using IndexRange = std::pair<size_t, size_t>;
+
+    /**
+     * Add the ranges of point indices [first, second) which may be within distance of (x, y) to result,
+     * in ascending order. The length of the longest segment within a node is added to the distance, so
+     * tests which depend on the segment length (like Stroke::intersects) don't miss any segment.
+     */
+    void findNear(double x, double y, double distance, vector<IndexRange>& result) const;
+
+    /**
+     * @return true if all points are within the container
+     */
+    bool isInSelection(const PointArray& points, ShapeContainer* container) const;
+
+private:
+    class Node {
+    public:
+        double x1 = 0;
+        double y1 = 0;
+        double x2 = 0;
+        double y2 = 0;
+        double maxSegmentLength = 0;
+
+        size_t begin = 0;
+        size_t end = 0;
+
+        /**
+         * Child nodes, 0 for a leaf (0 is the root, so it's never a child)
+         */
+        uint32_t left = 0;
+        uint32_t right = 0;
+    };
+
+    uint32_t build(const PointArray& points, size_t begin, size_t end);
+
+    void findNear(uint32_t index, double x, double y, double distance, vector<IndexRange>& result) const;
+    bool isInSelection(uint32_t index, const PointArray& points, ShapeContainer* container) const;
+
+private:
+    vector<Node> nodes;
+};
@@ -1,15 +1,22 @@
 #include "TexImage.h"
 
 #include <utility>
+#include <vector>
 
 #include "serializing/ObjectInputStream.h"
 #include "serializing/ObjectOutputStream.h"
 
 #include "pixbuf-utils.h"
 
-TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) { this->sizeCalculated = true; }
+TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) {
+    this->sizeCalculated = true;
+    g_mutex_init(&this->rasterLock);
+}
 
-TexImage::~TexImage() { freeImageAndPdf(); }
+TexImage::~TexImage() {
+    freeImageAndPdf();
+    g_mutex_clear(&this->rasterLock);
+}
 
 /**
  * Free image and PDF
@@ -25,9 +32,95 @@ void TexImage::freeImageAndPdf() {
         this->pdf = nullptr;
     }
 
+    freeRaster();
+
     this->parsedBinaryData = false;
 }
 
+void TexImage::freeRaster() { setRaster(nullptr); }
+
+/**
+ * The TexImages with a raster, most recently used first, and the memory of their rasters
+ */
+static GMutex rasterUseLock;
+static std::list<TexImage*> rasterUseList;
+static size_t rasterBytes = 0;
+
+static auto getSurfaceMemoryUsage(cairo_surface_t* surface) -> size_t {
+    if (surface == nullptr) {
+        return 0;
+    }
+    return static_cast<size_t>(cairo_image_surface_get_stride(surface)) * cairo_image_surface_get_height(surface);
+}
+
+auto TexImage::getRaster() -> cairo_surface_t* {
+    g_mutex_lock(&this->rasterLock);
+    cairo_surface_t* raster = this->raster ? cairo_surface_reference(this->raster) : nullptr;
+    g_mutex_unlock(&this->rasterLock);
+
+    if (raster) {
+        g_mutex_lock(&rasterUseLock);
+        if (this->hasRasterUse) {
+            rasterUseList.splice(rasterUseList.begin(), rasterUseList, this->rasterUse);
+        }
+        g_mutex_unlock(&rasterUseLock);
+    }
+
+    return raster;
+}
+
+void TexImage::setRaster(cairo_surface_t* raster) {
+    if (raster) {
+        cairo_surface_reference(raster);
+    }
+
+    g_mutex_lock(&this->rasterLock);
+    cairo_surface_t* old = this->raster;
+    this->raster = raster;
+    g_mutex_unlock(&this->rasterLock);
+
+    // Always locked after rasterLock was released, eviction locks rasterLock of other images while holding it
+    std::vector<cairo_surface_t*> freed;
+    if (old) {
+        freed.push_back(old);
+    }
+
+    g_mutex_lock(&rasterUseLock);
+    rasterBytes = rasterBytes + getSurfaceMemoryUsage(raster) - getSurfaceMemoryUsage(old);
+
+    if (raster && !this->hasRasterUse) {
+        rasterUseList.push_front(this);
+        this->rasterUse = rasterUseList.begin();
+        this->hasRasterUse = true;
+    } else if (raster) {
+        rasterUseList.splice(rasterUseList.begin(), rasterUseList, this->rasterUse);
+    } else if (this->hasRasterUse) {
+        rasterUseList.erase(this->rasterUse);
+        this->hasRasterUse = false;
+    }
+
+    while (rasterBytes > MAX_RASTER_BYTES && !rasterUseList.empty() && rasterUseList.back() != this) {
+        TexImage* victim = rasterUseList.back();
+        rasterUseList.pop_back();
+        victim->hasRasterUse = false;
+
+        g_mutex_lock(&victim->rasterLock);
+        cairo_surface_t* victimRaster = victim->raster;
+        victim->raster = nullptr;
+        g_mutex_unlock(&victim->rasterLock);
+
+        if (victimRaster) {
+            rasterBytes -= getSurfaceMemoryUsage(victimRaster);
+            freed.push_back(victimRaster);
+        }
+    }
+    g_mutex_unlock(&rasterUseLock);
+
+    for (cairo_surface_t* surface: freed) {
+        cairo_surface_destroy(surface);
+    }
+}
+
 auto TexImage::clone() -> Element* {
     auto* img = new TexImage();
 
@@ -69,13 +162,30 @@ auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned
 /**
  * Sets the binary data, a .PNG image or a .PDF
  */
-void TexImage::setBinaryData(string binaryData) { this->binaryData = std::move(binaryData); }
+void TexImage::setBinaryData(string binaryData) {
+    this->binaryData = std::move(binaryData);
+    freeRaster();
+}
 
 /**
  * Gets the binary data, a .PNG image or a .PDF
  */
 auto TexImage::getBinaryData() -> string& { return this->binaryData; }
 
+void TexImage::freeBinaryData() {
+    // The PDF references the binary data
+    freeImageAndPdf();
+    string().swap(this->binaryData);
+}
+
+auto TexImage::getMemoryUsage() -> size_t {
+    g_mutex_lock(&this->rasterLock);
+    size_t usage = getSurfaceMemoryUsage(this->raster);
+    g_mutex_unlock(&this->rasterLock);
+
+    return usage + this->binaryData.capacity() + getSurfaceMemoryUsage(this->image);
+}
+
 void TexImage::setText(string text) { this->text = std::move(text); }
 
 auto TexImage::getText() -> string { return this->text; }
@@ -139,6 +249,7 @@ void TexImage::setPdf(PopplerDocument* pdf) {
     }
 
     this->pdf = pdf;
+    freeRaster();
 
     if (this->pdf != nullptr) {
         g_object_ref(this->pdf);
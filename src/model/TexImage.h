@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <list>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,16 @@ public:
      */
     string& getBinaryData();
 
+    /**
+     * Free the binary data and everything loaded from it, until it is set again
+     */
+    void freeBinaryData();
+
+    /**
+     * @return The memory of the binary data and the images in bytes
+     */
+    size_t getMemoryUsage();
+
     /**
      * Get the Image, if rendered as image
      */
@@ -58,6 +69,23 @@ public:
      */
     void setPdf(PopplerDocument* pdf);
 
+    /**
+     * @return The PDF rendered to an image, for drawing it to image surfaces. A new reference, or nullptr
+     */
+    cairo_surface_t* getRaster();
+
+    /**
+     * @param raster The PDF rendered to an image, replaces the previous one. The image will be referenced.
+     * If the rasters of all TexImages exceed MAX_RASTER_BYTES, the least recently used ones are dropped.
+     */
+    void setRaster(cairo_surface_t* raster);
+
+public:
+    /**
+     * Memory limit of the rasters of all TexImages
+     */
+    static constexpr size_t MAX_RASTER_BYTES = 256 * 1024 * 1024;
+
     virtual void scale(double x0, double y0, double fx, double fy);
     virtual void rotate(double x0, double y0, double xo, double yo, double th);
 
@@ -82,6 +110,8 @@ private:
      */
     void freeImageAndPdf();
 
+    void freeRaster();
+
     /**
      * Load the binary data, either .PNG or .PDF
      */
@@ -98,6 +128,18 @@ private:
      */
     cairo_surface_t* image = nullptr;
 
+    /**
+     * The PDF rendered to an image, used by the render threads, too
+     */
+    GMutex rasterLock{};
+    cairo_surface_t* raster = nullptr;
+
+    /**
+     * The position in the list of TexImages with a raster, most recently used first. Guarded by a global lock
+     */
+    std::list<TexImage*>::iterator rasterUse;
+    bool hasRasterUse = false;
+
     /**
      * PNG Image / PDF Document
      */
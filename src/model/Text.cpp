@@ -1,5 +1,6 @@
 #include "Text.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "serializing/ObjectInputStream.h"
@@ -9,11 +10,18 @@
 #include "Stacktrace.h"
 
 Text::Text(): AudioElement(ELEMENT_TEXT) {
+    g_mutex_init(&this->layoutLock);
+
     this->font.setName("Sans");
     this->font.setSize(12);
 }
 
-Text::~Text() = default;
+Text::~Text() {
+    for (CachedLayout& cached: this->layouts) {
+        g_object_unref(cached.layout);
+    }
+    g_mutex_clear(&this->layoutLock);
+}
 
 auto Text::clone() -> Element* {
     Text* text = new Text();
@@ -29,14 +37,66 @@ auto Text::clone() -> Element* {
 
 auto Text::getFont() -> XojFont& { return font; }
 
-void Text::setFont(XojFont& font) { this->font = font; }
+void Text::setFont(XojFont& font) {
+    g_mutex_lock(&this->layoutLock);
+    this->font = font;
+    g_mutex_unlock(&this->layoutLock);
+
+    this->sizeCalculated = false;
+}
 
 auto Text::getText() -> string { return this->text; }
 
 void Text::setText(string text) {
+    g_mutex_lock(&this->layoutLock);
     this->text = std::move(text);
+    for (CachedLayout& cached: this->layouts) {
+        cached.textChanged = true;
+    }
+    g_mutex_unlock(&this->layoutLock);
+
+    // Measured on first use, loading a document does not need the size
+    this->sizeCalculated = false;
+}
+
+void Text::useLayout(const std::function<void(PangoLayout*)>& f) {
+    g_mutex_lock(&this->layoutLock);
+
+    PangoFontMap* fontMap = pango_cairo_font_map_get_default();
+    auto it = std::find_if(this->layouts.begin(), this->layouts.end(),
+                           [fontMap](const CachedLayout& cached) { return cached.fontMap == fontMap; });
+    if (it == this->layouts.end()) {
+        CachedLayout cached;
+        cached.fontMap = fontMap;
+        cached.layout = TextView::createLayout(fontMap);
+        cached.dpi = TextView::getDpi();
+        it = this->layouts.insert(this->layouts.end(), cached);
+    }
+    CachedLayout& cached = *it;
+
+    // Only the thread of the font map uses and replaces the layout
+    if (cached.dpi != TextView::getDpi()) {
+        g_object_unref(cached.layout);
+        cached.layout = TextView::createLayout(fontMap);
+        cached.dpi = TextView::getDpi();
+        cached.fontName.clear();
+        cached.textChanged = true;
+    }
+
+    if (cached.fontName != this->font.getName() || cached.fontSize != this->font.getSize()) {
+        TextView::updatePangoFont(cached.layout, this);
+        cached.fontName = this->font.getName();
+        cached.fontSize = this->font.getSize();
+    }
+
+    if (cached.textChanged) {
+        pango_layout_set_text(cached.layout, this->text.c_str(), this->text.length());
+        cached.textChanged = false;
+    }
+
+    f(cached.layout);
 
-    calcSize();
+    g_mutex_unlock(&this->layoutLock);
 }
 
 void Text::calcSize() { TextView::calcSize(this, this->width, this->height); }
@@ -61,8 +121,10 @@ void Text::scale(double x0, double y0, double fx, double fy) {
     this->y *= fy;
     this->y += y0;
 
+    g_mutex_lock(&this->layoutLock);
     double size = this->font.getSize() * fx;
     this->font.setSize(size);
+    g_mutex_unlock(&this->layoutLock);
 
     this->sizeCalculated = false;
 }
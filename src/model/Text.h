@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include <gtk/gtk.h>
 
 #include "AudioElement.h"
@@ -48,6 +51,13 @@ public:
     bool intersects(double x, double y, double halfEraserSize) override;
     bool intersects(double x, double y, double halfEraserSize, double* gap) override;
 
+    /**
+     * Calls f with the layout of the text, which is cached until the text, the font or the DPI changes.
+     * Each thread has its own default font map, so there is one layout per font map. The layouts are locked while f
+     * runs. The layouts use the font options of image surfaces, other surfaces need their own layout.
+     */
+    void useLayout(const std::function<void(PangoLayout*)>& f);
+
 public:
     // Serialize interface
     void serialize(ObjectOutputStream& out) override;
@@ -62,4 +72,19 @@ private:
     string text;
 
     bool inEditing = false;
+
+    struct CachedLayout {
+        PangoFontMap* fontMap = nullptr;
+        PangoLayout* layout = nullptr;
+        int dpi = 0;
+        string fontName;
+        double fontSize = 0;
+        bool textChanged = true;
+    };
+
+    /**
+     * Guards the layouts, and the text and the font while they change
+     */
+    GMutex layoutLock{};
+    std::vector<CachedLayout> layouts;
 };
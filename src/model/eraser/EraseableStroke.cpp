@@ -1,25 +1,31 @@
 #include "EraseableStroke.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "model/Stroke.h"
 
-#include "EraseableStrokePart.h"
-#include "PartList.h"
 #include "Range.h"
 
 EraseableStroke::EraseableStroke(Stroke* stroke): stroke(stroke) {
-    this->parts = new PartList();
     g_mutex_init(&this->partLock);
 
-    for (int i = 1; i < stroke->getPointCount(); i++) {
-        this->parts->add(new EraseableStrokePart(stroke->getPoint(i - 1), stroke->getPoint(i)));
+    auto parts = std::make_shared<PartVector>();
+    if (stroke->getPointCount() > 1) {
+        // Initially the whole stroke is one unmodified range
+        parts->emplace_back(stroke->getPointArray(), 0, stroke->getPointCount() - 1);
     }
+    this->parts = std::move(parts);
 }
 
-EraseableStroke::~EraseableStroke() {
-    delete this->parts;
-    this->parts = nullptr;
+EraseableStroke::~EraseableStroke() = default;
+
+auto EraseableStroke::getParts() -> std::shared_ptr<const PartVector> {
+    g_mutex_lock(&this->partLock);
+    std::shared_ptr<const PartVector> parts = this->parts;
+    g_mutex_unlock(&this->partLock);
+
+    return parts;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -27,33 +33,47 @@ EraseableStroke::~EraseableStroke() {
 ////////////////////////////////////////////////////////////////////////////////
 
 void EraseableStroke::draw(cairo_t* cr) {
-    g_mutex_lock(&this->partLock);
-    PartList* tmpCopy = this->parts->clone();
-    g_mutex_unlock(&this->partLock);
+    std::shared_ptr<const PartVector> parts = getParts();
 
+    const PointArray& points = this->stroke->getPointArray();
     double w = this->stroke->getWidth();
+    bool pressure = this->stroke->hasPressure();
+
+    for (const EraseableStrokePart& part: *parts) {
+        if (part.isRange()) {
+            if (pressure) {
+                for (size_t i = part.getBegin(); i < part.getEnd(); i++) {
+                    double z = points.getPressure(i);
+                    cairo_set_line_width(cr, z == Point::NO_PRESSURE ? w : z);
+                    cairo_move_to(cr, points.getX(i), points.getY(i));
+                    cairo_line_to(cr, points.getX(i + 1), points.getY(i + 1));
+                    cairo_stroke(cr);
+                }
+                continue;
+            }
 
-    for (GList* l = tmpCopy->data; l != nullptr; l = l->next) {
-        auto* part = static_cast<EraseableStrokePart*>(l->data);
-        if (part->getWidth() == Point::NO_PRESSURE) {
             cairo_set_line_width(cr, w);
-        } else {
-            cairo_set_line_width(cr, part->getWidth());
+            cairo_move_to(cr, points.getX(part.getBegin()), points.getY(part.getBegin()));
+            for (size_t i = part.getBegin() + 1; i <= part.getEnd(); i++) {
+                cairo_line_to(cr, points.getX(i), points.getY(i));
+            }
+            cairo_stroke(cr);
+            continue;
         }
 
-        GList* pl = part->getPoints();
-        auto* p = static_cast<Point*>(pl->data);
-        cairo_move_to(cr, p->x, p->y);
+        const vector<Point>& partPoints = part.getPoints();
+        if (part.getWidth() == Point::NO_PRESSURE) {
+            cairo_set_line_width(cr, w);
+        } else {
+            cairo_set_line_width(cr, part.getWidth());
+        }
 
-        pl = pl->next;
-        for (; pl != nullptr; pl = pl->next) {
-            auto* p = static_cast<Point*>(pl->data);
-            cairo_line_to(cr, p->x, p->y);
+        cairo_move_to(cr, partPoints[0].x, partPoints[0].y);
+        for (size_t i = 1; i < partPoints.size(); i++) {
+            cairo_line_to(cr, partPoints[i].x, partPoints[i].y);
         }
         cairo_stroke(cr);
     }
-
-    delete tmpCopy;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -66,22 +86,37 @@ void EraseableStroke::draw(cairo_t* cr) {
 auto EraseableStroke::erase(double x, double y, double halfEraserSize, Range* range) -> Range* {
     this->repaintRect = range;
 
-    g_mutex_lock(&this->partLock);
-    PartList* tmpCopy = this->parts->clone();
-    g_mutex_unlock(&this->partLock);
+    // Only this thread modifies the parts, so no lock is needed to read them here
+    const PartVector& current = *this->parts;
 
-    for (GList* l = tmpCopy->data; l != nullptr;) {
-        auto* p = static_cast<EraseableStrokePart*>(l->data);
-        l = l->next;
-        erase(x, y, halfEraserSize, p, tmpCopy);
-    }
+    // Created on the first change, until then nothing is copied
+    std::shared_ptr<PartVector> result;
+    PartVector changed;
 
-    g_mutex_lock(&this->partLock);
-    PartList* old = this->parts;
-    this->parts = tmpCopy;
-    g_mutex_unlock(&this->partLock);
+    for (size_t i = 0; i < current.size(); i++) {
+        if (result == nullptr) {
+            changed.clear();
+            if (!erase(x, y, halfEraserSize, current[i], changed)) {
+                continue;
+            }
+
+            result = std::make_shared<PartVector>();
+            result->reserve(current.size() + changed.size());
+            result->insert(result->end(), current.begin(), current.begin() + i);
+            result->insert(result->end(), changed.begin(), changed.end());
+            continue;
+        }
+
+        if (!erase(x, y, halfEraserSize, current[i], *result)) {
+            result->push_back(current[i]);
+        }
+    }
 
-    delete old;
+    if (result) {
+        g_mutex_lock(&this->partLock);
+        this->parts = std::move(result);
+        g_mutex_unlock(&this->partLock);
+    }
 
     return this->repaintRect;
 }
@@ -96,22 +131,11 @@ void EraseableStroke::addRepaintRect(double x, double y, double width, double he
     this->repaintRect->addPoint(x + width, y + height);
 }
 
-void EraseableStroke::erase(double x, double y, double halfEraserSize, EraseableStrokePart* part, PartList* list) {
-    if (part->points->next == nullptr) {
-        return;
-    }
-
+auto EraseableStroke::hitTest(double x, double y, double halfEraserSize, const Point& a, const Point& b) -> EraseHit {
     Point eraser(x, y);
 
-    auto* a = static_cast<Point*>(g_list_first(part->points)->data);
-    auto* b = static_cast<Point*>(g_list_last(part->points)->data);
-
-    if (eraser.lineLengthTo(*a) < halfEraserSize * 1.2 && eraser.lineLengthTo(*b) < halfEraserSize * 1.2) {
-        list->data = g_list_remove(list->data, part);
-        addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-
-        delete part;
-        return;
+    if (eraser.lineLengthTo(a) < halfEraserSize * 1.2 && eraser.lineLengthTo(b) < halfEraserSize * 1.2) {
+        return ERASE_HIT_ALL;
     }
 
     double x1 = x - halfEraserSize;
@@ -119,41 +143,24 @@ void EraseableStroke::erase(double x, double y, double halfEraserSize, Eraseable
     double y1 = y - halfEraserSize;
     double y2 = y + halfEraserSize;
 
-    double aX = a->x;
-    double aY = a->y;
-    double bX = b->x;
-    double bY = b->y;
+    double aX = a.x;
+    double aY = a.y;
+    double bX = b.x;
+    double bY = b.y;
+
+    // No point of the segment is within the eraser, so nothing would be erased
+    if (std::max(aX, bX) < x1 || std::min(aX, bX) > x2 || std::max(aY, bY) < y1 || std::min(aY, bY) > y2) {
+        return ERASE_HIT_NONE;
+    }
 
     // check first point
     if (aX >= x1 && aY >= y1 && aX <= x2 && aY <= y2) {
-        bool deleteAfter = false;
-
-        if (erasePart(x, y, halfEraserSize, part, list, &deleteAfter)) {
-            addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-            part->calcSize();
-        }
-
-        if (deleteAfter) {
-            delete part;
-        }
-
-        return;
+        return ERASE_HIT_PART;
     }
 
     // check last point
     if (bX >= x1 && bY >= y1 && bX <= x2 && bY <= y2) {
-        bool deleteAfter = false;
-
-        if (erasePart(x, y, halfEraserSize, part, list, &deleteAfter)) {
-            addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-            part->calcSize();
-        }
-
-        if (deleteAfter) {
-            delete part;
-        }
-
-        return;
+        return ERASE_HIT_PART;
     }
 
     double len = hypot(bX - aX, bY - aY);
@@ -177,133 +184,128 @@ void EraseableStroke::erase(double x, double y, double halfEraserSize, Eraseable
         distance -= hypot((x2 - x1) / 2, (y2 - y1) / 2);
 
         if (distance <= (len / 2) + 0.1) {
-            bool deleteAfter = false;
+            return ERASE_HIT_PART;
+        }
+    }
 
-            if (erasePart(x, y, halfEraserSize, part, list, &deleteAfter)) {
-                addRepaintRect(part->getX(), part->getY(), part->getElementWidth(), part->getElementHeight());
-                part->calcSize();
-            }
+    return ERASE_HIT_NONE;
+}
 
-            if (deleteAfter) {
-                delete part;
-            }
+auto EraseableStroke::erase(double x, double y, double halfEraserSize, const EraseableStrokePart& part,
+                            PartVector& result) -> bool {
+    if (!part.isRange()) {
+        const vector<Point>& points = part.getPoints();
+        EraseHit hit = hitTest(x, y, halfEraserSize, points.front(), points.back());
+        if (hit == ERASE_HIT_NONE) {
+            return false;
+        }
+
+        addRepaintRect(part.getX(), part.getY(), part.getElementWidth(), part.getElementHeight());
 
-            return;
+        if (hit == ERASE_HIT_PART) {
+            EraseableStrokePart split = part;
+            split.splitFor(halfEraserSize);
+            erasePoints(x, y, halfEraserSize, split, result);
         }
+
+        return true;
     }
-}
 
-auto EraseableStroke::erasePart(double x, double y, double halfEraserSize, EraseableStrokePart* part, PartList* list,
-                                bool* deleteStrokeAfter) -> bool {
-    bool changed = false;
+    // Nothing within the eraser (the hit test allows a distance up to 1.2 * halfEraserSize)
+    double padding = halfEraserSize * 1.2;
+    if (x + padding < part.getX() || x - padding > part.getX() + part.getElementWidth() ||
+        y + padding < part.getY() || y - padding > part.getY() + part.getElementHeight()) {
+        return false;
+    }
 
-    part->splitFor(halfEraserSize);
+    const PointArray& points = this->stroke->getPointArray();
+    bool changed = false;
+    size_t rangeStart = part.getBegin();
 
-    double x1 = x - halfEraserSize;
-    double x2 = x + halfEraserSize;
-    double y1 = y - halfEraserSize;
-    double y2 = y + halfEraserSize;
+    for (size_t i = part.getBegin(); i < part.getEnd(); i++) {
+        Point a = points[i];
+        Point b = points[i + 1];
 
-    /**
-     * erase the beginning
-     */
-    for (GList* l = part->getPoints(); l != nullptr;) {
-        auto* p = static_cast<Point*>(l->data);
-        l = l->next;
-        if (p->x >= x1 && p->y >= y1 && p->x <= x2 && p->y <= y2) {
-            part->points = g_list_remove(part->points, p);
-            delete p;
-            changed = true;
-        } else {
-            // only the beginning is handled here
-            break;
+        EraseHit hit = hitTest(x, y, halfEraserSize, a, b);
+        if (hit == ERASE_HIT_NONE) {
+            continue;
         }
-    }
 
-    /**
-     * erase the end
-     */
-    for (GList* l = g_list_last(part->getPoints()); l != nullptr;) {
-        auto* p = static_cast<Point*>(l->data);
-        l = l->prev;
-        if (p->x >= x1 && p->y >= y1 && p->x <= x2 && p->y <= y2) {
-            part->points = g_list_remove(part->points, p);
-            delete p;
-            changed = true;
-        } else {
-            // only the end is handled here
-            break;
+        changed = true;
+
+        // The unmodified points before this segment
+        if (i > rangeStart) {
+            result.emplace_back(points, rangeStart, i);
         }
-    }
+        rangeStart = i + 1;
 
-    /**
-     * handle the rest
-     */
+        addRepaintRect(std::min(a.x, b.x), std::min(a.y, b.y), std::abs(a.x - b.x), std::abs(a.y - b.y));
 
-    GList* lists = nullptr;
-    GList* current = nullptr;
-
-    for (GList* l = part->points; l != nullptr;) {
-        auto* p = static_cast<Point*>(l->data);
-        l = l->next;
-        if (p->x >= x1 && p->y >= y1 && p->x <= x2 && p->y <= y2) {
-            part->points = g_list_remove(part->points, p);
-            delete p;
-            if (current) {
-                lists = g_list_append(lists, current);
-                current = nullptr;
-            }
-            changed = true;
-        } else {
-            current = g_list_append(current, p);
+        if (hit == ERASE_HIT_PART) {
+            eraseSegment(x, y, halfEraserSize, a, b, result);
         }
     }
 
-    if (current) {
-        lists = g_list_append(lists, current);
-        current = nullptr;
+    if (!changed) {
+        return false;
+    }
+
+    if (part.getEnd() > rangeStart) {
+        result.emplace_back(points, rangeStart, part.getEnd());
     }
 
-    g_list_free(part->points);
-    part->points = nullptr;
-    if (lists) {
-        part->points = static_cast<GList*>(lists->data);
-        lists = g_list_delete_link(lists, lists);
+    return true;
+}
+
+void EraseableStroke::eraseSegment(double x, double y, double halfEraserSize, const Point& a, const Point& b,
+                                   PartVector& result) {
+    EraseableStrokePart part(a.z, {a, b}, 0);
+    part.splitFor(halfEraserSize);
+
+    erasePoints(x, y, halfEraserSize, part, result);
+}
 
-        int pos = g_list_index(list->data, part) + 1;
+void EraseableStroke::erasePoints(double x, double y, double halfEraserSize, const EraseableStrokePart& part,
+                                  PartVector& result) {
+    double x1 = x - halfEraserSize;
+    double x2 = x + halfEraserSize;
+    double y1 = y - halfEraserSize;
+    double y2 = y + halfEraserSize;
 
-        // create data structure for all new (splitted) parts
-        for (GList* l = lists; l != nullptr; l = l->next) {
-            auto* newPart = new EraseableStrokePart(part->width);
-            newPart->points = static_cast<GList*>(l->data);
-            list->data = g_list_insert(list->data, newPart, pos++);
+    // Every run of points outside of the eraser is a new part
+    vector<Point> current;
+    for (const Point& p: part.getPoints()) {
+        if (p.x >= x1 && p.y >= y1 && p.x <= x2 && p.y <= y2) {
+            if (current.size() > 1) {
+                result.emplace_back(part.getWidth(), std::move(current), part.splitSize);
+            }
+            current.clear();
+        } else {
+            current.push_back(p);
         }
+    }
 
-        g_list_free(lists);
-    } else {
-        // no parts, all deleted
-        list->data = g_list_remove(list->data, part);
-        *deleteStrokeAfter = true;
+    if (current.size() > 1) {
+        result.emplace_back(part.getWidth(), std::move(current), part.splitSize);
     }
+}
 
-    return changed;
+auto EraseableStroke::isModified() -> bool {
+    const PartVector& parts = *this->parts;
+    if (parts.size() != 1 || !parts[0].isRange()) {
+        return true;
+    }
+    return parts[0].getBegin() != 0 || parts[0].getEnd() + 1 != this->stroke->getPointArray().size();
 }
 
-auto EraseableStroke::getStroke(Stroke* original) -> GList* {
-    GList* list = nullptr;
+auto EraseableStroke::getStroke(Stroke* original, vector<CopiedRange>& copied) -> vector<Stroke*> {
+    vector<Stroke*> strokes;
 
     Stroke* s = nullptr;
     Point lastPoint(NAN, NAN);
-    for (GList* l = this->parts->data; l != nullptr; l = l->next) {
-        auto* p = static_cast<EraseableStrokePart*>(l->data);
-        GList* points = p->getPoints();
-        if (g_list_length(points) < 2) {
-            continue;
-        }
 
-        Point a = *(static_cast<Point*>(g_list_first(points)->data));
-        Point b = *(static_cast<Point*>(g_list_last(points)->data));
-        a.z = p->width;
+    auto addSegment = [&](Point a, const Point& b, double width) {
+        a.z = width;
 
         if (!lastPoint.equalsPos(a) || s == nullptr) {
             if (s) {
@@ -314,14 +316,30 @@ auto EraseableStroke::getStroke(Stroke* original) -> GList* {
             s->setToolType(original->getToolType());
             s->setLineStyle(original->getLineStyle());
             s->setWidth(original->getWidth());
-            list = g_list_append(list, s);
+            strokes.push_back(s);
         }
         s->addPoint(a);
         lastPoint = b;
+    };
+
+    const PointArray& points = this->stroke->getPointArray();
+    for (const EraseableStrokePart& part: *this->parts) {
+        if (part.isRange()) {
+            for (size_t i = part.getBegin(); i < part.getEnd(); i++) {
+                addSegment(points[i], points[i + 1], points.getPressure(i));
+            }
+
+            // The segments of a range are added to the same stroke. The last point of the range is not reported, it
+            // may be merged with the start of the next segment
+            size_t offset = strokes.back()->getPointCount() - (part.getEnd() - part.getBegin());
+            copied.push_back({part.getBegin(), part.getEnd(), strokes.size() - 1, offset});
+        } else {
+            addSegment(part.getPoints().front(), part.getPoints().back(), part.getWidth());
+        }
     }
     if (s) {
         s->addPoint(lastPoint);
     }
 
-    return list;
+    return strokes;
 }
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -18,10 +19,9 @@
 
 #include "model/Point.h"
 
+#include "EraseableStrokePart.h"
 #include "XournalType.h"
 
-class EraseableStrokePart;
-class PartList;
 class Range;
 class Stroke;
 
@@ -30,26 +30,83 @@ public:
     EraseableStroke(Stroke* stroke);
     virtual ~EraseableStroke();
 
+private:
+    EraseableStroke(const EraseableStroke& stroke);
+    void operator=(const EraseableStroke& stroke);
+
 public:
     /**
      * Returns a repaint rectangle or nullptr, the rectangle is own by the caller
      */
     Range* erase(double x, double y, double halfEraserSize, Range* range = nullptr);
 
-    GList* getStroke(Stroke* original);
+    /**
+     * @return false if nothing was erased yet
+     */
+    bool isModified();
+
+    /**
+     * Unmodified points of the original stroke, which were copied to one of the new strokes
+     */
+    struct CopiedRange {
+        /**
+         * The points begin to end (exclusive) of the original stroke
+         */
+        size_t begin;
+        size_t end;
+
+        /**
+         * The index of the new stroke, and of the first copied point in it
+         */
+        size_t stroke;
+        size_t offset;
+    };
+
+    /**
+     * Creates the strokes which are left after erasing
+     *
+     * @param copied Where the unmodified points of the original stroke are in the new strokes, in ascending order
+     */
+    vector<Stroke*> getStroke(Stroke* original, vector<CopiedRange>& copied);
 
     void draw(cairo_t* cr);
 
 private:
-    void erase(double x, double y, double halfEraserSize, EraseableStrokePart* part, PartList* list);
-    static bool erasePart(double x, double y, double halfEraserSize, EraseableStrokePart* part, PartList* list,
-                          bool* deleteStrokeAfter);
+    using PartVector = vector<EraseableStrokePart>;
+
+    /**
+     * Erase from the part, the remaining parts are added to result
+     *
+     * @return false if the part is not touched by the eraser (and nothing was added to result)
+     */
+    bool erase(double x, double y, double halfEraserSize, const EraseableStrokePart& part, PartVector& result);
+
+    /**
+     * Erase from a segment, which is split up into own points for this
+     */
+    void eraseSegment(double x, double y, double halfEraserSize, const Point& a, const Point& b, PartVector& result);
+
+    /**
+     * Remove all points within the eraser, the remaining points are added as new parts
+     */
+    static void erasePoints(double x, double y, double halfEraserSize, const EraseableStrokePart& part,
+                            PartVector& result);
+
+    enum EraseHit { ERASE_HIT_NONE, ERASE_HIT_ALL, ERASE_HIT_PART };
+    static EraseHit hitTest(double x, double y, double halfEraserSize, const Point& a, const Point& b);
+
+    std::shared_ptr<const PartVector> getParts();
 
     void addRepaintRect(double x, double y, double width, double height);
 
 private:
+    /**
+     * The parts are never modified, erasing creates a new list which replaces the old one.
+     * Drawing (in the render thread) only takes a reference to the current list, so it does
+     * not need to copy anything.
+     */
     GMutex partLock{};
-    PartList* parts = nullptr;
+    std::shared_ptr<const PartVector> parts;
 
     Range* repaintRect = nullptr;
 
@@ -1,34 +1,27 @@
 #include "EraseableStrokePart.h"
 
-EraseableStrokePart::EraseableStrokePart(Point a, Point b) {
-    addPoint(a);
-    addPoint(b);
-    this->width = a.z;
-
-    this->splitSize = 0;
-
-    calcSize();
+#include <algorithm>
+#include <utility>
+
+#include "model/PointKernels.h"
+
+EraseableStrokePart::EraseableStrokePart(const PointArray& strokePoints, size_t begin, size_t end):
+        begin(begin), end(end) {
+    PointKernels::Bounds bounds = PointKernels::calcBounds(
+            strokePoints.getXData() + begin, strokePoints.getYData() + begin, nullptr, end - begin + 1, 0);
+    this->x = bounds.minX;
+    this->y = bounds.minY;
+    this->elementWidth = bounds.maxX - bounds.minX;
+    this->elementHeight = bounds.maxY - bounds.minY;
 }
 
-EraseableStrokePart::EraseableStrokePart(double width) {
-    this->points = nullptr;
-    this->width = width;
-    this->splitSize = 0;
-
-    calcSize();
+EraseableStrokePart::EraseableStrokePart(double width, vector<Point> points, double splitSize):
+        width(width), splitSize(splitSize), points(std::make_shared<vector<Point>>(std::move(points))) {
+    calcSize(this->points->data(), this->points->size());
 }
 
-EraseableStrokePart::~EraseableStrokePart() {
-    for (GList* l = this->points; l != nullptr; l = l->next) {
-        auto* p = static_cast<Point*>(l->data);
-        delete p;
-    }
-    g_list_free(this->points);
-    this->points = nullptr;
-}
-
-void EraseableStrokePart::calcSize() {
-    if (this->points == nullptr) {
+void EraseableStrokePart::calcSize(const Point* points, size_t count) {
+    if (count == 0) {
         this->x = 0;
         this->y = 0;
         this->elementWidth = 0;
@@ -36,17 +29,16 @@ void EraseableStrokePart::calcSize() {
         return;
     }
 
-    double x1 = (static_cast<Point*>(g_list_first(this->points)->data))->x;
-    double y1 = (static_cast<Point*>(g_list_first(this->points)->data))->y;
-    double x2 = (static_cast<Point*>(g_list_first(this->points)->data))->x;
-    double y2 = (static_cast<Point*>(g_list_first(this->points)->data))->y;
-
-    for (GList* l = this->points; l != nullptr; l = l->next) {
-        auto* p = static_cast<Point*>(l->data);
-        x1 = std::min(x1, p->x);
-        x2 = std::max(x2, p->x);
-        y1 = std::min(y1, p->y);
-        y2 = std::max(y2, p->y);
+    double x1 = points[0].x;
+    double y1 = points[0].y;
+    double x2 = points[0].x;
+    double y2 = points[0].y;
+
+    for (size_t i = 1; i < count; i++) {
+        x1 = std::min(x1, points[i].x);
+        x2 = std::max(x2, points[i].x);
+        y1 = std::min(y1, points[i].y);
+        y2 = std::max(y2, points[i].y);
     }
 
     this->x = x1;
@@ -55,17 +47,15 @@ void EraseableStrokePart::calcSize() {
     this->elementHeight = y2 - y1;
 }
 
-auto EraseableStrokePart::clone() -> EraseableStrokePart* {
-    auto* part = new EraseableStrokePart(this->width);
+auto EraseableStrokePart::isRange() const -> bool { return this->points == nullptr || this->points->empty(); }
 
-    for (GList* l = this->points; l != nullptr; l = l->next) {
-        auto* p = static_cast<Point*>(l->data);
-        part->addPoint(*p);
-    }
+auto EraseableStrokePart::getBegin() const -> size_t { return this->begin; }
 
-    part->splitSize = this->splitSize;
+auto EraseableStrokePart::getEnd() const -> size_t { return this->end; }
 
-    return part;
+auto EraseableStrokePart::getPoints() const -> const vector<Point>& {
+    static const vector<Point> noPoints;
+    return this->points ? *this->points : noPoints;
 }
 
 auto EraseableStrokePart::getX() const -> double { return this->x; }
@@ -76,49 +66,37 @@ auto EraseableStrokePart::getElementWidth() const -> double { return this->eleme
 
 auto EraseableStrokePart::getElementHeight() const -> double { return this->elementHeight; }
 
-void EraseableStrokePart::addPoint(Point p) {
-    calcSize();
-
-    this->points = g_list_append(this->points, new Point(p));
-}
-
 auto EraseableStrokePart::getWidth() const -> double { return this->width; }
 
-auto EraseableStrokePart::getPoints() -> GList* { return this->points; }
-
-void EraseableStrokePart::clearSplitData() {
-    for (GList* l = this->points->next; l->next != nullptr;) {
-        auto* p = static_cast<Point*>(l->data);
-        delete p;
-        GList* link = l;
-        l = l->next;
-
-        this->points = g_list_delete_link(this->points, link);
-    }
-}
-
 void EraseableStrokePart::splitFor(double halfEraserSize) {
-    if (halfEraserSize == this->splitSize) {
+    if (halfEraserSize == this->splitSize || this->points == nullptr || this->points->size() < 2) {
         return;
     }
 
     this->splitSize = halfEraserSize;
 
-    auto* a = static_cast<Point*>(g_list_first(this->points)->data);
-    auto* b = static_cast<Point*>(g_list_last(this->points)->data);
+    Point a = this->points->front();
+    Point b = this->points->back();
 
     // nothing to do, the size is enough small
-    if (a->lineLengthTo(*b) <= halfEraserSize) {
+    if (a.lineLengthTo(b) <= halfEraserSize) {
         return;
     }
 
-    clearSplitData();
-
-    double len = a->lineLengthTo(*b);
+    double len = a.lineLengthTo(b);
     halfEraserSize /= 2;
 
+    // Replaces the points of the last split, other copies of the part keep theirs
+    auto split = std::make_shared<vector<Point>>();
+    split->reserve(static_cast<size_t>(len / halfEraserSize) + 2);
+    split->push_back(b);
     while (len > halfEraserSize) {
-        this->points = g_list_insert(this->points, new Point(a->lineTo(*b, len)), 1);
+        split->push_back(a.lineTo(b, len));
         len -= halfEraserSize;
     }
+    split->push_back(a);
+
+    // The points were added from the end to the start
+    std::reverse(split->begin(), split->end());
+    this->points = std::move(split);
 }
@@ -11,48 +11,72 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "model/Point.h"
+#include "model/PointArray.h"
 
 #include "XournalType.h"
 
+/**
+ * A part of an eraseable stroke. This is either a range of unmodified points of the original
+ * stroke, which is only referenced by index, or the own points of a segment which was split
+ * up for the eraser.
+ *
+ * The own points are never modified, but replaced, so copies of a part share them. Copying the list of all parts of a
+ * stroke on each eraser event therefore only copies small values.
+ */
 class EraseableStrokePart {
 public:
-    EraseableStrokePart(Point a, Point b);
-    EraseableStrokePart(double width);
-    virtual ~EraseableStrokePart();
+    /**
+     * The unmodified points begin to end (inclusive) of the stroke, at least one segment
+     */
+    EraseableStrokePart(const PointArray& strokePoints, size_t begin, size_t end);
 
-private:
-    EraseableStrokePart(const EraseableStrokePart& part);
+    /**
+     * Own points, e.g. what is left of a segment after erasing
+     */
+    EraseableStrokePart(double width, vector<Point> points, double splitSize);
 
 public:
-    void addPoint(Point p);
-    double getWidth() const;
+    /**
+     * @return true if the part references the points of the stroke
+     */
+    bool isRange() const;
+    size_t getBegin() const;
+    size_t getEnd() const;
+
+    /**
+     * The own points, empty for a range
+     */
+    const vector<Point>& getPoints() const;
 
-    GList* getPoints();
+    double getWidth() const;
 
-    void clearSplitData();
+    /**
+     * Insert points, so the distance between two points is smaller than the eraser
+     */
     void splitFor(double halfEraserSize);
 
-    EraseableStrokePart* clone();
-
-    void calcSize();
-
 public:
     double getX() const;
     double getY() const;
     double getElementWidth() const;
     double getElementHeight() const;
 
-    static void printDebugStrokeParts();
+private:
+    void calcSize(const Point* points, size_t count);
 
 private:
-    double width = 0;
+    size_t begin = 0;
+    size_t end = 0;
+
+    double width = Point::NO_PRESSURE;
     double splitSize = 0;
 
-    GList* points = nullptr;
+    std::shared_ptr<const vector<Point>> points;
 
     double x = 0;
     double y = 0;
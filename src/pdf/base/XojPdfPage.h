@@ -45,6 +45,12 @@ public:
 
     virtual vector<XojPdfRectangle> findText(string& text) = 0;
 
+    /**
+     * Extract the text of the page, glyphs gets the bounding box of every character of the text
+     * (in the same coordinates as findText)
+     */
+    virtual string getTextLayout(vector<XojPdfRectangle>& glyphs) = 0;
+
     virtual int getPageId() = 0;
 
 private:
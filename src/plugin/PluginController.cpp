@@ -12,17 +12,7 @@
 #include "StringUtils.h"
 
 
-PluginController::PluginController(Control* control): control(control) {
-#ifdef ENABLE_PLUGINS
-    string path = control->getGladeSearchPath()->getFirstSearchPath();
-    if (StringUtils::endsWith(path, "ui")) {
-        path = path.substr(0, path.length() - 2) + "plugins";
-    } else {
-        path += "/../plugins";
-    }
-    loadPluginsFrom(path);
-#endif
-}
+PluginController::PluginController(Control* control): control(control) {}
 
 PluginController::~PluginController()
 #ifdef ENABLE_PLUGINS
@@ -40,6 +30,26 @@ PluginController::~PluginController()
 #endif
 
 
+void PluginController::loadPlugins() {
+    if (this->loaded) {
+        return;
+    }
+    this->loaded = true;
+
+#ifdef ENABLE_PLUGINS
+    string path = control->getGladeSearchPath()->getFirstSearchPath();
+    if (StringUtils::endsWith(path, "ui")) {
+        path = path.substr(0, path.length() - 2) + "plugins";
+    } else {
+        path += "/../plugins";
+    }
+    loadPluginsFrom(path);
+#endif
+
+    registerToolbar();
+    registerMenu();
+}
+
 /**
  * Load all plugins within this folder
  *
@@ -103,6 +113,8 @@ void PluginController::registerToolbar() {
  * Show Plugin manager Dialog
  */
 void PluginController::showPluginManager() {
+    loadPlugins();
+
     PluginDialog dlg(control->getGladeSearchPath(), control->getSettings());
     dlg.loadPluginList(this);
     dlg.show(control->getGtkWindow());
@@ -25,6 +25,12 @@ public:
     virtual ~PluginController();
 
 public:
+    /**
+     * Load the plugins and register their UI, only on the first call. This is not done in the constructor, so the
+     * plugins do not delay showing the main window
+     */
+    void loadPlugins();
+
     /**
      * Load all plugins within this folder
      *
@@ -62,4 +68,6 @@ private:
      * All loaded Plugins
      */
     vector<Plugin*> plugins;
+
+    bool loaded = false;
 };
@@ -39,9 +39,9 @@ auto AddUndoAction::redo(Control*) -> bool {
         return false;
     }
 
+    PageLayerPosEntry<Element>::insertIntoLayers(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->insertElement(e->element, e->pos);
         this->page->fireElementChanged(e->element);
     }
 
@@ -57,9 +57,9 @@ auto AddUndoAction::undo(Control*) -> bool {
         return false;
     }
 
+    PageLayerPosEntry<Element>::removeFromLayers(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->removeElement(e->element, false);
         this->page->fireElementChanged(e->element);
     }
 
@@ -29,6 +29,16 @@ void DeleteUndoAction::addElement(Layer* layer, Element* e, int pos) {
                                           reinterpret_cast<GCompareFunc>(PageLayerPosEntry<Element>::cmp));
 }
 
+auto DeleteUndoAction::getRemovedElements() -> vector<Element*> {
+    vector<Element*> removed;
+    if (!this->undone) {
+        for (GList* l = this->elements; l != nullptr; l = l->next) {
+            removed.push_back(static_cast<PageLayerPosEntry<Element>*>(l->data)->element);
+        }
+    }
+    return removed;
+}
+
 auto DeleteUndoAction::undo(Control*) -> bool {
     if (this->elements == nullptr) {
         g_warning("Could not undo DeleteUndoAction, there is nothing to undo");
@@ -37,9 +47,9 @@ auto DeleteUndoAction::undo(Control*) -> bool {
         return false;
     }
 
+    PageLayerPosEntry<Element>::insertIntoLayers(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->insertElement(e->element, e->pos);
         this->page->fireElementChanged(e->element);
     }
 
@@ -55,9 +65,9 @@ auto DeleteUndoAction::redo(Control*) -> bool {
         return false;
     }
 
+    PageLayerPosEntry<Element>::removeFromLayers(this->elements);
     for (GList* l = this->elements; l != nullptr; l = l->next) {
         auto e = static_cast<PageLayerPosEntry<Element>*>(l->data);
-        e->layer->removeElement(e->element, false);
         this->page->fireElementChanged(e->element);
     }
 
@@ -32,6 +32,8 @@ public:
 
     void addElement(Layer* layer, Element* e, int pos);
 
+    vector<Element*> getRemovedElements() override;
+
     string getText() override;
 
 private:
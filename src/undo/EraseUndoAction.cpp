@@ -1,107 +1,225 @@
 #include "EraseUndoAction.h"
 
+#include <algorithm>
+#include <map>
+
 #include "gui/Redrawable.h"
 #include "model/Layer.h"
 #include "model/Stroke.h"
-#include "model/eraser/EraseableStroke.h"
+#include "serializing/ObjectInputStream.h"
+#include "serializing/ObjectOutputStream.h"
 
-#include "PageLayerPosEntry.h"
 #include "i18n.h"
 
 EraseUndoAction::EraseUndoAction(const PageRef& page): UndoAction("EraseUndoAction") { this->page = page; }
 
 EraseUndoAction::~EraseUndoAction() {
-    for (GList* l = this->original; l != nullptr; l = l->next) {
-        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
-        if (!undone) {
-            delete e->element;
+    // The original strokes are only deleted with their points freed, the new strokes still have theirs
+    for (PageLayerPosEntry<Stroke>& e: this->undone ? this->edited : this->original) {
+        delete e.element;
+    }
+}
+
+void EraseUndoAction::addOriginal(Layer* layer, Stroke* element, int pos) {
+    this->original.emplace_back(layer, element, pos);
+}
+
+void EraseUndoAction::finalize() {
+    for (PageLayerPosEntry<Stroke>& entry: this->original) {
+        entry.pos = entry.layer->indexOf(entry.element);
+    }
+    std::stable_sort(this->original.begin(), this->original.end(),
+                     [](const PageLayerPosEntry<Stroke>& a, const PageLayerPosEntry<Stroke>& b) {
+                         return a.pos < b.pos;
+                     });
+
+    vector<PageLayerPosEntry<Stroke>> erased;
+
+    // Each stroke is replaced by what is left of it, which moves the following strokes of the layer
+    std::map<Layer*, int> shift;
+
+    for (PageLayerPosEntry<Stroke>& entry: this->original) {
+        Stroke* s = entry.element;
+        EraseableStroke* e = s->getEraseable();
+        s->setEraseable(nullptr);
+
+        if (!e->isModified()) {
+            // Touched by the eraser, but nothing was erased
+            delete e;
+            continue;
         }
+
+        StrokeDelta delta;
+        vector<Stroke*> strokes = e->getStroke(s, delta.copied);
         delete e;
+
+        int& layerShift = shift[entry.layer];
+        delta.firstEdited = this->edited.size();
+        for (size_t i = 0; i < strokes.size(); i++) {
+            this->edited.emplace_back(entry.layer, strokes[i], entry.pos + layerShift + i);
+        }
+        layerShift += static_cast<int>(strokes.size()) - 1;
+
+        // The points which are not copied to the new strokes
+        const PointArray& points = s->getPointArray();
+        size_t next = 0;
+        for (const EraseableStroke::CopiedRange& range: delta.copied) {
+            for (size_t i = next; i < range.begin; i++) {
+                delta.removed.push_back(points[i]);
+            }
+            next = range.end;
+        }
+        for (size_t i = next; i < points.size(); i++) {
+            delta.removed.push_back(points[i]);
+        }
+
+        erased.push_back(entry);
+        this->deltas.push_back(std::move(delta));
+    }
+
+    this->original = std::move(erased);
+
+    PageLayerPosEntry<Stroke>::removeFromLayers(this->original);
+    PageLayerPosEntry<Stroke>::insertIntoLayers(this->edited);
+
+    for (size_t i = 0; i < this->original.size(); i++) {
+        freePoints(i);
+    }
+
+    this->page->firePageChanged();
+}
+
+void EraseUndoAction::freePoints(size_t index) {
+    if (index >= this->deltas.size()) {
+        // Not finalized yet
+        return;
+    }
+
+    Stroke* s = this->original[index].element;
+    StrokeDelta& delta = this->deltas[index];
+
+    // Points in an arena are only freed with the arena
+    if (delta.freed || s->getPointArray().getArena() != nullptr) {
+        return;
     }
-    g_list_free(this->original);
-    this->original = nullptr;
 
-    for (GList* l = this->edited; l != nullptr; l = l->next) {
-        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
-        if (undone) {
-            delete e->element;
+    s->deletePointsFrom(0);
+    s->freeUnusedPointItems();
+    delta.freed = true;
+}
+
+void EraseUndoAction::restorePoints(size_t index) {
+    if (index >= this->deltas.size()) {
+        return;
+    }
+
+    StrokeDelta& delta = this->deltas[index];
+    if (!delta.freed) {
+        return;
+    }
+
+    vector<Point> points;
+    size_t removed = 0;
+    for (const EraseableStroke::CopiedRange& range: delta.copied) {
+        while (points.size() < range.begin) {
+            points.push_back(delta.removed[removed++]);
         }
-        delete e;
+
+        const PointArray& copy = this->edited[delta.firstEdited + range.stroke].element->getPointArray();
+        for (size_t i = 0; i < range.end - range.begin; i++) {
+            points.push_back(copy[range.offset + i]);
+        }
+    }
+    while (removed < delta.removed.size()) {
+        points.push_back(delta.removed[removed++]);
     }
-    g_list_free(this->edited);
-    this->edited = nullptr;
+
+    this->original[index].element->addPoints(points);
+    delta.freed = false;
 }
 
-void EraseUndoAction::addOriginal(Layer* layer, Stroke* element, int pos) {
-    this->original = g_list_insert_sorted(this->original, new PageLayerPosEntry<Stroke>(layer, element, pos),
-                                          reinterpret_cast<GCompareFunc>(PageLayerPosEntry<Stroke>::cmp));
+auto EraseUndoAction::getRemovedElements() -> vector<Element*> {
+    vector<Element*> removed;
+    for (PageLayerPosEntry<Stroke>& e: this->undone ? this->edited : this->original) {
+        removed.push_back(e.element);
+    }
+    return removed;
 }
 
-void EraseUndoAction::addEdited(Layer* layer, Stroke* element, int pos) {
-    this->edited = g_list_insert_sorted(this->edited, new PageLayerPosEntry<Stroke>(layer, element, pos),
-                                        reinterpret_cast<GCompareFunc>(PageLayerPosEntry<Stroke>::cmp));
+auto EraseUndoAction::getMemoryUsage() -> size_t {
+    size_t usage = UndoAction::getMemoryUsage();
+    for (const StrokeDelta& delta: this->deltas) {
+        usage += sizeof(StrokeDelta) + delta.copied.capacity() * sizeof(EraseableStroke::CopiedRange) +
+                 delta.removed.getMemoryUsage();
+    }
+    return usage;
 }
 
-void EraseUndoAction::removeEdited(Stroke* element) {
-    for (GList* l = this->edited; l != nullptr; l = l->next) {
-        auto* p = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
-        if (p->element == element) {
-            this->edited = g_list_delete_link(this->edited, l);
-            delete p;
-            p = nullptr;
-            return;
+auto EraseUndoAction::serializeRemovedData(ObjectOutputStream& out) -> bool {
+    bool written = UndoAction::serializeRemovedData(out);
+
+    vector<size_t> freeable;
+    for (size_t i = 0; i < this->deltas.size(); i++) {
+        if (!this->deltas[i].removed.empty()) {
+            freeable.push_back(i);
         }
     }
+
+    out.writeObject("EraseUndoAction");
+    out.writeInt(freeable.size());
+    for (size_t i: freeable) {
+        std::vector<Point> points = this->deltas[i].removed.toVector();
+        out.writeInt(i);
+        out.writeData(points.data(), points.size(), sizeof(Point));
+    }
+    out.endObject();
+
+    return written || !freeable.empty();
 }
 
-void EraseUndoAction::finalize() {
-    for (GList* l = this->original; l != nullptr;) {
-        auto* p = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
-        GList* del = l;
-        l = l->next;
-
-        if (p->element->getPointCount() == 0) {
-            this->edited = g_list_delete_link(this->edited, del);
-            delete p;
-            p = nullptr;
-        } else {
-
-            // Remove the original and add the copy
-            int pos = p->layer->removeElement(p->element, false);
-
-            EraseableStroke* e = p->element->getEraseable();
-            GList* stroke = e->getStroke(p->element);
-            for (GList* ls = stroke; ls != nullptr; ls = ls->next) {
-                auto* copy = static_cast<Stroke*>(ls->data);
-                p->layer->insertElement(copy, pos);
-                this->addEdited(p->layer, copy, pos);
-                pos++;
-            }
+void EraseUndoAction::freeRemovedData() {
+    UndoAction::freeRemovedData();
 
-            delete e;
-            e = nullptr;
-            p->element->setEraseable(nullptr);
-        }
+    for (StrokeDelta& delta: this->deltas) {
+        delta.removed = PointArray();
     }
+}
 
-    this->page->firePageChanged();
+void EraseUndoAction::readRemovedData(ObjectInputStream& in) {
+    UndoAction::readRemovedData(in);
+
+    in.readObject("EraseUndoAction");
+    int count = in.readInt();
+    for (int i = 0; i < count; i++) {
+        size_t index = in.readInt();
+        if (index >= this->deltas.size()) {
+            throw InputStreamException("The erased strokes of the undo action changed", __FILE__, __LINE__);
+        }
+
+        Point* p{};
+        int length{};
+        in.readData(reinterpret_cast<void**>(&p), &length);
+        this->deltas[index].removed.assign(p, length);
+        g_free(p);
+    }
+    in.endObject();
 }
 
 auto EraseUndoAction::getText() -> string { return _("Erase stroke"); }
 
 auto EraseUndoAction::undo(Control* control) -> bool {
-    for (GList* l = this->edited; l != nullptr; l = l->next) {
-        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
-
-        e->layer->removeElement(e->element, false);
-        this->page->fireElementChanged(e->element);
+    PageLayerPosEntry<Stroke>::removeFromLayers(this->edited);
+    for (PageLayerPosEntry<Stroke>& e: this->edited) {
+        this->page->fireElementChanged(e.element);
     }
 
-    for (GList* l = this->original; l != nullptr; l = l->next) {
-        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
+    for (size_t i = 0; i < this->original.size(); i++) {
+        restorePoints(i);
+    }
 
-        e->layer->insertElement(e->element, e->pos);
-        this->page->fireElementChanged(e->element);
+    PageLayerPosEntry<Stroke>::insertIntoLayers(this->original);
+    for (PageLayerPosEntry<Stroke>& e: this->original) {
+        this->page->fireElementChanged(e.element);
     }
 
     this->undone = true;
@@ -109,18 +227,18 @@ auto EraseUndoAction::undo(Control* control) -> bool {
 }
 
 auto EraseUndoAction::redo(Control* control) -> bool {
-    for (GList* l = this->original; l != nullptr; l = l->next) {
-        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
-
-        e->layer->removeElement(e->element, false);
-        this->page->fireElementChanged(e->element);
+    PageLayerPosEntry<Stroke>::removeFromLayers(this->original);
+    for (PageLayerPosEntry<Stroke>& e: this->original) {
+        this->page->fireElementChanged(e.element);
     }
 
-    for (GList* l = this->edited; l != nullptr; l = l->next) {
-        auto* e = static_cast<PageLayerPosEntry<Stroke>*>(l->data);
+    for (size_t i = 0; i < this->original.size(); i++) {
+        freePoints(i);
+    }
 
-        e->layer->insertElement(e->element, e->pos);
-        this->page->fireElementChanged(e->element);
+    PageLayerPosEntry<Stroke>::insertIntoLayers(this->edited);
+    for (PageLayerPosEntry<Stroke>& e: this->edited) {
+        this->page->fireElementChanged(e.element);
     }
 
     this->undone = false;
@@ -14,6 +14,10 @@
 #include <string>
 #include <vector>
 
+#include "model/PointArray.h"
+#include "model/eraser/EraseableStroke.h"
+
+#include "PageLayerPosEntry.h"
 #include "UndoAction.h"
 #include "XournalType.h"
 
@@ -31,14 +35,49 @@ public:
     virtual bool redo(Control* control);
 
     void addOriginal(Layer* layer, Stroke* element, int pos);
-    void addEdited(Layer* layer, Stroke* element, int pos);
-    void removeEdited(Stroke* element);
 
+    /**
+     * Replaces the erased strokes by what is left of them
+     */
     void finalize();
 
     virtual string getText();
 
+    virtual vector<Element*> getRemovedElements();
+    virtual size_t getMemoryUsage();
+
+    /**
+     * The erased points of the deltas are written and freed, too
+     */
+    virtual bool serializeRemovedData(ObjectOutputStream& out);
+    virtual void freeRemovedData();
+    virtual void readRemovedData(ObjectInputStream& in);
+
+private:
+    void freePoints(size_t index);
+    void restorePoints(size_t index);
+
 private:
-    GList* edited = nullptr;
-    GList* original = nullptr;
+    /**
+     * The points of an original stroke are freed while it is not part of the document. They are restored from the
+     * unmodified ranges, which were copied to the new strokes, and the other points which are stored here.
+     */
+    struct StrokeDelta {
+        /**
+         * The index of the first new stroke in edited
+         */
+        size_t firstEdited = 0;
+        vector<EraseableStroke::CopiedRange> copied;
+        PointArray removed;
+        bool freed = false;
+    };
+
+    vector<PageLayerPosEntry<Stroke>> original;
+
+    /**
+     * One for each original stroke
+     */
+    vector<StrokeDelta> deltas;
+
+    vector<PageLayerPosEntry<Stroke>> edited;
 };
@@ -79,8 +79,8 @@ InsertsUndoAction::~InsertsUndoAction() {
 auto InsertsUndoAction::getText() -> string { return _("Insert elements"); }
 
 auto InsertsUndoAction::undo(Control* control) -> bool {
+    this->layer->removeElements(this->elements, false);
     for (Element* elem: this->elements) {
-        this->layer->removeElement(elem, false);
         this->page->fireElementChanged(elem);
     }
 
@@ -66,8 +66,8 @@ auto MoveUndoAction::redo(Control* control) -> bool {
 }
 
 void MoveUndoAction::switchLayer(vector<Element*>* entries, Layer* oldLayer, Layer* newLayer) {
+    oldLayer->removeElements(this->elements, false);
     for (Element* e: this->elements) {
-        oldLayer->removeElement(e, false);
         newLayer->addElement(e);
     }
 }
@@ -11,6 +11,14 @@
 
 #pragma once
 
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+
+#include "model/Layer.h"
+
 template <class T>
 class PageLayerPosEntry {
 public:
@@ -29,4 +37,56 @@ public:
     int pos;
 
     static int cmp(PageLayerPosEntry<T>* a, PageLayerPosEntry<T>* b) { return a->pos - b->pos; }
+
+    /**
+     * Inserts the elements of a list of entries at their positions, with one pass per layer
+     */
+    static void insertIntoLayers(GList* entries) {
+        std::map<Layer*, std::vector<std::pair<Element*, Layer::ElementIndex>>> layers;
+        for (GList* l = entries; l != nullptr; l = l->next) {
+            auto* e = static_cast<PageLayerPosEntry<T>*>(l->data);
+            layers[e->layer].emplace_back(e->element, e->pos);
+        }
+
+        for (auto& [layer, elements]: layers) {
+            layer->insertElements(elements);
+        }
+    }
+
+    static void insertIntoLayers(const std::vector<PageLayerPosEntry<T>>& entries) {
+        std::map<Layer*, std::vector<std::pair<Element*, Layer::ElementIndex>>> layers;
+        for (const PageLayerPosEntry<T>& e: entries) {
+            layers[e.layer].emplace_back(e.element, e.pos);
+        }
+
+        for (auto& [layer, elements]: layers) {
+            layer->insertElements(elements);
+        }
+    }
+
+    /**
+     * Removes the elements of a list of entries from their layers, with one pass per layer
+     */
+    static void removeFromLayers(GList* entries) {
+        std::map<Layer*, std::vector<Element*>> layers;
+        for (GList* l = entries; l != nullptr; l = l->next) {
+            auto* e = static_cast<PageLayerPosEntry<T>*>(l->data);
+            layers[e->layer].push_back(e->element);
+        }
+
+        for (auto& [layer, elements]: layers) {
+            layer->removeElements(elements, false);
+        }
+    }
+
+    static void removeFromLayers(const std::vector<PageLayerPosEntry<T>>& entries) {
+        std::map<Layer*, std::vector<Element*>> layers;
+        for (const PageLayerPosEntry<T>& e: entries) {
+            layers[e.layer].push_back(e.element);
+        }
+
+        for (auto& [layer, elements]: layers) {
+            layer->removeElements(elements, false);
+        }
+    }
 };
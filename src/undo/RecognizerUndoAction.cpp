@@ -70,3 +70,10 @@ auto RecognizerUndoAction::redo(Control* control) -> bool {
 }
 
 auto RecognizerUndoAction::getText() -> string { return _("Stroke recognizer"); }
+
+auto RecognizerUndoAction::getRemovedElements() -> vector<Element*> {
+    if (this->undone) {
+        return {this->recognized};
+    }
+    return vector<Element*>(this->original.begin(), this->original.end());
+}
@@ -30,6 +30,8 @@ public:
 
     virtual string getText();
 
+    virtual vector<Element*> getRemovedElements();
+
 private:
     Layer* layer;
     Stroke* recognized;
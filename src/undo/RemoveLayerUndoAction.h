@@ -27,6 +27,8 @@ public:
 
     virtual string getText();
 
+    virtual vector<Element*> getRemovedElements();
+
 private:
     LayerController* layerController;
     Layer* layer;
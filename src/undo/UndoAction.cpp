@@ -1,5 +1,12 @@
 #include "UndoAction.h"
 
+#include "model/Image.h"
+#include "model/Stroke.h"
+#include "model/TexImage.h"
+#include "model/Text.h"
+#include "serializing/ObjectInputStream.h"
+#include "serializing/ObjectOutputStream.h"
+
 #include "Rectangle.h"
 
 UndoAction::UndoAction(std::string className): className(std::move(className)) {}
@@ -11,3 +18,104 @@ auto UndoAction::getPages() -> std::vector<PageRef> {
 }
 
 auto UndoAction::getClassName() const -> std::string const& { return this->className; }
+
+auto UndoAction::getRemovedElements() -> vector<Element*> { return {}; }
+
+/**
+ * Only the data of strokes with points on the heap, images and TeX images is freed, points in an arena are only freed
+ * with the arena
+ */
+static auto isFreeable(Element* e) -> bool {
+    switch (e->getType()) {
+        case ELEMENT_STROKE: {
+            const PointArray& points = static_cast<Stroke*>(e)->getPointArray();
+            return points.getArena() == nullptr && points.size() > 0;
+        }
+        case ELEMENT_IMAGE:
+            return static_cast<Image*>(e)->getMemoryUsage() > 0;
+        case ELEMENT_TEXIMAGE:
+            return !static_cast<TexImage*>(e)->getBinaryData().empty();
+        default:
+            return false;
+    }
+}
+
+static auto getElementMemoryUsage(Element* e) -> size_t {
+    switch (e->getType()) {
+        case ELEMENT_STROKE: {
+            const PointArray& points = static_cast<Stroke*>(e)->getPointArray();
+            return sizeof(Stroke) + (points.getArena() ? 0 : points.getMemoryUsage());
+        }
+        case ELEMENT_TEXT:
+            return sizeof(Text) + static_cast<Text*>(e)->getText().size();
+        case ELEMENT_IMAGE:
+            return sizeof(Image) + static_cast<Image*>(e)->getMemoryUsage();
+        case ELEMENT_TEXIMAGE:
+            return sizeof(TexImage) + static_cast<TexImage*>(e)->getMemoryUsage();
+        default:
+            return sizeof(Element);
+    }
+}
+
+auto UndoAction::getMemoryUsage() -> size_t {
+    size_t usage = sizeof(UndoAction);
+    for (Element* e: getRemovedElements()) {
+        usage += getElementMemoryUsage(e);
+    }
+    return usage;
+}
+
+auto UndoAction::serializeRemovedData(ObjectOutputStream& out) -> bool {
+    vector<Element*> elements = getRemovedElements();
+
+    vector<int> freeable;
+    for (size_t i = 0; i < elements.size(); i++) {
+        if (isFreeable(elements[i])) {
+            freeable.push_back(i);
+        }
+    }
+
+    out.writeObject("UndoAction");
+    out.writeInt(freeable.size());
+    for (int i: freeable) {
+        out.writeInt(i);
+        elements[i]->serialize(out);
+    }
+    out.endObject();
+
+    return !freeable.empty();
+}
+
+void UndoAction::freeRemovedData() {
+    for (Element* e: getRemovedElements()) {
+        if (!isFreeable(e)) {
+            continue;
+        }
+
+        if (e->getType() == ELEMENT_STROKE) {
+            auto* s = static_cast<Stroke*>(e);
+            s->deletePointsFrom(0);
+            s->freeUnusedPointItems();
+        } else if (e->getType() == ELEMENT_IMAGE) {
+            static_cast<Image*>(e)->setImage(string());
+        } else if (e->getType() == ELEMENT_TEXIMAGE) {
+            static_cast<TexImage*>(e)->freeBinaryData();
+        }
+    }
+}
+
+void UndoAction::readRemovedData(ObjectInputStream& in) {
+    vector<Element*> elements = getRemovedElements();
+
+    in.readObject("UndoAction");
+    int count = in.readInt();
+    for (int i = 0; i < count; i++) {
+        size_t index = in.readInt();
+        if (index >= elements.size()) {
+            throw InputStreamException("The removed elements of the undo action changed", __FILE__, __LINE__);
+        }
+        // Throws if the type of the element changed
+        elements[index]->readSerialized(in);
+    }
+    in.endObject();
+}
@@ -16,6 +16,9 @@
 #include "config.h"
 
 class Control;
+class Element;
+class ObjectInputStream;
+class ObjectOutputStream;
 class XojPage;
 
 class UndoAction {
@@ -36,6 +39,34 @@ public:
 
     auto getClassName() const -> std::string const&;
 
+    /**
+     * The elements which were removed from the document by this action, and are only kept for undo
+     */
+    virtual vector<Element*> getRemovedElements();
+
+    /**
+     * @return The approximate memory in bytes which is freed with this action
+     */
+    virtual size_t getMemoryUsage();
+
+    /**
+     * Write the data of the removed elements which can be freed (points of strokes, images), so it can be freed with
+     * freeRemovedData()
+     *
+     * @return false if there is nothing to free
+     */
+    virtual bool serializeRemovedData(ObjectOutputStream& out);
+
+    /**
+     * Free the data written by serializeRemovedData(), to limit the memory of old actions
+     */
+    virtual void freeRemovedData();
+
+    /**
+     * Read the data freed by freeRemovedData(), before the action is undone
+     */
+    virtual void readRemovedData(ObjectInputStream& in);
+
 protected:
     // This is only for debugging / Testing purpose
     std::string className;
@@ -4,6 +4,9 @@
 #include <cinttypes>
 
 #include "control/Control.h"
+#include "serializing/BinObjectEncoding.h"
+#include "serializing/ObjectInputStream.h"
+#include "serializing/ObjectOutputStream.h"
 
 #include "XojMsgBox.h"
 #include "config.h"
@@ -36,6 +39,11 @@ inline void printUndoList(std::deque<PtrType> list) {
     }
 }
 
+/**
+ * Default limit for the memory of the undo history, before old actions are written to a file
+ */
+constexpr size_t DEFAULT_MEMORY_LIMIT = 256 * 1024 * 1024;
+
 #ifdef UNDO_TRACE
 constexpr bool UNDO_TRACE = true;
 #else
@@ -57,7 +65,7 @@ void UndoRedoHandler::printContents() {
     }
 }
 
-UndoRedoHandler::UndoRedoHandler(Control* control): control(control) {}
+UndoRedoHandler::UndoRedoHandler(Control* control): memoryLimit(DEFAULT_MEMORY_LIMIT), control(control) {}
 
 UndoRedoHandler::~UndoRedoHandler() { clearContents(); }
 
@@ -72,6 +80,12 @@ void UndoRedoHandler::clearContents() {
     undoList.clear();
     clearRedo();
 
+    this->actionMemory.clear();
+    this->memoryUsage = 0;
+    this->spilled.clear();
+    this->spilledCount = 0;
+    this->spillFile.clear();
+
     this->savedUndo = nullptr;
     this->autosavedUndo = nullptr;
 
@@ -98,11 +112,11 @@ void UndoRedoHandler::undo() {
     auto& undoAction = *this->undoList.back();
     this->redoList.emplace_back(std::move(this->undoList.back()));
     this->undoList.pop_back();
+    loadLastAction();
 
-    Document* doc = control->getDocument();
-    doc->lock();
+    lockDocument();
     bool undoResult = undoAction.undo(this->control);
-    doc->unlock();
+    unlockDocument();
 
     if (!undoResult) {
         string msg = FS(_F("Could not undo \"{1}\"\n"
@@ -125,13 +139,13 @@ void UndoRedoHandler::redo() {
 
     UndoAction& redoAction = *this->redoList.back();
 
-    this->undoList.emplace_back(std::move(this->redoList.back()));
+    UndoActionPtr action = std::move(this->redoList.back());
     this->redoList.pop_back();
+    pushUndoAction(std::move(action));
 
-    Document* doc = control->getDocument();
-    doc->lock();
+    lockDocument();
     bool redoResult = redoAction.redo(this->control);
-    doc->unlock();
+    unlockDocument();
 
     if (!redoResult) {
         string msg = FS(_F("Could not redo \"{1}\"\n"
@@ -145,6 +159,21 @@ void UndoRedoHandler::redo() {
     printContents();
 }
 
+/**
+ * The document is locked while an action is undone or redone. There is no document without a control, in tests
+ */
+void UndoRedoHandler::lockDocument() {
+    if (this->control) {
+        this->control->getDocument()->lock();
+    }
+}
+
+void UndoRedoHandler::unlockDocument() {
+    if (this->control) {
+        this->control->getDocument()->unlock();
+    }
+}
+
 auto UndoRedoHandler::canUndo() -> bool { return !this->undoList.empty(); }
 
 auto UndoRedoHandler::canRedo() -> bool { return !this->redoList.empty(); }
@@ -157,7 +186,7 @@ void UndoRedoHandler::addUndoAction(UndoActionPtr action) {
         return;
     }
 
-    this->undoList.emplace_back(std::move(action));
+    pushUndoAction(std::move(action));
     clearRedo();
     fireUpdateUndoRedoButtons(this->undoList.back()->getPages());
 
@@ -172,7 +201,14 @@ void UndoRedoHandler::addUndoActionBefore(UndoActionPtr action, UndoAction* befo
         addUndoAction(std::move(action));
         return;
     }
+    if (static_cast<size_t>(iter - begin(this->undoList)) < this->spilledCount) {
+        // Part of the spilled actions, but kept in memory
+        this->spilledCount++;
+    }
+    accountMemory(action.get());
+
     this->undoList.emplace(iter, std::move(action));
+    limitMemoryUsage();
     clearRedo();
     fireUpdateUndoRedoButtons(this->undoList.back()->getPages());
 
@@ -185,12 +221,130 @@ auto UndoRedoHandler::removeUndoAction(UndoAction* action) -> bool {
     if (iter == end(this->undoList)) {
         return false;
     }
-    this->undoList.erase(iter);
+
+    vector<PageRef> pages = action->getPages();
+    size_t index = iter - begin(this->undoList);
+    if (index + 1 == this->undoList.size()) {
+        this->undoList.erase(iter);
+        loadLastAction();
+    } else {
+        if (index < this->spilledCount) {
+            auto it = this->spilled.find(action);
+            if (it != this->spilled.end()) {
+                this->spillFile.free(it->second);
+                this->spilled.erase(it);
+            }
+            this->spilledCount--;
+        }
+        unaccountMemory(action);
+        this->undoList.erase(iter);
+    }
+
     clearRedo();
-    fireUpdateUndoRedoButtons(action->getPages());
+    fireUpdateUndoRedoButtons(pages);
     return true;
 }
 
+/**
+ * Appends an action to the undo list, the previous last action is accounted now, it's not changed anymore
+ */
+void UndoRedoHandler::pushUndoAction(UndoActionPtr action) {
+    if (!this->undoList.empty()) {
+        accountMemory(this->undoList.back().get());
+    }
+    this->undoList.emplace_back(std::move(action));
+    limitMemoryUsage();
+}
+
+/**
+ * Called if the last action was removed from the undo list, the new last action is loaded, as it may be undone next
+ */
+void UndoRedoHandler::loadLastAction() {
+    if (this->undoList.empty()) {
+        return;
+    }
+
+    UndoAction* last = this->undoList.back().get();
+    unaccountMemory(last);
+    if (this->spilledCount == this->undoList.size()) {
+        restoreAction(last);
+        this->spilledCount--;
+    }
+}
+
+void UndoRedoHandler::accountMemory(UndoAction* action) {
+    size_t usage = action->getMemoryUsage();
+    this->actionMemory[action] = usage;
+    this->memoryUsage += usage;
+}
+
+void UndoRedoHandler::unaccountMemory(UndoAction* action) {
+    auto it = this->actionMemory.find(action);
+    if (it != this->actionMemory.end()) {
+        this->memoryUsage -= it->second;
+        this->actionMemory.erase(it);
+    }
+}
+
+/**
+ * Spills the oldest actions until the accounted memory is below the limit
+ */
+void UndoRedoHandler::limitMemoryUsage() {
+    while (this->memoryUsage > this->memoryLimit && this->spilledCount + 1 < this->undoList.size()) {
+        UndoAction* action = this->undoList[this->spilledCount].get();
+        unaccountMemory(action);
+        spillAction(action);
+        // Only what was freed is subtracted
+        accountMemory(action);
+        this->spilledCount++;
+    }
+}
+
+void UndoRedoHandler::spillAction(UndoAction* action) {
+    ObjectOutputStream out(new BinObjectEncoding());
+    if (!action->serializeRemovedData(out)) {
+        return;
+    }
+
+    UndoSpillFile::Entry entry;
+    if (!this->spillFile.write(out.getStr(), entry)) {
+        // Keep the action in memory
+        return;
+    }
+
+    action->freeRemovedData();
+    this->spilled[action] = entry;
+}
+
+void UndoRedoHandler::restoreAction(UndoAction* action) {
+    auto it = this->spilled.find(action);
+    if (it == this->spilled.end()) {
+        return;
+    }
+
+    string data;
+    if (this->spillFile.read(it->second, data)) {
+        ObjectInputStream in;
+        try {
+            if (in.read(data.c_str(), data.size())) {
+                action->readRemovedData(in);
+            }
+        } catch (InputStreamException& e) {
+            g_warning("Could not read undo action %s: %s", action->getClassName().c_str(), e.what());
+        }
+    }
+
+    this->spillFile.free(it->second);
+    this->spilled.erase(it);
+}
+
+void UndoRedoHandler::setMemoryLimit(size_t limit) {
+    this->memoryLimit = limit;
+    limitMemoryUsage();
+}
+
+auto UndoRedoHandler::getMemoryUsage() const -> size_t { return this->memoryUsage; }
+
 auto UndoRedoHandler::undoDescription() -> string {
     if (!this->undoList.empty()) {
         UndoAction& a = *this->undoList.back();
@@ -15,9 +15,11 @@
 #include <memory>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "UndoAction.h"
+#include "UndoSpillFile.h"
 #include "XournalType.h"
 
 class Control;
@@ -55,6 +57,16 @@ public:
     void fireUpdateUndoRedoButtons(const vector<PageRef>& pages);
     void addUndoRedoListener(UndoRedoListener* listener);
 
+    /**
+     * Old actions are written to a temporary file if the undo history uses more memory
+     */
+    void setMemoryLimit(size_t limit);
+
+    /**
+     * @return The approximate memory of the actions in the undo list which are not written to the file
+     */
+    size_t getMemoryUsage() const;
+
     bool isChanged();
     bool isChangedAutosave();
     void documentAutosaved();
@@ -64,6 +76,18 @@ private:
     void clearRedo();
     void printContents();
 
+    void lockDocument();
+    void unlockDocument();
+
+    void pushUndoAction(UndoActionPtr action);
+    void loadLastAction();
+
+    void accountMemory(UndoAction* action);
+    void unaccountMemory(UndoAction* action);
+    void limitMemoryUsage();
+    void spillAction(UndoAction* action);
+    void restoreAction(UndoAction* action);
+
 private:
     std::deque<UndoActionPtr> undoList;
     std::deque<UndoActionPtr> redoList;
@@ -73,5 +97,21 @@ private:
 
     std::vector<UndoRedoListener*> listener;
 
+    size_t memoryLimit;
+    size_t memoryUsage = 0;
+
+    /**
+     * The memory of the accounted actions, which are all actions of the undo list except the last action: it may still
+     * be extended, e.g. by the eraser. Spilled actions only account the memory which was not freed.
+     */
+    std::unordered_map<UndoAction*, size_t> actionMemory;
+
+    /**
+     * The first spilledCount actions of the undo list were written to the spill file, if they had anything to write
+     */
+    size_t spilledCount = 0;
+    std::unordered_map<UndoAction*, UndoSpillFile::Entry> spilled;
+    UndoSpillFile spillFile;
+
     Control* control = nullptr;
 };
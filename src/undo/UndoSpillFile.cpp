@@ -0,0 +1,113 @@
+#include "UndoSpillFile.h"
+
+#include <iterator>
+
+#include "Util.h"
+
+UndoSpillFile::UndoSpillFile() = default;
+
+UndoSpillFile::~UndoSpillFile() { clear(); }
+
+auto UndoSpillFile::write(const GString* data, Entry& entry) -> bool {
+    if (!this->file.is_open()) {
+        this->path = Util::getTmpDirSubfolder("undo") / "undo.bin";
+        this->file.open(this->path.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        this->size = 0;
+        this->freeRegions.clear();
+
+        if (!this->file.is_open()) {
+            g_warning("Could not create undo file \"%s\"", this->path.c_str());
+            return false;
+        }
+    }
+
+    // First fit, the file only grows if no freed region is large enough
+    auto region = this->freeRegions.begin();
+    while (region != this->freeRegions.end() && region->second < data->len) {
+        region++;
+    }
+    size_t offset = region != this->freeRegions.end() ? region->first : this->size;
+
+    this->file.seekp(offset);
+    this->file.write(data->str, data->len);
+    if (!this->file.good()) {
+        g_warning("Could not write undo file \"%s\"", this->path.c_str());
+        this->file.clear();
+        return false;
+    }
+
+    if (region != this->freeRegions.end()) {
+        size_t rest = region->second - data->len;
+        this->freeRegions.erase(region);
+        if (rest > 0) {
+            this->freeRegions[offset + data->len] = rest;
+        }
+    } else {
+        this->size += data->len;
+    }
+
+    entry.offset = offset;
+    entry.length = data->len;
+    return true;
+}
+
+auto UndoSpillFile::read(const Entry& entry, string& data) -> bool {
+    if (!this->file.is_open()) {
+        return false;
+    }
+
+    data.resize(entry.length);
+    this->file.seekg(entry.offset);
+    this->file.read(&data[0], entry.length);
+    if (!this->file.good()) {
+        g_warning("Could not read undo file \"%s\"", this->path.c_str());
+        this->file.clear();
+        return false;
+    }
+    return true;
+}
+
+void UndoSpillFile::free(const Entry& entry) {
+    if (!this->file.is_open() || entry.length == 0) {
+        return;
+    }
+
+    size_t offset = entry.offset;
+    size_t length = entry.length;
+
+    // Merge with the adjacent free regions
+    auto next = this->freeRegions.lower_bound(offset);
+    if (next != this->freeRegions.end() && next->first == offset + length) {
+        length += next->second;
+        next = this->freeRegions.erase(next);
+    }
+    if (next != this->freeRegions.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            length += prev->second;
+            this->freeRegions.erase(prev);
+        }
+    }
+
+    if (offset + length == this->size) {
+        // The end of the file is not used anymore
+        this->size = offset;
+    } else {
+        this->freeRegions[offset] = length;
+    }
+
+    if (this->size == 0) {
+        // Release the disk space
+        clear();
+    }
+}
+
+void UndoSpillFile::clear() {
+    if (this->file.is_open()) {
+        this->file.close();
+        this->path.deleteFile();
+    }
+    this->size = 0;
+    this->freeRegions.clear();
+}
@@ -0,0 +1,69 @@
+/*
+ * Xournal++
+ *
+ * Temporary file for the data of old undo actions
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <glib.h>
+
+#include "Path.h"
+#include "XournalType.h"
+
+class UndoSpillFile {
+public:
+    UndoSpillFile();
+    virtual ~UndoSpillFile();
+
+public:
+    struct Entry {
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    /**
+     * Writes the data to a free region of the file, or appends it. The file is created on first use
+     *
+     * @return false if the data could not be written
+     */
+    bool write(const GString* data, Entry& entry);
+
+    /**
+     * Reads data written by write()
+     */
+    bool read(const Entry& entry, string& data);
+
+    /**
+     * The data of the entry is not needed anymore, its region is reused
+     */
+    void free(const Entry& entry);
+
+    /**
+     * Deletes the file, all entries are invalid afterwards
+     */
+    void clear();
+
+private:
+    Path path;
+    std::fstream file;
+
+    /**
+     * The end of the last region in use
+     */
+    size_t size = 0;
+
+    /**
+     * The free regions before size, offset to length. Adjacent regions are merged
+     */
+    std::map<size_t, size_t> freeRegions;
+};
@@ -32,6 +32,8 @@ void emergencySave() {
     Path filename = Util::getConfigFile("emergencysave.xopp");
 
     SaveHandler handler;
+    // Get the document on disk as fast as possible
+    handler.setCompressionLevel(Z_BEST_SPEED);
     handler.prepareSave(document);
     handler.saveTo(filename);
 
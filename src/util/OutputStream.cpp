@@ -17,10 +17,15 @@ void OutputStream::write(const char* str) { write(str, strlen(str)); }
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(const Path& filename) {
+GzOutputStream::GzOutputStream(const Path& filename, int level) {
     this->filename = filename;
 
-    this->fp = GzUtil::openPath(filename, "w");
+    string mode = "w";
+    if (level >= Z_NO_COMPRESSION && level <= Z_BEST_COMPRESSION) {
+        mode += std::to_string(level);
+    }
+
+    this->fp = GzUtil::openPath(filename, mode);
     if (this->fp == nullptr) {
         this->error = FS(_F("Error opening file: \"{1}\"") % filename.str());
     }
@@ -35,11 +40,31 @@ GzOutputStream::~GzOutputStream() {
 
 auto GzOutputStream::getLastError() -> string& { return this->error; }
 
-void GzOutputStream::write(const char* data, int len) { gzwrite(this->fp, data, len); }
+void GzOutputStream::write(const char* data, int len) {
+    if (gzwrite(this->fp, data, len) != len && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->filename.str());
+    }
+}
 
 void GzOutputStream::close() {
     if (this->fp) {
-        gzclose(this->fp);
+        if (gzclose(this->fp) != Z_OK && this->error.empty()) {
+            this->error = FS(_F("Error writing file: \"{1}\"") % this->filename.str());
+        }
         this->fp = nullptr;
     }
 }
+
+////////////////////////////////////////////////////////
+/// StringOutputStream /////////////////////////////////
+////////////////////////////////////////////////////////
+
+StringOutputStream::StringOutputStream() = default;
+
+StringOutputStream::~StringOutputStream() = default;
+
+void StringOutputStream::write(const char* data, int len) { this->data.append(data, len); }
+
+void StringOutputStream::close() {}
+
+auto StringOutputStream::getString() -> string& { return this->data; }
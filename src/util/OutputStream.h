@@ -34,7 +34,10 @@ public:
 
 class GzOutputStream: public OutputStream {
 public:
-    GzOutputStream(const Path& filename);
+    /**
+     * @param level zlib compression level
+     */
+    GzOutputStream(const Path& filename, int level = Z_DEFAULT_COMPRESSION);
     virtual ~GzOutputStream();
 
 public:
@@ -52,3 +55,22 @@ private:
     string target;
     Path filename;
 };
+
+/**
+ * Collects all written data in memory
+ */
+class StringOutputStream: public OutputStream {
+public:
+    StringOutputStream();
+    virtual ~StringOutputStream();
+
+public:
+    virtual void write(const char* data, int len);
+
+    virtual void close();
+
+    string& getString();
+
+private:
+    string data;
+};
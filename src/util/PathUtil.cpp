@@ -2,9 +2,16 @@
 
 #include <array>
 
+#include <fcntl.h>
 #include <glib.h>
 #include <glib/gstdio.h>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "XojMsgBox.h"
 
 /**
@@ -49,15 +56,115 @@ auto PathUtil::copy(const Path& src, const Path& dest) -> bool {
         return false;
     }
 
-    while (!feof(fpRead)) {
+    bool success = true;
+    while (!feof(fpRead) && success) {
         size_t bytes = fread(buffer.data(), 1, buffer.size(), fpRead);
         if (bytes) {
-            fwrite(buffer.data(), 1, bytes, fpWrite);
+            success = fwrite(buffer.data(), 1, bytes, fpWrite) == bytes;
         }
     }
 
     fclose(fpRead);
-    fclose(fpWrite);
+    success = fclose(fpWrite) == 0 && success;
+
+    return success;
+}
+
+auto PathUtil::syncFile(const Path& path) -> bool {
+#ifdef _WIN32
+    int fd = g_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+    bool success = _commit(fd) == 0;
+    _close(fd);
+#else
+    int fd = g_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    bool success = fsync(fd) == 0;
+    close(fd);
+#endif
+
+    return success;
+}
+
+auto PathUtil::resolveSymlinks(const Path& path) -> Path {
+    Path resolved = path;
+
+    // Limited like in the kernel, a loop of links must not hang
+    for (int i = 0; i < 40 && g_file_test(resolved.c_str(), G_FILE_TEST_IS_SYMLINK); i++) {
+        gchar* link = g_file_read_link(resolved.c_str(), nullptr);
+        if (link == nullptr) {
+            break;
+        }
+
+        if (g_path_is_absolute(link)) {
+            resolved = Path(link);
+        } else {
+            resolved = resolved.getParentPath() / link;
+        }
+        g_free(link);
+    }
+
+    return resolved;
+}
+
+auto PathUtil::replaceFile(const Path& tmp, const Path& target) -> bool {
+    GStatBuf targetStat;
+    if (g_stat(target.c_str(), &targetStat) == 0) {
+        // Keep the permissions of the document, not the defaults of the new file
+        g_chmod(tmp.c_str(), targetStat.st_mode & 07777);
+#ifndef _WIN32
+        // Only possible for root or if the owner does not change, else the file belongs to the saving user
+        if (chown(tmp.c_str(), targetStat.st_uid, targetStat.st_gid) != 0 &&
+            chown(tmp.c_str(), static_cast<uid_t>(-1), targetStat.st_gid) != 0) {
+            g_warning("Could not keep the owner of \"%s\"", target.c_str());
+        }
+#endif
+    }
+
+    if (g_rename(tmp.c_str(), target.c_str()) != 0) {
+        return false;
+    }
+
+#ifndef _WIN32
+    // Persist the rename itself
+    int fd = g_open(target.getParentPath().c_str(), O_RDONLY, 0);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+
+    return true;
+}
+
+auto PathUtil::createBackup(const Path& file, const Path& backup) -> bool {
+    g_unlink(backup.c_str());
+
+#ifndef _WIN32
+    if (link(file.c_str(), backup.c_str()) == 0) {
+        return true;
+    }
+#endif
+
+    return copy(file, backup);
+}
+
+auto PathUtil::move(const Path& src, const Path& dest) -> bool {
+    if (g_rename(src.c_str(), dest.c_str()) == 0) {
+        return true;
+    }
+
+    // Not on the same filesystem: copy next to the target, then replace it
+    Path tmp = dest.getParentPath() / ("." + dest.getFilename() + ".tmp");
+    if (!copy(src, tmp) || !syncFile(tmp) || !replaceFile(tmp, dest)) {
+        g_unlink(tmp.c_str());
+        return false;
+    }
 
+    g_unlink(src.c_str());
     return true;
 }
@@ -31,4 +31,38 @@ public:
     static bool readString(string& output, Path& path, bool showErrorToUser = true);
 
     static bool copy(const Path& src, const Path& dest);
+
+    /**
+     * Flush the contents of the file to disk (fsync)
+     *
+     * @return true on success
+     */
+    static bool syncFile(const Path& path);
+
+    /**
+     * @return The file a symbolic link points to, following chains of links. The path itself if it is no link.
+     */
+    static Path resolveSymlinks(const Path& path);
+
+    /**
+     * Atomically replace the target with the (already flushed) temporary file. The temporary file gets the mode and
+     * owner of the replaced file. The target must not be a symbolic link, see resolveSymlinks.
+     *
+     * @return true on success
+     */
+    static bool replaceFile(const Path& tmp, const Path& target);
+
+    /**
+     * Create a backup of the file without moving it away: a hard link, or a copy where links are not supported
+     *
+     * @return true on success
+     */
+    static bool createBackup(const Path& file, const Path& backup);
+
+    /**
+     * Move the file, also to another filesystem. The target is replaced atomically
+     *
+     * @return true on success
+     */
+    static bool move(const Path& src, const Path& dest);
 };
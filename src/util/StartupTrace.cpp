@@ -0,0 +1,28 @@
+#include "StartupTrace.h"
+
+bool StartupTrace::enabled = false;
+gint64 StartupTrace::start = g_get_monotonic_time();
+std::vector<std::pair<std::string, gint64>> StartupTrace::phases;
+
+StartupTrace::StartupTrace() = default;
+
+StartupTrace::~StartupTrace() = default;
+
+void StartupTrace::setEnabled(bool enabled) { StartupTrace::enabled = enabled; }
+
+auto StartupTrace::isEnabled() -> bool { return enabled; }
+
+void StartupTrace::mark(const char* phase) { phases.emplace_back(phase, g_get_monotonic_time()); }
+
+void StartupTrace::report() {
+    if (!enabled) {
+        return;
+    }
+
+    gint64 last = start;
+    for (auto& p: phases) {
+        g_message("Startup: %-24s %8.1f ms, %8.1f ms since start", p.first.c_str(),
+                  static_cast<double>(p.second - last) / 1000, static_cast<double>(p.second - start) / 1000);
+        last = p.second;
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Xournal++
+ *
+ * Measures the time of the phases of the application startup
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+
+/**
+ * The phases are always recorded, this is only a few calls of g_get_monotonic_time(). They are printed when the
+ * trace is enabled with the command line option --startup-trace.
+ */
+class StartupTrace {
+private:
+    StartupTrace();
+    virtual ~StartupTrace();
+
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * End the current phase, the next phase starts now
+     *
+     * @param phase The name of the ended phase
+     */
+    static void mark(const char* phase);
+
+    /**
+     * Print the duration of the recorded phases, if enabled
+     */
+    static void report();
+
+private:
+    static bool enabled;
+    static gint64 start;
+
+    /**
+     * Name and end time of the phases
+     */
+    static std::vector<std::pair<std::string, gint64>> phases;
+};
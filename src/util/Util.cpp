@@ -97,6 +97,13 @@ auto Util::getTmpDirSubfolder(const Path& subfolder) -> Path {
     return Util::ensureFolderExists(p);
 }
 
+auto Util::getCacheSubfolder(const Path& subfolder) -> Path {
+    Path p(g_get_user_cache_dir());
+    p /= "xournalpp";
+    p /= subfolder;
+    return Util::ensureFolderExists(p);
+}
+
 auto Util::ensureFolderExists(const Path& p) -> Path {
     if (g_mkdir_with_parents(p.c_str(), 0700) == -1) {
         Util::execInUiThread([=]() {
@@ -42,6 +42,11 @@ Path getConfigFile(const Path& relativeFileName = "");
 
 Path getTmpDirSubfolder(const Path& subfolder = "");
 
+/**
+ * @return A folder in the user cache directory, for data which can be recreated but is kept between sessions
+ */
+Path getCacheSubfolder(const Path& subfolder = "");
+
 Path ensureFolderExists(const Path& p);
 
 /**
@@ -0,0 +1,219 @@
+#include "ZipWriter.h"
+
+#include <ctime>
+#include <limits>
+
+#include <glib/gstdio.h>
+
+#include "i18n.h"
+
+constexpr uint32_t ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr uint32_t ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+constexpr uint32_t ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+
+constexpr uint16_t ZIP_VERSION = 20;
+// Bit 11: The filenames are encoded as UTF-8
+constexpr uint16_t ZIP_FLAG_UTF8 = 0x0800;
+
+constexpr uint16_t ZIP_METHOD_STORE = 0;
+constexpr uint16_t ZIP_METHOD_DEFLATE = 8;
+
+constexpr size_t ZIP_LOCAL_HEADER_SIZE = 30;
+constexpr size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+
+// The maximum values mark Zip64 fields, so every value has to be below them
+constexpr uint64_t ZIP_MAX_16 = std::numeric_limits<uint16_t>::max();
+constexpr uint64_t ZIP_MAX_32 = std::numeric_limits<uint32_t>::max();
+
+ZipWriter::ZipWriter(const Path& filename): filename(filename) {
+    this->fp = g_fopen(filename.c_str(), "wb");
+    if (this->fp == nullptr) {
+        this->error = FS(_F("Error opening file: \"{1}\"") % filename.str());
+    }
+
+    time_t now = time(nullptr);
+    struct tm* t = localtime(&now);
+    this->dosTime = (t->tm_hour << 11) | (t->tm_min << 5) | (t->tm_sec / 2);
+    this->dosDate = ((t->tm_year - 80) << 9) | ((t->tm_mon + 1) << 5) | t->tm_mday;
+}
+
+ZipWriter::~ZipWriter() {
+    if (this->fp) {
+        close();
+    }
+}
+
+auto ZipWriter::getLastError() -> string& { return this->error; }
+
+auto ZipWriter::createEntry(string name, const string& data, int level) -> ZipEntry {
+    ZipEntry entry;
+    entry.name = std::move(name);
+    entry.uncompressedSize = data.size();
+
+    // zlib takes 32 bit lengths, addEntry() rejects the entry anyway
+    if (data.size() >= ZIP_MAX_32) {
+        return entry;
+    }
+
+    entry.crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.data()), data.size());
+
+    if (level != 0 && !data.empty()) {
+        z_stream stream{};
+        // Negative window bits: raw deflate data, as required by zip
+        if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+            entry.data.resize(deflateBound(&stream, data.size()));
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            stream.avail_in = data.size();
+            stream.next_out = reinterpret_cast<Bytef*>(&entry.data[0]);
+            stream.avail_out = entry.data.size();
+
+            int result = deflate(&stream, Z_FINISH);
+            entry.data.resize(stream.total_out);
+            deflateEnd(&stream);
+
+            if (result == Z_STREAM_END && entry.data.size() < data.size()) {
+                entry.method = ZIP_METHOD_DEFLATE;
+                return entry;
+            }
+        }
+    }
+
+    entry.method = ZIP_METHOD_STORE;
+    entry.data = data;
+    return entry;
+}
+
+void ZipWriter::writeData(const void* data, size_t len) {
+    if (this->fp == nullptr || len == 0) {
+        return;
+    }
+
+    if (fwrite(data, 1, len, this->fp) != len && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->filename.str());
+    }
+    this->offset += len;
+}
+
+void ZipWriter::write16(uint16_t value) {
+    unsigned char buffer[2] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8)};
+    writeData(buffer, sizeof(buffer));
+}
+
+void ZipWriter::write32(uint32_t value) {
+    unsigned char buffer[4] = {static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+                               static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24)};
+    writeData(buffer, sizeof(buffer));
+}
+
+void ZipWriter::setFileTooLarge() {
+    if (this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\", the file is too large") % this->filename.str());
+    }
+}
+
+void ZipWriter::addEntry(const ZipEntry& entry) {
+    if (this->fp == nullptr || !this->error.empty()) {
+        return;
+    }
+
+    // No Zip64 support, the documents are far below these limits. The next entry or the central directory starts at
+    // the end of this entry, so its offset has to fit, too.
+    uint64_t end = this->offset + ZIP_LOCAL_HEADER_SIZE + entry.name.size() + entry.data.size();
+    if (entry.uncompressedSize >= ZIP_MAX_32 || entry.data.size() >= ZIP_MAX_32 || end >= ZIP_MAX_32) {
+        setFileTooLarge();
+        return;
+    }
+
+    if (entry.name.size() >= ZIP_MAX_16) {
+        this->error = FS(_F("Error writing file: \"{1}\", the entry name is too long: \"{2}\"") %
+                         this->filename.str() % entry.name.substr(0, 100));
+        return;
+    }
+
+    if (this->entries.size() + 1 >= ZIP_MAX_16) {
+        this->error = FS(_F("Error writing file: \"{1}\", the file has too many entries") % this->filename.str());
+        return;
+    }
+
+    CentralDirectoryEntry cd;
+    cd.name = entry.name;
+    cd.crc = entry.crc;
+    cd.compressedSize = entry.data.size();
+    cd.uncompressedSize = entry.uncompressedSize;
+    cd.method = entry.method;
+    cd.offset = this->offset;
+
+    write32(ZIP_LOCAL_HEADER_SIGNATURE);
+    write16(ZIP_VERSION);
+    write16(ZIP_FLAG_UTF8);
+    write16(cd.method);
+    write16(this->dosTime);
+    write16(this->dosDate);
+    write32(cd.crc);
+    write32(cd.compressedSize);
+    write32(cd.uncompressedSize);
+    write16(cd.name.size());
+    write16(0);  // extra field length
+    writeData(cd.name.data(), cd.name.size());
+    writeData(entry.data.data(), entry.data.size());
+
+    this->entries.push_back(std::move(cd));
+}
+
+void ZipWriter::close() {
+    if (this->fp == nullptr) {
+        return;
+    }
+
+    uint64_t centralDirectoryOffset = this->offset;
+
+    uint64_t centralDirectorySize = 0;
+    for (CentralDirectoryEntry& cd: this->entries) {
+        centralDirectorySize += ZIP_CENTRAL_HEADER_SIZE + cd.name.size();
+    }
+    if (centralDirectoryOffset + centralDirectorySize >= ZIP_MAX_32) {
+        setFileTooLarge();
+    }
+
+    // The caller deletes the file on error, don't write an archive with invalid headers
+    if (!this->error.empty()) {
+        fclose(this->fp);
+        this->fp = nullptr;
+        return;
+    }
+
+    for (CentralDirectoryEntry& cd: this->entries) {
+        write32(ZIP_CENTRAL_HEADER_SIGNATURE);
+        write16(ZIP_VERSION);  // made by
+        write16(ZIP_VERSION);  // needed to extract
+        write16(ZIP_FLAG_UTF8);
+        write16(cd.method);
+        write16(this->dosTime);
+        write16(this->dosDate);
+        write32(cd.crc);
+        write32(cd.compressedSize);
+        write32(cd.uncompressedSize);
+        write16(cd.name.size());
+        write16(0);  // extra field length
+        write16(0);  // comment length
+        write16(0);  // disk number
+        write16(0);  // internal attributes
+        write32(0);  // external attributes
+        write32(cd.offset);
+        writeData(cd.name.data(), cd.name.size());
+    }
+
+    write32(ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE);
+    write16(0);  // this disk
+    write16(0);  // disk with central directory
+    write16(this->entries.size());
+    write16(this->entries.size());
+    write32(centralDirectorySize);
+    write32(centralDirectoryOffset);
+    write16(0);  // comment length
+
+    if (fclose(this->fp) != 0 && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->filename.str());
+    }
+    this->fp = nullptr;
+}
@@ -0,0 +1,99 @@
+/*
+ * Xournal++
+ *
+ * Writes a zip container
+ *
+ * The entries are compressed independently of the archive, so they can be
+ * created on multiple threads and appended in order afterwards.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "Path.h"
+#include "XournalType.h"
+
+/**
+ * A compressed (or stored) zip entry, ready to be written
+ */
+class ZipEntry {
+public:
+    string name;
+    string data;
+    uint32_t crc = 0;
+    uint64_t uncompressedSize = 0;
+    uint16_t method = 0;
+};
+
+class ZipWriter {
+public:
+    ZipWriter(const Path& filename);
+    virtual ~ZipWriter();
+
+private:
+    ZipWriter(const ZipWriter& writer);
+    void operator=(const ZipWriter& writer);
+
+public:
+    /**
+     * Compress the data into a zip entry. Does not access the archive, so this is thread safe.
+     *
+     * @param level zlib compression level, 0 stores the data uncompressed.
+     *              If deflating does not make the data smaller it's stored, too.
+     */
+    static ZipEntry createEntry(string name, const string& data, int level = Z_DEFAULT_COMPRESSION);
+
+    /**
+     * Append the entry to the archive
+     *
+     * @note Zip64 is not supported. If a size, an offset or the number of entries does not fit into the zip headers
+     * an error is set, and nothing more is written.
+     */
+    void addEntry(const ZipEntry& entry);
+
+    /**
+     * Write the central directory and close the file. After an error only the file is closed, the archive is invalid.
+     */
+    void close();
+
+    string& getLastError();
+
+private:
+    void writeData(const void* data, size_t len);
+    void write16(uint16_t value);
+    void write32(uint32_t value);
+    void setFileTooLarge();
+
+private:
+    class CentralDirectoryEntry {
+    public:
+        string name;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t uncompressedSize;
+        uint16_t method;
+        uint32_t offset;
+    };
+
+    FILE* fp = nullptr;
+    uint64_t offset = 0;
+
+    uint16_t dosTime = 0;
+    uint16_t dosDate = 0;
+
+    vector<CentralDirectoryEntry> entries;
+
+    string error;
+    Path filename;
+};
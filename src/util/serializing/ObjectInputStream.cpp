@@ -149,31 +149,7 @@ void ObjectInputStream::readData(void** data, int* length) {
     }
 }
 
-class PngDatasource {
-public:
-    PngDatasource(char* start, int len) {
-        this->data = start;
-        this->len = len;
-        this->pos = 0;
-    }
-
-    char* data;
-    int len;
-    int pos;
-};
-
-auto cairoReadFunction(PngDatasource* obj, unsigned char* data, unsigned int length) -> cairo_status_t {
-    for (unsigned int i = 0; i < length; i++, obj->pos++) {
-        if (obj->pos >= obj->len) {
-            return CAIRO_STATUS_READ_ERROR;
-        }
-        data[i] = obj->data[obj->pos];
-    }
-
-    return CAIRO_STATUS_SUCCESS;
-}
-
-auto ObjectInputStream::readImage() -> cairo_surface_t* {
+auto ObjectInputStream::readImage() -> string {
     checkType('m');
 
     if (this->pos + sizeof(int) >= this->str->len) {
@@ -189,15 +165,10 @@ auto ObjectInputStream::readImage() -> cairo_surface_t* {
         throw InputStreamException("End reached, but try to read an image", __FILE__, __LINE__);
     }
 
-    PngDatasource source(this->str->str + this->pos, len);
-    // cairo_surface_t * img = cairo_image_surface_create_from_png_stream((cairo_read_func_t) cairoReadFunction,
-    // &source);
-    cairo_surface_t* img = cairo_image_surface_create_from_png_stream(
-            reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), &source);
-
+    string png(this->str->str + this->pos, len);
     this->pos += len;
 
-    return img;
+    return png;
 }
 
 void ObjectInputStream::checkType(char type) {
@@ -36,7 +36,11 @@ public:
     string readString();
 
     void readData(void** data, int* len);
-    cairo_surface_t* readImage();
+
+    /**
+     * @return The image as PNG
+     */
+    string readImage();
 
 private:
     void checkType(char type);
@@ -58,22 +58,13 @@ void ObjectOutputStream::writeData(const void* data, int len, int width) {
     }
 }
 
-static auto cairoWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
-    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
-    return CAIRO_STATUS_SUCCESS;
-}
-
-void ObjectOutputStream::writeImage(cairo_surface_t* img) {
-    GString* imgStr = g_string_sized_new(102400);
-
-    cairo_surface_write_to_png_stream(img, reinterpret_cast<cairo_write_func_t>(&cairoWriteFunction), imgStr);
+void ObjectOutputStream::writeImage(const string& png) {
+    gsize len = png.length();
 
     this->encoder->addStr("_m");
-    this->encoder->addData(&imgStr->len, sizeof(gsize));
-
-    this->encoder->addData(imgStr->str, imgStr->len);
+    this->encoder->addData(&len, sizeof(gsize));
 
-    g_string_free(imgStr, true);
+    this->encoder->addData(png.c_str(), len);
 }
 
 auto ObjectOutputStream::getStr() -> GString* { return this->encoder->getData(); }
@@ -37,7 +37,7 @@ public:
     void writeString(const string& s);
 
     void writeData(const void* data, int len, int width);
-    void writeImage(cairo_surface_t* img);
+    void writeImage(const string& png);
 
     GString* getStr();
 
@@ -1,5 +1,7 @@
 #include "DocumentView.h"
 
+#include <cmath>
+
 #include <config-debug.h>
 #include <config.h>
 
@@ -97,6 +99,65 @@ void DocumentView::drawImage(cairo_t* cr, Image* i) {
     cairo_set_matrix(cr, &defaultMatrix);
 }
 
+/**
+ * Larger LaTeX images are drawn directly from the PDF
+ */
+constexpr int MAX_TEX_RASTER_SIZE = 4096;
+
+/**
+ * Draws a LaTeX PDF to an image surface from a raster in device resolution. Poppler is only called again if a larger
+ * raster is needed, e.g. after zooming in; smaller previews are scaled down from the raster. The least recently used
+ * rasters are dropped when all rasters exceed TexImage::MAX_RASTER_BYTES.
+ *
+ * @return false if the raster would be too large
+ */
+static auto drawTexRaster(cairo_t* cr, TexImage* texImage, PopplerPage* page, double pageWidth, double pageHeight)
+        -> bool {
+    double width = texImage->getElementWidth();
+    double height = texImage->getElementHeight();
+
+    double deviceWidth = width;
+    double deviceHeight = height;
+    cairo_user_to_device_distance(cr, &deviceWidth, &deviceHeight);
+    int rasterWidth = static_cast<int>(std::ceil(std::abs(deviceWidth)));
+    int rasterHeight = static_cast<int>(std::ceil(std::abs(deviceHeight)));
+
+    if (rasterWidth > MAX_TEX_RASTER_SIZE || rasterHeight > MAX_TEX_RASTER_SIZE) {
+        return false;
+    }
+    if (rasterWidth == 0 || rasterHeight == 0) {
+        return true;
+    }
+
+    cairo_surface_t* raster = texImage->getRaster();
+    if (raster == nullptr || cairo_image_surface_get_width(raster) < rasterWidth ||
+        cairo_image_surface_get_height(raster) < rasterHeight) {
+        if (raster) {
+            cairo_surface_destroy(raster);
+        }
+
+        raster = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, rasterWidth, rasterHeight);
+        cairo_t* rasterCr = cairo_create(raster);
+        cairo_scale(rasterCr, rasterWidth / pageWidth, rasterHeight / pageHeight);
+        poppler_page_render(page, rasterCr);
+        cairo_destroy(rasterCr);
+
+        texImage->setRaster(raster);
+    }
+
+    cairo_save(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_translate(cr, texImage->getX(), texImage->getY());
+    cairo_scale(cr, width / cairo_image_surface_get_width(raster), height / cairo_image_surface_get_height(raster));
+    cairo_set_source_surface(cr, raster, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    cairo_paint(cr);
+    cairo_restore(cr);
+
+    cairo_surface_destroy(raster);
+    return true;
+}
+
 void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) {
     cairo_matrix_t defaultMatrix = {0};
     cairo_get_matrix(cr, &defaultMatrix);
@@ -116,12 +177,18 @@ void DocumentView::drawTexImage(cairo_t* cr, TexImage* texImage) {
         double pageHeight = 0;
         poppler_page_get_size(page, &pageWidth, &pageHeight);
 
-        double xFactor = texImage->getElementWidth() / pageWidth;
-        double yFactor = texImage->getElementHeight() / pageHeight;
+        // Exports and printing keep the vector graphics
+        bool imageTarget = cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE;
+        if (!imageTarget || !drawTexRaster(cr, texImage, page, pageWidth, pageHeight)) {
+            double xFactor = texImage->getElementWidth() / pageWidth;
+            double yFactor = texImage->getElementHeight() / pageHeight;
 
-        cairo_translate(cr, texImage->getX(), texImage->getY());
-        cairo_scale(cr, xFactor, yFactor);
-        poppler_page_render(page, cr);
+            cairo_translate(cr, texImage->getX(), texImage->getY());
+            cairo_scale(cr, xFactor, yFactor);
+            poppler_page_render(page, cr);
+        }
+
+        g_object_unref(page);
     } else if (img != nullptr) {
         int width = cairo_image_surface_get_width(img);
         int height = cairo_image_surface_get_height(img);
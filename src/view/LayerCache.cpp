@@ -0,0 +1,303 @@
+#include "LayerCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "model/Layer.h"
+
+#include "DocumentView.h"
+#include "PdfView.h"
+
+LayerCache::LayerCache() { g_mutex_init(&this->mutex); }
+
+LayerCache::~LayerCache() {
+    clearSurfaces();
+    g_mutex_clear(&this->mutex);
+}
+
+void LayerCache::clearSurfaces() {
+    if (this->background) {
+        cairo_surface_destroy(this->background);
+        this->background = nullptr;
+    }
+
+    for (auto& l: this->layers) {
+        cairo_surface_destroy(l.second.surface);
+    }
+    this->layers.clear();
+}
+
+void LayerCache::setEnabled(bool enabled) {
+    g_mutex_lock(&this->mutex);
+    this->enabled = enabled;
+    if (!enabled) {
+        clearSurfaces();
+        this->generation++;
+    }
+    g_mutex_unlock(&this->mutex);
+}
+
+void LayerCache::clear() {
+    g_mutex_lock(&this->mutex);
+    clearSurfaces();
+    this->generation++;
+    g_mutex_unlock(&this->mutex);
+}
+
+void LayerCache::invalidate(Layer* layer, const Rectangle& rect) {
+    g_mutex_lock(&this->mutex);
+
+    for (auto& l: this->layers) {
+        if (layer != nullptr && l.first != layer) {
+            continue;
+        }
+
+        CachedLayer& cached = l.second;
+        if (cached.dirty) {
+            cached.dirtyRect.add(rect);
+        } else {
+            cached.dirty = true;
+            cached.dirtyRect = rect;
+        }
+    }
+    this->generation++;
+
+    g_mutex_unlock(&this->mutex);
+}
+
+void LayerCache::invalidate(Layer* layer) {
+    g_mutex_lock(&this->mutex);
+
+    auto it = this->layers.find(layer);
+    if (layer == nullptr) {
+        clearSurfaces();
+    } else if (it != this->layers.end()) {
+        cairo_surface_destroy(it->second.surface);
+        this->layers.erase(it);
+    }
+    this->generation++;
+
+    g_mutex_unlock(&this->mutex);
+}
+
+void LayerCache::removeDeletedLayers(const PageRef& page) {
+    vector<Layer*>* pageLayers = page->getLayers();
+
+    g_mutex_lock(&this->mutex);
+    for (auto it = this->layers.begin(); it != this->layers.end();) {
+        if (std::find(pageLayers->begin(), pageLayers->end(), it->first) == pageLayers->end()) {
+            cairo_surface_destroy(it->second.surface);
+            it = this->layers.erase(it);
+        } else {
+            it++;
+        }
+    }
+    g_mutex_unlock(&this->mutex);
+}
+
+auto LayerCache::renderBackground(DocumentView& view, const PageRef& page, const XojPdfPageSPtr& pdfPage,
+                                  PdfCache* pdfCache, int width, int height, double zoom) -> cairo_surface_t* {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, zoom, zoom);
+
+    if (page->getBackgroundType().isPdfPage()) {
+        PdfView::drawPage(pdfCache, pdfPage, cr, zoom, page->getWidth(), page->getHeight());
+    }
+
+    view.initDrawing(page, cr, false);
+    view.drawBackground();
+    view.finializeDrawing();
+
+    cairo_destroy(cr);
+    return surface;
+}
+
+auto LayerCache::renderLayer(DocumentView& view, const PageRef& page, Layer* layer, int width, int height,
+                             double zoom) -> cairo_surface_t* {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, zoom, zoom);
+
+    view.initDrawing(page, cr, false);
+    view.drawLayer(cr, layer);
+    view.finializeDrawing();
+
+    cairo_destroy(cr);
+    return surface;
+}
+
+/**
+ * Render the changed area of a cached layer again
+ */
+void LayerCache::repairLayer(DocumentView& view, const PageRef& page, Layer* layer, cairo_surface_t* surface,
+                             const Rectangle& rect, double zoom) {
+    cairo_t* cr = cairo_create(surface);
+
+    // Clip on whole pixels, else the antialiased edge would blend the old and the new content
+    double x1 = std::floor(rect.x * zoom);
+    double y1 = std::floor(rect.y * zoom);
+    double x2 = std::ceil((rect.x + rect.width) * zoom);
+    double y2 = std::ceil((rect.y + rect.height) * zoom);
+    cairo_rectangle(cr, x1, y1, x2 - x1, y2 - y1);
+    cairo_clip(cr);
+
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    cairo_scale(cr, zoom, zoom);
+
+    view.limitArea(rect.x, rect.y, rect.width, rect.height);
+    view.initDrawing(page, cr, false);
+    view.drawLayer(cr, layer);
+    view.finializeDrawing();
+
+    cairo_destroy(cr);
+}
+
+auto LayerCache::render(DocumentView& view, const PageRef& page, const XojPdfPageSPtr& pdfPage, PdfCache* pdfCache,
+                        cairo_surface_t* target, double zoom) -> bool {
+    int targetWidth = cairo_image_surface_get_width(target);
+    int targetHeight = cairo_image_surface_get_height(target);
+    bool backgroundVisible = page->isLayerVisible(0);
+
+    std::vector<Layer*> visible;
+    for (Layer* l: *page->getLayers()) {
+        if (page->isLayerVisible(l)) {
+            visible.push_back(l);
+        }
+    }
+
+    g_mutex_lock(&this->mutex);
+
+    size_t surfaceBytes = static_cast<size_t>(cairo_image_surface_get_stride(target)) * targetHeight;
+    // Hidden layers keep their surface, so count all layers and the background
+    size_t surfaceCount = page->getLayerCount() + 1;
+    if (!this->enabled || surfaceCount * surfaceBytes > MAX_BYTES) {
+        clearSurfaces();
+        g_mutex_unlock(&this->mutex);
+        return false;
+    }
+
+    if (this->width != targetWidth || this->height != targetHeight || this->zoom != zoom) {
+        clearSurfaces();
+        this->width = targetWidth;
+        this->height = targetHeight;
+        this->zoom = zoom;
+    }
+    int renderGeneration = this->generation;
+
+    // Take references, the UI thread may discard the cached surfaces while rendering. Changed areas are repaired
+    // in place, the UI thread only marks them.
+    cairo_surface_t* backgroundSurface = nullptr;
+    if (backgroundVisible && this->background) {
+        backgroundSurface = cairo_surface_reference(this->background);
+    }
+
+    struct VisibleLayer {
+        Layer* layer;
+        cairo_surface_t* surface;
+        bool cached;
+        bool dirty;
+        Rectangle dirtyRect;
+    };
+
+    std::vector<VisibleLayer> visibleLayers;
+    for (Layer* l: visible) {
+        auto it = this->layers.find(l);
+        if (it == this->layers.end()) {
+            visibleLayers.push_back({l, nullptr, false, false, Rectangle()});
+            continue;
+        }
+
+        CachedLayer& cached = it->second;
+        visibleLayers.push_back({l, cairo_surface_reference(cached.surface), true, cached.dirty, cached.dirtyRect});
+        cached.dirty = false;
+    }
+
+    g_mutex_unlock(&this->mutex);
+
+    if (backgroundVisible && backgroundSurface == nullptr) {
+        backgroundSurface = renderBackground(view, page, pdfPage, pdfCache, targetWidth, targetHeight, zoom);
+    }
+
+    for (VisibleLayer& l: visibleLayers) {
+        if (!l.cached) {
+            l.surface = renderLayer(view, page, l.layer, targetWidth, targetHeight, zoom);
+        } else if (l.dirty) {
+            repairLayer(view, page, l.layer, l.surface, l.dirtyRect, zoom);
+        }
+    }
+
+    // Keep the new surfaces, unless the page was changed in the meantime
+    g_mutex_lock(&this->mutex);
+    if (this->generation == renderGeneration && this->width == targetWidth && this->height == targetHeight &&
+        this->zoom == zoom) {
+        if (backgroundSurface && this->background == nullptr) {
+            this->background = cairo_surface_reference(backgroundSurface);
+        }
+
+        for (VisibleLayer& l: visibleLayers) {
+            if (!l.cached && this->layers.find(l.layer) == this->layers.end()) {
+                this->layers[l.layer].surface = cairo_surface_reference(l.surface);
+            }
+        }
+    }
+    g_mutex_unlock(&this->mutex);
+
+    cairo_t* cr = cairo_create(target);
+
+    if (backgroundSurface) {
+        cairo_set_source_surface(cr, backgroundSurface, 0, 0);
+        cairo_paint(cr);
+        cairo_surface_destroy(backgroundSurface);
+    } else {
+        cairo_save(cr);
+        cairo_scale(cr, zoom, zoom);
+        view.initDrawing(page, cr, false);
+        view.drawTransparentBackgroundPattern();
+        view.finializeDrawing();
+        cairo_restore(cr);
+    }
+
+    for (VisibleLayer& l: visibleLayers) {
+        cairo_set_source_surface(cr, l.surface, 0, 0);
+        cairo_paint(cr);
+        cairo_surface_destroy(l.surface);
+    }
+
+    cairo_destroy(cr);
+    return true;
+}
+
+auto LayerCache::paintLayer(cairo_t* cr, Layer* layer) -> bool {
+    g_mutex_lock(&this->mutex);
+
+    cairo_surface_t* surface = this->background;
+    if (layer) {
+        auto it = this->layers.find(layer);
+        surface = (it == this->layers.end() || it->second.dirty) ? nullptr : it->second.surface;
+    }
+
+    if (surface == nullptr) {
+        g_mutex_unlock(&this->mutex);
+        return false;
+    }
+
+    surface = cairo_surface_reference(surface);
+    double surfaceZoom = this->zoom;
+    g_mutex_unlock(&this->mutex);
+
+    cairo_save(cr);
+    cairo_scale(cr, 1 / surfaceZoom, 1 / surfaceZoom);
+    cairo_set_source_surface(cr, surface, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    cairo_paint(cr);
+    cairo_restore(cr);
+
+    cairo_surface_destroy(surface);
+    return true;
+}
@@ -0,0 +1,136 @@
+/*
+ * Xournal++
+ *
+ * Rendered background and layers of a page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <map>
+
+#include <cairo/cairo.h>
+#include <glib.h>
+
+#include "control/PdfCache.h"
+#include "model/PageRef.h"
+#include "pdf/base/XojPdfPage.h"
+
+#include "Rectangle.h"
+
+class DocumentView;
+class Layer;
+
+/**
+ * Keeps the background and each layer of a page in its own surface. Showing, hiding, adding or removing a layer only
+ * composites the surfaces again, and the layer sidebar scales the surfaces instead of rendering the layers again.
+ * An edit only marks the changed area of the edited layer, which is rendered again on the next composite.
+ *
+ * The cache is disabled until the first layer change, so pages whose layers are never toggled do not pay for it.
+ * Rendering runs in the scheduler thread, the surfaces are invalidated from the UI thread.
+ */
+class LayerCache {
+public:
+    LayerCache();
+    virtual ~LayerCache();
+
+private:
+    LayerCache(const LayerCache& cache) = delete;
+    void operator=(const LayerCache& cache) = delete;
+
+public:
+    /**
+     * Enable the cache, disabling discards all surfaces
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * Discard all surfaces, e.g. the background or the size of the page changed
+     */
+    void clear();
+
+    /**
+     * An area of a layer changed
+     *
+     * @param layer The changed layer, nullptr if it is not known, then the area is rendered again for all layers
+     * @param rect The changed area in page coordinates
+     */
+    void invalidate(Layer* layer, const Rectangle& rect);
+
+    /**
+     * All elements of a layer changed
+     *
+     * @param layer The changed layer, nullptr if it is not known, then all surfaces are discarded
+     */
+    void invalidate(Layer* layer);
+
+    /**
+     * Discard the surfaces of layers which are no longer on the page
+     */
+    void removeDeletedLayers(const PageRef& page);
+
+    /**
+     * Composite the page to the target surface, only the background and the areas of layers which are not cached yet
+     * are rendered. The document needs to be locked.
+     *
+     * @param zoom The zoom of the target surface, including the DPI scale factor
+     * @return false if the cache is disabled or the surfaces would not fit into MAX_BYTES, nothing is rendered then
+     */
+    bool render(DocumentView& view, const PageRef& page, const XojPdfPageSPtr& pdfPage, PdfCache* pdfCache,
+                cairo_surface_t* target, double zoom);
+
+    /**
+     * Paint the cached surface of a layer, scaled to page coordinates of the context
+     *
+     * @param layer The layer, nullptr for the background
+     * @return false if the layer is not cached or changed since it was rendered
+     */
+    bool paintLayer(cairo_t* cr, Layer* layer);
+
+public:
+    /**
+     * Memory limit of all surfaces of a page
+     */
+    static constexpr size_t MAX_BYTES = 64 * 1024 * 1024;
+
+private:
+    void clearSurfaces();
+
+    static cairo_surface_t* renderBackground(DocumentView& view, const PageRef& page, const XojPdfPageSPtr& pdfPage,
+                                             PdfCache* pdfCache, int width, int height, double zoom);
+    static cairo_surface_t* renderLayer(DocumentView& view, const PageRef& page, Layer* layer, int width, int height,
+                                        double zoom);
+    static void repairLayer(DocumentView& view, const PageRef& page, Layer* layer, cairo_surface_t* surface,
+                            const Rectangle& rect, double zoom);
+
+private:
+    struct CachedLayer {
+        cairo_surface_t* surface = nullptr;
+
+        /**
+         * Area which changed since the surface was rendered
+         */
+        bool dirty = false;
+        Rectangle dirtyRect;
+    };
+
+    GMutex mutex{};
+
+    bool enabled = false;
+
+    /**
+     * Incremented on every invalidation, layers rendered meanwhile are not stored as they may be outdated
+     */
+    int generation = 0;
+
+    int width = 0;
+    int height = 0;
+    double zoom = 0;
+
+    cairo_surface_t* background = nullptr;
+    std::map<Layer*, CachedLayer> layers;
+};
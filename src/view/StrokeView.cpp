@@ -12,7 +12,7 @@ StrokeView::StrokeView(cairo_t* cr, Stroke* s, int startPoint, double scaleFacto
 
 void StrokeView::drawFillStroke() {
     for_first_then_each(
-            s->getPointVector(), [this](auto const& first) { cairo_move_to(this->cr, first.x, first.y); },
+            s->getPointArray(), [this](auto const& first) { cairo_move_to(this->cr, first.x, first.y); },
             [this](auto const& other) { cairo_line_to(this->cr, other.x, other.y); });
 
     cairo_fill(cr);
@@ -89,7 +89,7 @@ void StrokeView::drawNoPressure() {
     applyDashed(0);
 
     for_first_then_each(
-            s->getPointVector(), [this](auto const& first) { cairo_move_to(cr, first.x, first.y); },
+            s->getPointArray(), [this](auto const& first) { cairo_move_to(cr, first.x, first.y); },
             [this](auto const& other) { cairo_line_to(cr, other.x, other.y); });
     cairo_stroke(cr);
 
@@ -112,15 +112,17 @@ void StrokeView::drawNoPressure() {
 void StrokeView::drawWithPressure() {
     double dashOffset = 0;
 
-    for (auto p1i = begin(s->getPointVector()), p2i = std::next(p1i), endi = end(s->getPointVector());
-         p1i != endi && p2i != endi; ++p1i, ++p2i) {
-        auto width = p1i->z != Point::NO_PRESSURE ? p1i->z : s->getWidth();
+    const PointArray& points = s->getPointArray();
+    for (size_t i = 0; i + 1 < points.size(); i++) {
+        Point p1 = points[i];
+        Point p2 = points[i + 1];
+        auto width = p1.z != Point::NO_PRESSURE ? p1.z : s->getWidth();
         cairo_set_line_width(cr, width * scaleFactor);
         applyDashed(dashOffset);
-        cairo_move_to(cr, p1i->x, p1i->y);
-        cairo_line_to(cr, p2i->x, p2i->y);
+        cairo_move_to(cr, p1.x, p1.y);
+        cairo_line_to(cr, p2.x, p2.y);
         cairo_stroke(cr);
-        dashOffset += p1i->lineLengthTo(*p2i);
+        dashOffset += p1.lineLengthTo(p2);
     }
 }
 
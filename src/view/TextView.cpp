@@ -15,6 +15,8 @@ static int textDpi = 72;
 
 void TextView::setDpi(int dpi) { textDpi = dpi; }
 
+auto TextView::getDpi() -> int { return textDpi; }
+
 auto TextView::initPango(cairo_t* cr, Text* t) -> PangoLayout* {
     PangoLayout* layout = pango_cairo_create_layout(cr);
 
@@ -30,6 +32,23 @@ auto TextView::initPango(cairo_t* cr, Text* t) -> PangoLayout* {
     return layout;
 }
 
+auto TextView::createLayout(PangoFontMap* fontMap) -> PangoLayout* {
+    PangoContext* context = pango_font_map_create_context(fontMap);
+    pango_cairo_context_set_resolution(context, textDpi);
+
+    // The font options of an image surface, the size was always calculated with them
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_surface_get_font_options(surface, options);
+    pango_cairo_context_set_font_options(context, options);
+    cairo_font_options_destroy(options);
+    cairo_surface_destroy(surface);
+
+    PangoLayout* layout = pango_layout_new(context);
+    g_object_unref(context);
+    return layout;
+}
+
 void TextView::updatePangoFont(PangoLayout* layout, Text* t) {
     PangoFontDescription* desc = pango_font_description_from_string(t->getFont().getName().c_str());
     // pango_font_description_set_absolute_size(desc, t->getFont().getSize() * PANGO_SCALE);
@@ -44,71 +63,63 @@ void TextView::drawText(cairo_t* cr, Text* t) {
 
     cairo_translate(cr, t->getX(), t->getY());
 
-    PangoLayout* layout = initPango(cr, t);
-    string str = t->getText();
-    pango_layout_set_text(layout, str.c_str(), str.length());
-
-    pango_cairo_show_layout(cr, layout);
-
-    g_object_unref(layout);
+    if (cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE) {
+        t->useLayout([cr](PangoLayout* layout) { pango_cairo_show_layout(cr, layout); });
+    } else {
+        // PDF export and printing use the font options of their surface
+        PangoLayout* layout = initPango(cr, t);
+        string str = t->getText();
+        pango_layout_set_text(layout, str.c_str(), str.length());
+        pango_cairo_show_layout(cr, layout);
+        g_object_unref(layout);
+    }
 
     cairo_restore(cr);
 }
 
 auto TextView::findText(Text* t, string& search) -> vector<XojPdfRectangle> {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    cairo_t* cr = cairo_create(surface);
-
-    PangoLayout* layout = initPango(cr, t);
-    string str = t->getText();
-    pango_layout_set_text(layout, str.c_str(), str.length());
-
-
-    string text = t->getText();
-
+    string text = StringUtils::toLowerCase(t->getText());
     string srch = StringUtils::toLowerCase(search);
 
+    vector<size_t> found;
+    for (size_t pos = text.find(srch); pos != string::npos; pos = text.find(srch, pos + 1)) {
+        found.push_back(pos);
+    }
+
     vector<XojPdfRectangle> list;
+    if (found.empty()) {
+        return list;
+    }
+
+    // Before the layout is locked, the position may measure the text
+    double x = t->getX();
+    double y = t->getY();
 
-    int pos = -1;
-    do {
-        pos = StringUtils::toLowerCase(text).find(srch, pos + 1);
-        if (pos != -1) {
+    t->useLayout([&](PangoLayout* layout) {
+        for (size_t pos: found) {
             XojPdfRectangle mark;
             PangoRectangle rect = {0};
             pango_layout_index_to_pos(layout, pos, &rect);
-            mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + t->getX();
-            mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + t->getY();
+            mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + x;
+            mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + y;
 
             pango_layout_index_to_pos(layout, pos + srch.length(), &rect);
-            mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + t->getX();
-            mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + t->getY();
+            mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + x;
+            mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + y;
 
             list.push_back(mark);
         }
-    } while (pos != -1);
-
-    g_object_unref(layout);
-    cairo_surface_destroy(surface);
-    cairo_destroy(cr);
+    });
 
     return list;
 }
 
 void TextView::calcSize(Text* t, double& width, double& height) {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    cairo_t* cr = cairo_create(surface);
-
-    PangoLayout* layout = initPango(cr, t);
-    string str = t->getText();
-    pango_layout_set_text(layout, str.c_str(), str.length());
-    int w = 0;
-    int h = 0;
-    pango_layout_get_size(layout, &w, &h);
-    width = (static_cast<double>(w)) / PANGO_SCALE;
-    height = (static_cast<double>(h)) / PANGO_SCALE;
-    g_object_unref(layout);
-
-    cairo_surface_destroy(surface);
-    cairo_destroy(cr);
+    t->useLayout([&](PangoLayout* layout) {
+        int w = 0;
+        int h = 0;
+        pango_layout_get_size(layout, &w, &h);
+        width = (static_cast<double>(w)) / PANGO_SCALE;
+        height = (static_cast<double>(h)) / PANGO_SCALE;
+    });
 }
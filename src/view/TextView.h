@@ -24,6 +24,7 @@ private:
 
 public:
     static void setDpi(int dpi);
+    static int getDpi();
 
     /**
      * Calculates the size of a Text model
@@ -45,6 +46,11 @@ public:
      */
     static PangoLayout* initPango(cairo_t* cr, Text* t);
 
+    /**
+     * Creates a layout which is independent of a cairo context, so it can be cached and drawn to any context
+     */
+    static PangoLayout* createLayout(PangoFontMap* fontMap);
+
     /**
      * Sets the font name from Text model
      */
@@ -0,0 +1,141 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+
+#include <config-test.h>
+
+#include "control/shaperecognizer/InertiaSums.h"
+#include "model/Stroke.h"
+
+#ifdef TEST_CHECK_SPEED
+#include "SpeedTest.cpp"
+#endif
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class InertiaSumsTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(InertiaSumsTest);
+
+#ifdef TEST_CHECK_SPEED
+    CPPUNIT_TEST(testSpeedSegments);
+#endif
+
+    CPPUNIT_TEST(testSegments);
+    CPPUNIT_TEST(testEmpty);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    /**
+     * A circle far from the origin, with a straight part
+     */
+    static vector<Point> createPoints(int count) {
+        vector<Point> points;
+        for (int i = 0; i < count; i++) {
+            if (i < count / 3) {
+                points.emplace_back(5000 + i * 2.0, 3000);
+            } else {
+                points.emplace_back(5000 + 100 * std::cos(i * 0.1), 3000 + 100 * std::sin(i * 0.1));
+            }
+        }
+        return points;
+    }
+
+    static void assertEqual(const Inertia& expected, const Inertia& actual) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.getMass(), actual.getMass(), 1e-6);
+        if (expected.getMass() == 0) {
+            return;
+        }
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.centerX(), actual.centerX(), 1e-6);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.centerY(), actual.centerY(), 1e-6);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.xx(), actual.xx(), 1e-4);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.xy(), actual.xy(), 1e-4);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.yy(), actual.yy(), 1e-4);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.det(), actual.det(), 1e-6);
+    }
+
+    void testSegments() {
+        vector<Point> points = createPoints(300);
+
+        InertiaSums sums;
+        for (const Point& p: points) {
+            sums.addPoint(p);
+        }
+        CPPUNIT_ASSERT_EQUAL(300, sums.getPointCount());
+
+        for (int start = 0; start < 300; start += 7) {
+            for (int end = start; end <= 300; end += 11) {
+                Inertia expected;
+                expected.calc(points.data(), start, end);
+                assertEqual(expected, sums.get(start, end));
+            }
+        }
+
+        // Same result if computed from the stroke
+        Stroke stroke;
+        for (const Point& p: points) {
+            stroke.addPoint(p);
+        }
+        InertiaSums fromStroke;
+        fromStroke.calc(&stroke);
+        assertEqual(sums.get(0, 300), fromStroke.get(0, 300));
+    }
+
+    void testEmpty() {
+        InertiaSums sums;
+        CPPUNIT_ASSERT_EQUAL(0, sums.getPointCount());
+        CPPUNIT_ASSERT_EQUAL(0.0, sums.get(0, 0).getMass());
+
+        sums.addPoint(Point(1, 2));
+        CPPUNIT_ASSERT_EQUAL(0.0, sums.get(0, 1).getMass());
+
+        sums.addPoint(Point(4, 6));
+        CPPUNIT_ASSERT_EQUAL(5.0, sums.get(0, 2).getMass());
+        CPPUNIT_ASSERT_EQUAL(1.0, sums.get(0, 2).centerX());
+        CPPUNIT_ASSERT_EQUAL(2.0, sums.get(0, 2).centerY());
+
+        sums.clear();
+        CPPUNIT_ASSERT_EQUAL(0, sums.getPointCount());
+    }
+
+#ifdef TEST_CHECK_SPEED
+    void testSpeedSegments() {
+        vector<Point> points = createPoints(100000);
+
+        InertiaSums sums;
+        for (const Point& p: points) {
+            sums.addPoint(p);
+        }
+
+        SpeedTest speed;
+        speed.startTest("inertia of 1000 parts of 100000 points, calc");
+        for (int i = 0; i < 1000; i++) {
+            Inertia s;
+            s.calc(points.data(), i * 50, 50000 + i * 50);
+        }
+        speed.endTest();
+
+        speed.startTest("inertia of 1000 parts of 100000 points, prefix sums");
+        for (int i = 0; i < 1000; i++) {
+            sums.get(i * 50, 50000 + i * 50);
+        }
+        speed.endTest();
+    }
+#endif
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(InertiaSumsTest);
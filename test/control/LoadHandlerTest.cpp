@@ -29,6 +29,7 @@ class LoadHandlerTest: public CppUnit::TestFixture {
 
 #ifdef TEST_CHECK_SPEED
     CPPUNIT_TEST(testSpeed);
+    CPPUNIT_TEST(testStrokeMemory);
 #endif
 
     CPPUNIT_TEST(testLoad);
@@ -46,6 +47,7 @@ class LoadHandlerTest: public CppUnit::TestFixture {
     CPPUNIT_TEST(testStroke);
     CPPUNIT_TEST(loadImage);
     CPPUNIT_TEST(testLoadStoreLoad);
+    CPPUNIT_TEST(testStorePageEntries);
 
 #ifdef __linux__
     CPPUNIT_TEST(testLoadStoreLoadGerman);
@@ -78,6 +80,33 @@ public:
 
         speed.endTest();
     }
+
+    /**
+     * Memory used by the stroke points, compared to an array of Point
+     */
+    void testStrokeMemory() {
+        LoadHandler handler;
+        Document* doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp"));
+        CPPUNIT_ASSERT(doc != nullptr);
+
+        size_t pointCount = 0;
+        size_t memory = 0;
+        for (size_t i = 0; i < doc->getPageCount(); i++) {
+            for (Layer* layer: *doc->getPage(i)->getLayers()) {
+                for (Element* e: *layer->getElements()) {
+                    if (e->getType() == ELEMENT_STROKE) {
+                        const PointArray& points = ((Stroke*)e)->getPointArray();
+                        pointCount += points.size();
+                        memory += points.getMemoryUsage();
+                    }
+                }
+            }
+        }
+
+        std::cout << std::endl
+                  << "stroke points: " << pointCount << ", " << memory << " bytes (" << pointCount * sizeof(Point)
+                  << " bytes as Point array)" << std::endl;
+    }
 #endif
 
     void testLoad() {
@@ -381,6 +410,36 @@ public:
         }
     }
 
+    void testStorePageEntries() {
+        LoadHandler handler;
+        Document* doc1 = handler.loadDocument(GET_TESTFILE("packaged_xopp/pages.xopp"));
+        CPPUNIT_ASSERT(doc1 != nullptr);
+
+        SaveHandler h;
+        h.prepareSave(doc1);
+        Path tmp = Util::getTmpDirSubfolder() / "pages.xopp";
+        h.saveTo(tmp);
+        CPPUNIT_ASSERT_EQUAL(string(""), h.getErrorMessage());
+
+        // Each page is stored in its own entry
+        int zipError = 0;
+        zip_t* zipFp = zip_open(tmp.c_str(), ZIP_RDONLY, &zipError);
+        CPPUNIT_ASSERT(zipFp != nullptr);
+        for (size_t i = 1; i <= doc1->getPageCount(); i++) {
+            string entry = "pages/page" + std::to_string(i) + ".xml";
+            CPPUNIT_ASSERT(zip_name_locate(zipFp, entry.c_str(), 0) >= 0);
+        }
+        zip_close(zipFp);
+
+        LoadHandler handler2;
+        Document* doc2 = handler2.loadDocument(tmp.str());
+        CPPUNIT_ASSERT(doc2 != nullptr);
+        CPPUNIT_ASSERT_EQUAL(doc1->getPageCount(), doc2->getPageCount());
+        for (size_t i = 0; i < doc1->getPageCount(); i++) {
+            CPPUNIT_ASSERT(doc1->getPage(i)->getBackgroundType() == doc2->getPage(i)->getBackgroundType());
+        }
+    }
+
 #ifdef __linux__
     void testLoadStoreLoadGerman() {
         constexpr auto testLocale = "de_DE.UTF-8";
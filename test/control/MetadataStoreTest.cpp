@@ -0,0 +1,310 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <config-test.h>
+#include <glib/gstdio.h>
+
+#include "control/settings/MetadataStore.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using std::string;
+using std::vector;
+
+class MetadataStoreTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(MetadataStoreTest);
+
+    CPPUNIT_TEST(testPutAndGet);
+    CPPUNIT_TEST(testNewestEntryWins);
+    CPPUNIT_TEST(testReadAppendedEntries);
+    CPPUNIT_TEST(testOwnEntriesNotCountedTwice);
+    CPPUNIT_TEST(testTruncatedLastLine);
+    CPPUNIT_TEST(testInvalidRecord);
+    CPPUNIT_TEST(testRewrittenByOtherInstance);
+    CPPUNIT_TEST(testCompactOnLoad);
+    CPPUNIT_TEST(testCompactWithoutHeader);
+    CPPUNIT_TEST(testMaxEntries);
+    CPPUNIT_TEST(testMigrateLegacyFolder);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {
+        gchar* dir = g_dir_make_tmp("xournalpp-metadata-XXXXXX", nullptr);
+        CPPUNIT_ASSERT(dir != nullptr);
+        this->folder = dir;
+        g_free(dir);
+
+        this->logFile = this->folder / "metadata.log";
+        this->legacyFolder = this->folder / "metadata";
+    }
+
+    void tearDown() {
+        removeLegacyFolder();
+        g_unlink(this->logFile.c_str());
+        g_rmdir(this->folder.c_str());
+    }
+
+    static MetadataEntry createEntry(const string& path, gint64 time, int page = 1, double zoom = 1.5) {
+        MetadataEntry entry;
+        entry.valid = true;
+        entry.path = path;
+        entry.time = time;
+        entry.page = page;
+        entry.zoom = zoom;
+        return entry;
+    }
+
+    void writeLog(const string& contents) {
+        CPPUNIT_ASSERT(g_file_set_contents(this->logFile.c_str(), contents.c_str(), contents.length(), nullptr));
+    }
+
+    void appendLog(const string& contents) {
+        std::ofstream out(this->logFile.c_str(), std::ios::app | std::ios::binary);
+        out << contents;
+    }
+
+    vector<string> readLogLines() {
+        vector<string> lines;
+        std::ifstream in(this->logFile.c_str(), std::ios::binary);
+        string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    void removeLegacyFolder() {
+        GDir* dir = g_dir_open(this->legacyFolder.c_str(), 0, nullptr);
+        if (dir == nullptr) {
+            return;
+        }
+        const gchar* file = nullptr;
+        while ((file = g_dir_read_name(dir)) != nullptr) {
+            g_unlink((this->legacyFolder / file).c_str());
+        }
+        g_dir_close(dir);
+        g_rmdir(this->legacyFolder.c_str());
+    }
+
+    void testPutAndGet() {
+        {
+            MetadataStore store(this->logFile, this->legacyFolder);
+            CPPUNIT_ASSERT(!store.get("/tmp/a.xopp").valid);
+
+            store.put(createEntry("/tmp/a.xopp", 10, 3, 2.5));
+            store.put(createEntry("/tmp/with space\nand newline.xopp", 11));
+        }
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        MetadataEntry a = store.get("/tmp/a.xopp");
+        CPPUNIT_ASSERT(a.valid);
+        CPPUNIT_ASSERT_EQUAL(3, a.page);
+        CPPUNIT_ASSERT_EQUAL(2.5, a.zoom);
+        CPPUNIT_ASSERT_EQUAL(static_cast<gint64>(10), a.time);
+
+        CPPUNIT_ASSERT(store.get("/tmp/with space\nand newline.xopp").valid);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), store.getCount());
+    }
+
+    void testNewestEntryWins() {
+        {
+            MetadataStore store(this->logFile, this->legacyFolder);
+            store.put(createEntry("/tmp/a.xopp", 20, 5));
+        }
+        // Another instance may append an older entry later
+        appendLog("10 7 1 /tmp/a.xopp\n");
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        CPPUNIT_ASSERT_EQUAL(5, store.get("/tmp/a.xopp").page);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), store.getCount());
+    }
+
+    void testReadAppendedEntries() {
+        MetadataStore first(this->logFile, this->legacyFolder);
+        MetadataStore second(this->logFile, this->legacyFolder);
+
+        first.put(createEntry("/tmp/a.xopp", 10, 1));
+        CPPUNIT_ASSERT_EQUAL(1, second.get("/tmp/a.xopp").page);
+
+        // Only the new part of the log is read
+        first.put(createEntry("/tmp/a.xopp", 11, 2));
+        first.put(createEntry("/tmp/b.xopp", 12, 3));
+        CPPUNIT_ASSERT_EQUAL(2, second.get("/tmp/a.xopp").page);
+        CPPUNIT_ASSERT_EQUAL(3, second.get("/tmp/b.xopp").page);
+
+        // And the other way round
+        second.put(createEntry("/tmp/c.xopp", 13, 4));
+        CPPUNIT_ASSERT_EQUAL(4, first.get("/tmp/c.xopp").page);
+    }
+
+    void testOwnEntriesNotCountedTwice() {
+        {
+            MetadataStore store(this->logFile, this->legacyFolder);
+            store.put(createEntry("/tmp/a.xopp", 10));
+            store.put(createEntry("/tmp/b.xopp", 11));
+            store.get("/tmp/a.xopp");
+            store.put(createEntry("/tmp/c.xopp", 12));
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), store.getCount());
+        }
+
+        // Nothing was appended twice
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), readLogLines().size());
+    }
+
+    void testTruncatedLastLine() {
+        {
+            MetadataStore store(this->logFile, this->legacyFolder);
+            store.put(createEntry("/tmp/a.xopp", 10));
+        }
+        // Another instance is still writing its record
+        appendLog("11 2 1 /tmp/b");
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        CPPUNIT_ASSERT(store.get("/tmp/a.xopp").valid);
+        CPPUNIT_ASSERT(!store.get("/tmp/b").valid);
+        CPPUNIT_ASSERT(!store.get("/tmp/b.xopp").valid);
+
+        // The line is read completely once it is finished
+        appendLog(".xopp\n");
+        MetadataEntry b = store.get("/tmp/b.xopp");
+        CPPUNIT_ASSERT(b.valid);
+        CPPUNIT_ASSERT_EQUAL(2, b.page);
+    }
+
+    void testInvalidRecord() {
+        {
+            MetadataStore store(this->logFile, this->legacyFolder);
+            store.put(createEntry("/tmp/a.xopp", 10));
+        }
+        appendLog("garbage\n12 3 1 /tmp/b.xopp\n");
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        CPPUNIT_ASSERT(store.get("/tmp/a.xopp").valid);
+        CPPUNIT_ASSERT_EQUAL(3, store.get("/tmp/b.xopp").page);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), store.getCount());
+    }
+
+    void testRewrittenByOtherInstance() {
+        MetadataStore store(this->logFile, this->legacyFolder);
+        store.put(createEntry("/tmp/a.xopp", 10, 1));
+        CPPUNIT_ASSERT(store.get("/tmp/a.xopp").valid);
+
+        // Compacted by another instance with a new header, the log did not shrink
+        writeLog("XOJ-METADATA-LOG/1.0 other-generation\n"
+                 "10 1 1 /tmp/a.xopp\n"
+                 "20 8 2 /tmp/a-much-longer-path-than-before.xopp\n");
+
+        MetadataEntry entry = store.get("/tmp/a-much-longer-path-than-before.xopp");
+        CPPUNIT_ASSERT(entry.valid);
+        CPPUNIT_ASSERT_EQUAL(8, entry.page);
+
+        // The own entries are kept, and appended to the new log
+        CPPUNIT_ASSERT(store.get("/tmp/a.xopp").valid);
+        store.put(createEntry("/tmp/b.xopp", 30, 9));
+
+        MetadataStore other(this->logFile, this->legacyFolder);
+        CPPUNIT_ASSERT_EQUAL(9, other.get("/tmp/b.xopp").page);
+        CPPUNIT_ASSERT_EQUAL(8, other.get("/tmp/a-much-longer-path-than-before.xopp").page);
+    }
+
+    void testCompactOnLoad() {
+        string contents = "XOJ-METADATA-LOG/1.0\n";
+        // Many outdated records of the same files
+        for (int i = 0; i < 1100; i++) {
+            contents += std::to_string(i) + " " + std::to_string(i) + " 1 /tmp/" + std::to_string(i % 2) + ".xopp\n";
+        }
+        writeLog(contents);
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), store.getCount());
+        CPPUNIT_ASSERT_EQUAL(1099, store.get("/tmp/1.xopp").page);
+        CPPUNIT_ASSERT_EQUAL(1098, store.get("/tmp/0.xopp").page);
+
+        vector<string> lines = readLogLines();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), lines.size());
+        CPPUNIT_ASSERT(g_str_has_prefix(lines[0].c_str(), "XOJ-METADATA-LOG/1.0 "));
+    }
+
+    void testCompactWithoutHeader() {
+        writeLog("10 4 1 /tmp/a.xopp\n11 5 1 /tmp/b.xopp\n");
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        // The first line is no header, so the log is rewritten. The record in its place is lost.
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), store.getCount());
+        CPPUNIT_ASSERT(!store.get("/tmp/a.xopp").valid);
+        CPPUNIT_ASSERT_EQUAL(5, store.get("/tmp/b.xopp").page);
+
+        vector<string> lines = readLogLines();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), lines.size());
+        CPPUNIT_ASSERT(g_str_has_prefix(lines[0].c_str(), "XOJ-METADATA-LOG/1.0"));
+    }
+
+    void testMaxEntries() {
+        size_t count = MetadataStore::MAX_ENTRIES + 5;
+        string contents = "XOJ-METADATA-LOG/1.0\n";
+        for (size_t i = 0; i < count; i++) {
+            contents += std::to_string(i) + " 1 1 /tmp/" + std::to_string(i) + ".xopp\n";
+        }
+        writeLog(contents);
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        CPPUNIT_ASSERT_EQUAL(MetadataStore::MAX_ENTRIES, store.getCount());
+
+        // The oldest entries are dropped
+        CPPUNIT_ASSERT(!store.get("/tmp/0.xopp").valid);
+        CPPUNIT_ASSERT(!store.get("/tmp/4.xopp").valid);
+        CPPUNIT_ASSERT(store.get("/tmp/5.xopp").valid);
+        CPPUNIT_ASSERT(store.get("/tmp/" + std::to_string(count - 1) + ".xopp").valid);
+
+        CPPUNIT_ASSERT_EQUAL(MetadataStore::MAX_ENTRIES + 1, readLogLines().size());
+    }
+
+    void testMigrateLegacyFolder() {
+        CPPUNIT_ASSERT_EQUAL(0, g_mkdir(this->legacyFolder.c_str(), 0700));
+
+        string legacy = "XOJ-METADATA/1.0\n/tmp/legacy.xoj\npage=6\nzoom=1.25\n";
+        string file = (this->legacyFolder / "1234.metadata").str();
+        CPPUNIT_ASSERT(g_file_set_contents(file.c_str(), legacy.c_str(), legacy.length(), nullptr));
+
+        string invalid = "something else\n";
+        string invalidFile = (this->legacyFolder / "1235.metadata").str();
+        CPPUNIT_ASSERT(g_file_set_contents(invalidFile.c_str(), invalid.c_str(), invalid.length(), nullptr));
+
+        {
+            MetadataStore store(this->logFile, this->legacyFolder);
+            MetadataEntry entry = store.get("/tmp/legacy.xoj");
+            CPPUNIT_ASSERT(entry.valid);
+            CPPUNIT_ASSERT_EQUAL(6, entry.page);
+            CPPUNIT_ASSERT_EQUAL(1.25, entry.zoom);
+            CPPUNIT_ASSERT_EQUAL(static_cast<gint64>(1234), entry.time);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), store.getCount());
+        }
+
+        // The folder is deleted, the entry was written to the log
+        CPPUNIT_ASSERT(!g_file_test(this->legacyFolder.c_str(), G_FILE_TEST_EXISTS));
+
+        MetadataStore store(this->logFile, this->legacyFolder);
+        CPPUNIT_ASSERT_EQUAL(6, store.get("/tmp/legacy.xoj").page);
+    }
+
+private:
+    Path folder;
+    Path logFile;
+    Path legacyFolder;
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(MetadataStoreTest);
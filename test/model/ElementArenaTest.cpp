@@ -0,0 +1,215 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <config-test.h>
+
+#include "model/ElementArena.h"
+#include "model/Stroke.h"
+
+#ifdef TEST_CHECK_SPEED
+#include "SpeedTest.cpp"
+#endif
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ElementArenaTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(ElementArenaTest);
+
+#ifdef TEST_CHECK_SPEED
+    CPPUNIT_TEST(testSpeedDelete);
+#endif
+
+    CPPUNIT_TEST(testAllocate);
+    CPPUNIT_TEST(testDeleteAfterRelease);
+    CPPUNIT_TEST(testMixed);
+    CPPUNIT_TEST(testMoveOutOfArena);
+    CPPUNIT_TEST(testReuseDeleted);
+    CPPUNIT_TEST(testNoReuseAfterRelease);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    static Stroke* createStroke(ElementArena* arena, int count) {
+        auto* s = new (arena) Stroke(arena);
+        vector<Point> points;
+        for (int i = 0; i < count; i++) {
+            points.emplace_back(i, i * 2);
+        }
+        s->addPoints(points);
+        return s;
+    }
+
+    void testAllocate() {
+        auto* arena = new ElementArena();
+
+        vector<Stroke*> strokes;
+        for (int i = 0; i < 10; i++) {
+            strokes.push_back(createStroke(arena, 3));
+        }
+        CPPUNIT_ASSERT_EQUAL((size_t)10, arena->getElementCount());
+
+        // The elements are next to each other
+        for (int i = 1; i < 10; i++) {
+            auto distance = reinterpret_cast<char*>(strokes[i]) - reinterpret_cast<char*>(strokes[i - 1]);
+            CPPUNIT_ASSERT(distance > 0);
+            CPPUNIT_ASSERT(distance < static_cast<long>(2 * sizeof(Stroke) + 6 * sizeof(Coordinate)));
+        }
+        CPPUNIT_ASSERT_EQUAL(3, strokes[9]->getPointCount());
+
+        delete strokes[0];
+        CPPUNIT_ASSERT_EQUAL((size_t)9, arena->getElementCount());
+
+        for (int i = 1; i < 10; i++) {
+            delete strokes[i];
+        }
+        CPPUNIT_ASSERT_EQUAL((size_t)0, arena->getElementCount());
+
+        arena->release();
+    }
+
+    void testDeleteAfterRelease() {
+        auto* arena = new ElementArena();
+
+        vector<Stroke*> strokes;
+        // More than one block
+        for (int i = 0; i < 1000; i++) {
+            strokes.push_back(createStroke(arena, i % 5));
+        }
+        CPPUNIT_ASSERT(arena->getMemoryUsage() >= 1000 * sizeof(Stroke));
+        arena->release();
+
+        // The elements are still valid, the arena is freed with the last one
+        vector<Stroke*> copies;
+        for (Stroke* s: strokes) {
+            s->addPoint(Point(1, 2, 3));
+            copies.push_back(s->cloneStroke());
+            delete s;
+        }
+
+        // The copies are allocated from the heap
+        for (int i = 0; i < 1000; i++) {
+            CPPUNIT_ASSERT_EQUAL(i % 5 + 1, copies[i]->getPointCount());
+            CPPUNIT_ASSERT_EQUAL(3.0, copies[i]->getPoint(i % 5).z);
+            delete copies[i];
+        }
+    }
+
+    void testMixed() {
+        ElementArenaPtr arena(new ElementArena());
+
+        std::unique_ptr<Element> a(createStroke(arena.get(), 2));
+        std::unique_ptr<Element> b(createStroke(nullptr, 2));
+        std::unique_ptr<Element> c(new Stroke());
+
+        CPPUNIT_ASSERT_EQUAL((size_t)1, arena->getElementCount());
+        arena.reset();
+
+        a.reset();
+        b.reset();
+        c.reset();
+    }
+
+    void testMoveOutOfArena() {
+        auto* arena = new ElementArena();
+
+        Stroke* s = createStroke(arena, 4);
+        CPPUNIT_ASSERT(s->getPointArray().getArena() == arena);
+
+        // The moved points still reference the arena, it stays alive until they are freed
+        auto* moved = new Stroke(std::move(*s));
+        delete s;
+        arena->release();
+        CPPUNIT_ASSERT_EQUAL(4, moved->getPointCount());
+        CPPUNIT_ASSERT(moved->getPointArray().getArena() == arena);
+
+        // Growing after the release moves the points to the heap
+        moved->addPoint(Point(1, 2));
+        moved->freeUnusedPointItems();
+        CPPUNIT_ASSERT(moved->getPointArray().getArena() == nullptr);
+        CPPUNIT_ASSERT_EQUAL(5, moved->getPointCount());
+        CPPUNIT_ASSERT_EQUAL(2.0, moved->getPoint(1).y);
+
+        delete moved;
+    }
+
+    void testReuseDeleted() {
+        auto* arena = new ElementArena();
+
+        Stroke* a = createStroke(arena, 3);
+        Stroke* b = createStroke(arena, 3);
+        delete a;
+
+        // The memory of the deleted stroke is used again
+        Stroke* c = createStroke(arena, 3);
+        CPPUNIT_ASSERT(c == a);
+
+        // Deleted strokes and points don't let the arena grow
+        size_t usage = arena->getMemoryUsage();
+        for (int i = 0; i < 10000; i++) {
+            delete createStroke(arena, i % 20);
+        }
+        CPPUNIT_ASSERT_EQUAL(usage, arena->getMemoryUsage());
+
+        delete b;
+        delete c;
+        arena->release();
+    }
+
+    void testNoReuseAfterRelease() {
+        auto* arena = new ElementArena();
+
+        Stroke* a = createStroke(arena, 3);
+        Stroke* b = createStroke(arena, 3);
+        arena->release();
+
+        // The memory is only freed with the arena
+        delete a;
+        CPPUNIT_ASSERT_EQUAL((size_t)1, arena->getElementCount());
+
+        // Growing data is moved to the heap, the arena data is not reused
+        for (int i = 0; i < 100; i++) {
+            b->addPoint(Point(i, i));
+        }
+        CPPUNIT_ASSERT(b->getPointArray().getArena() == nullptr);
+        CPPUNIT_ASSERT_EQUAL(103, b->getPointCount());
+        CPPUNIT_ASSERT_EQUAL(2.0, b->getPoint(1).y);
+
+        delete b;
+    }
+
+#ifdef TEST_CHECK_SPEED
+    void testSpeedDelete() {
+        for (bool useArena: {false, true}) {
+            ElementArenaPtr arena(useArena ? new ElementArena() : nullptr);
+
+            vector<Stroke*> strokes;
+            for (int i = 0; i < 1000000; i++) {
+                strokes.push_back(createStroke(arena.get(), 50));
+            }
+            arena.reset();
+
+            SpeedTest speed;
+            speed.startTest(useArena ? "delete 1000000 strokes, arena" : "delete 1000000 strokes, heap");
+            for (Stroke* s: strokes) {
+                delete s;
+            }
+            speed.endTest();
+        }
+    }
+#endif
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(ElementArenaTest);
@@ -0,0 +1,234 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <config-test.h>
+
+#include "model/Stroke.h"
+#include "model/eraser/EraseableStroke.h"
+#include "util/Range.h"
+
+#ifdef TEST_CHECK_SPEED
+#include "SpeedTest.cpp"
+#endif
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class EraseableStrokeTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(EraseableStrokeTest);
+
+#ifdef TEST_CHECK_SPEED
+    CPPUNIT_TEST(testSpeedErase);
+#endif
+
+    CPPUNIT_TEST(testEraseNothing);
+    CPPUNIT_TEST(testEraseStart);
+    CPPUNIT_TEST(testEraseMiddle);
+    CPPUNIT_TEST(testEraseTwice);
+    CPPUNIT_TEST(testEraseAll);
+    CPPUNIT_TEST(testCopiedRanges);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    /**
+     * Horizontal stroke from (0, 0) to (count - 1, 0)
+     */
+    static Stroke* createStroke(int count, bool pressure) {
+        auto* s = new Stroke();
+        s->setWidth(1);
+        for (int i = 0; i < count; i++) {
+            if (pressure) {
+                s->addPoint(Point(i, 0, 1 + (i % 10) / 10.0));
+            } else {
+                s->addPoint(Point(i, 0));
+            }
+        }
+        return s;
+    }
+
+    static vector<Stroke*> getStrokes(EraseableStroke& e, Stroke* original) {
+        vector<EraseableStroke::CopiedRange> copied;
+        return e.getStroke(original, copied);
+    }
+
+    static void freeStrokes(vector<Stroke*>& strokes) {
+        for (Stroke* s: strokes) {
+            delete s;
+        }
+        strokes.clear();
+    }
+
+#ifdef TEST_CHECK_SPEED
+    void testSpeedErase() {
+        Stroke* s = createStroke(10000, true);
+        EraseableStroke e(s);
+
+        SpeedTest speed;
+        speed.startTest("erase 10000 point stroke");
+
+        // Move the eraser along the stroke, and a second time on a line crossing it
+        for (int i = 0; i < 10000; i += 5) {
+            delete e.erase(i, 3, 2);
+        }
+        for (int i = 0; i < 10000; i += 2) {
+            delete e.erase(i, (i % 20) - 10, 2);
+        }
+
+        speed.endTest();
+
+        delete s;
+    }
+#endif
+
+    void testEraseNothing() {
+        Stroke* s = createStroke(101, false);
+        EraseableStroke e(s);
+
+        Range* range = e.erase(50, 50, 2);
+        CPPUNIT_ASSERT(range == nullptr);
+        CPPUNIT_ASSERT(!e.isModified());
+
+        vector<Stroke*> strokes = getStrokes(e, s);
+        CPPUNIT_ASSERT_EQUAL((size_t)1, strokes.size());
+        CPPUNIT_ASSERT_EQUAL(101, strokes[0]->getPointCount());
+
+        freeStrokes(strokes);
+        delete s;
+    }
+
+    void testEraseStart() {
+        Stroke* s = createStroke(101, false);
+        EraseableStroke e(s);
+
+        Range* range = e.erase(0, 0, 2);
+        CPPUNIT_ASSERT(range != nullptr);
+        delete range;
+
+        vector<Stroke*> strokes = getStrokes(e, s);
+        CPPUNIT_ASSERT_EQUAL((size_t)1, strokes.size());
+        CPPUNIT_ASSERT(strokes[0]->getPoint(0).x > 2);
+        CPPUNIT_ASSERT_EQUAL(100.0, strokes[0]->getPoint(strokes[0]->getPointCount() - 1).x);
+
+        freeStrokes(strokes);
+        delete s;
+    }
+
+    void testEraseMiddle() {
+        Stroke* s = createStroke(101, true);
+        EraseableStroke e(s);
+
+        delete e.erase(50.5, 0, 2);
+
+        vector<Stroke*> strokes = getStrokes(e, s);
+        CPPUNIT_ASSERT_EQUAL((size_t)2, strokes.size());
+
+        Stroke* first = strokes[0];
+        Stroke* second = strokes[1];
+        CPPUNIT_ASSERT_EQUAL(0.0, first->getPoint(0).x);
+        CPPUNIT_ASSERT(first->getPoint(first->getPointCount() - 1).x < 48.5);
+        CPPUNIT_ASSERT(second->getPoint(0).x > 52.5);
+        CPPUNIT_ASSERT_EQUAL(100.0, second->getPoint(second->getPointCount() - 1).x);
+
+        // The pressure of the unmodified points is kept
+        CPPUNIT_ASSERT_EQUAL(s->getPoint(10).z, first->getPoint(10).z);
+
+        freeStrokes(strokes);
+        delete s;
+    }
+
+    void testEraseTwice() {
+        Stroke* s = createStroke(101, false);
+        EraseableStroke e(s);
+
+        delete e.erase(30.5, 0, 2);
+        delete e.erase(70.5, 0, 2);
+        // Erase again at the same position, the split part is erased further
+        delete e.erase(72.5, 0, 2);
+
+        vector<Stroke*> strokes = getStrokes(e, s);
+        CPPUNIT_ASSERT_EQUAL((size_t)3, strokes.size());
+        CPPUNIT_ASSERT(strokes[1]->getPoint(strokes[1]->getPointCount() - 1).x < 68.5);
+        CPPUNIT_ASSERT(strokes[2]->getPoint(0).x > 74.5);
+
+        freeStrokes(strokes);
+        delete s;
+    }
+
+    void testEraseAll() {
+        Stroke* s = createStroke(3, false);
+        EraseableStroke e(s);
+
+        delete e.erase(1, 0, 10);
+        CPPUNIT_ASSERT(e.isModified());
+
+        vector<Stroke*> strokes = getStrokes(e, s);
+        CPPUNIT_ASSERT_EQUAL((size_t)0, strokes.size());
+
+        delete s;
+    }
+
+    /**
+     * The original stroke can be restored from the copied ranges and the other points, as the erase undo does
+     */
+    void testCopiedRanges() {
+        Stroke* s = createStroke(101, true);
+        // Two points at the same position
+        s->addPoint(Point(100, 0, 2));
+        s->addPoint(Point(101, 0, 1));
+        EraseableStroke e(s);
+
+        delete e.erase(30.5, 0, 2);
+        delete e.erase(70, 0, 2);
+        delete e.erase(100.5, 0, 0.2);
+
+        vector<EraseableStroke::CopiedRange> copied;
+        vector<Stroke*> strokes = e.getStroke(s, copied);
+        CPPUNIT_ASSERT(!copied.empty());
+
+        // Only the points around the erased positions are not copied
+        size_t copiedCount = 0;
+        for (const EraseableStroke::CopiedRange& range: copied) {
+            copiedCount += range.end - range.begin;
+        }
+        CPPUNIT_ASSERT(copiedCount > 80);
+
+        vector<Point> points;
+        for (const EraseableStroke::CopiedRange& range: copied) {
+            while (points.size() < range.begin) {
+                points.push_back(s->getPoint(points.size()));
+            }
+            CPPUNIT_ASSERT(range.stroke < strokes.size());
+            for (size_t i = 0; i < range.end - range.begin; i++) {
+                points.push_back(strokes[range.stroke]->getPoint(range.offset + i));
+            }
+        }
+        while (points.size() < static_cast<size_t>(s->getPointCount())) {
+            points.push_back(s->getPoint(points.size()));
+        }
+
+        for (size_t i = 0; i < points.size(); i++) {
+            Point p = s->getPoint(i);
+            CPPUNIT_ASSERT_EQUAL(p.x, points[i].x);
+            CPPUNIT_ASSERT_EQUAL(p.y, points[i].y);
+            CPPUNIT_ASSERT_EQUAL(p.z, points[i].z);
+        }
+
+        freeStrokes(strokes);
+        delete s;
+    }
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(EraseableStrokeTest);
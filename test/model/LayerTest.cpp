@@ -0,0 +1,249 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <random>
+
+#include <config-test.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+
+#ifdef TEST_CHECK_SPEED
+#include "SpeedTest.cpp"
+#endif
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LayerTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(LayerTest);
+
+#ifdef TEST_CHECK_SPEED
+    CPPUNIT_TEST(testSpeedRemove);
+#endif
+
+    CPPUNIT_TEST(testIndexOf);
+    CPPUNIT_TEST(testDuplicate);
+    CPPUNIT_TEST(testBatch);
+    CPPUNIT_TEST(testRandom);
+    CPPUNIT_TEST(testLookupAfterEdits);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    static vector<Element*> createElements(Layer& layer, int count) {
+        vector<Element*> elements;
+        for (int i = 0; i < count; i++) {
+            auto* s = new Stroke();
+            layer.addElement(s);
+            elements.push_back(s);
+        }
+        return elements;
+    }
+
+    static void checkLayer(Layer& layer, const vector<Element*>& expected) {
+        CPPUNIT_ASSERT(*layer.getElements() == expected);
+        for (size_t i = 0; i < expected.size(); i++) {
+            CPPUNIT_ASSERT_EQUAL(static_cast<Layer::ElementIndex>(i), layer.indexOf(expected[i]));
+        }
+    }
+
+    void testIndexOf() {
+        Layer layer;
+        vector<Element*> e = createElements(layer, 5);
+
+        CPPUNIT_ASSERT_EQUAL((Layer::ElementIndex)2, layer.removeElement(e[2], false));
+        CPPUNIT_ASSERT_EQUAL(Layer::InvalidElementIndex, layer.indexOf(e[2]));
+        CPPUNIT_ASSERT_EQUAL((Layer::ElementIndex)3, layer.indexOf(e[4]));
+
+        layer.insertElement(e[2], 0);
+        checkLayer(layer, {e[2], e[0], e[1], e[3], e[4]});
+
+        // Positions after the end append the element
+        CPPUNIT_ASSERT_EQUAL((Layer::ElementIndex)0, layer.removeElement(e[2], false));
+        layer.insertElement(e[2], 100);
+        checkLayer(layer, {e[0], e[1], e[3], e[4], e[2]});
+    }
+
+    void testDuplicate() {
+        Layer layer;
+        vector<Element*> e = createElements(layer, 3);
+
+        layer.addElement(e[1]);
+        layer.insertElement(e[0], 2);
+        layer.insertElements({{e[2], 0}});
+        checkLayer(layer, e);
+
+        Stroke other;
+        CPPUNIT_ASSERT_EQUAL(Layer::InvalidElementIndex, layer.removeElement(&other, false));
+        checkLayer(layer, e);
+    }
+
+    void testBatch() {
+        Layer layer;
+        vector<Element*> e = createElements(layer, 7);
+
+        // The positions before the removal are returned
+        vector<Layer::ElementIndex> positions = layer.removeElements({e[5], e[2], e[3]}, false);
+        CPPUNIT_ASSERT(positions == vector<Layer::ElementIndex>({5, 2, 3}));
+        checkLayer(layer, {e[0], e[1], e[4], e[6]});
+
+        // And restore the old order
+        layer.insertElements({{e[5], 5}, {e[2], 2}, {e[3], 3}});
+        checkLayer(layer, e);
+
+        // Not on the layer
+        positions = layer.removeElements({e[0], e[0]}, false);
+        CPPUNIT_ASSERT(positions == vector<Layer::ElementIndex>({0, Layer::InvalidElementIndex}));
+        checkLayer(layer, {e[1], e[2], e[3], e[4], e[5], e[6]});
+
+        layer.removeElements({e[6], e[1]}, true);
+        checkLayer(layer, {e[2], e[3], e[4], e[5]});
+
+        delete e[0];
+    }
+
+    /**
+     * Compare the layer with a list, for random modifications
+     */
+    void testRandom() {
+        std::mt19937 random(42);
+
+        Layer layer;
+        vector<Element*> expected;
+        vector<Element*> removed;
+
+        for (int i = 0; i < 3000; i++) {
+            int action = random() % 6;
+            if (action == 0 || expected.empty()) {
+                auto* s = new Stroke();
+                layer.addElement(s);
+                expected.push_back(s);
+            } else if (action == 1) {
+                Element* e = removed.empty() ? new Stroke() : removed.back();
+                if (!removed.empty()) {
+                    removed.pop_back();
+                }
+                size_t pos = random() % (expected.size() + 1);
+                layer.insertElement(e, pos);
+                expected.insert(expected.begin() + pos, e);
+            } else if (action == 2) {
+                size_t pos = random() % expected.size();
+                CPPUNIT_ASSERT_EQUAL(static_cast<Layer::ElementIndex>(pos), layer.removeElement(expected[pos], false));
+                removed.push_back(expected[pos]);
+                expected.erase(expected.begin() + pos);
+            } else if (action == 3) {
+                size_t pos = random() % expected.size();
+                CPPUNIT_ASSERT_EQUAL(static_cast<Layer::ElementIndex>(pos), layer.indexOf(expected[pos]));
+            } else if (action == 4) {
+                // Remove a few elements, and insert them again
+                vector<Element*> batch;
+                for (Element* e: expected) {
+                    if (random() % 4 == 0) {
+                        batch.push_back(e);
+                    }
+                }
+                std::shuffle(batch.begin(), batch.end(), random);
+
+                vector<Layer::ElementIndex> positions = layer.removeElements(batch, false);
+                vector<std::pair<Element*, Layer::ElementIndex>> insert;
+                for (size_t j = 0; j < batch.size(); j++) {
+                    CPPUNIT_ASSERT_EQUAL(batch[j], expected[positions[j]]);
+                    insert.emplace_back(batch[j], positions[j]);
+                }
+
+                layer.insertElements(insert);
+            } else {
+                // Ascending removal, like the eraser does
+                for (size_t pos = random() % 3; pos < expected.size(); pos += 1 + random() % 50) {
+                    layer.removeElement(expected[pos], false);
+                    removed.push_back(expected[pos]);
+                    expected.erase(expected.begin() + pos);
+                }
+            }
+        }
+
+        checkLayer(layer, expected);
+
+        for (Element* e: removed) {
+            delete e;
+        }
+    }
+
+    /**
+     * Many edits in front of the looked up elements, more than are recorded before the index is rebuilt
+     */
+    void testLookupAfterEdits() {
+        Layer layer;
+        vector<Element*> expected = createElements(layer, 5000);
+        vector<Element*> removed;
+
+        for (int i = 0; i < 1000; i++) {
+            if (i % 3 == 2) {
+                layer.insertElement(removed.back(), i % 7);
+                expected.insert(expected.begin() + i % 7, removed.back());
+                removed.pop_back();
+            } else {
+                layer.removeElement(expected[i % 5], false);
+                removed.push_back(expected[i % 5]);
+                expected.erase(expected.begin() + i % 5);
+            }
+
+            size_t last = expected.size() - 1 - i % 11;
+            CPPUNIT_ASSERT_EQUAL(static_cast<Layer::ElementIndex>(last), layer.indexOf(expected[last]));
+        }
+
+        checkLayer(layer, expected);
+
+        for (Element* e: removed) {
+            delete e;
+        }
+    }
+
+#ifdef TEST_CHECK_SPEED
+    void testSpeedRemove() {
+        Layer layer;
+        vector<Element*> elements = createElements(layer, 100000);
+
+        vector<Element*> selection;
+        for (size_t i = 0; i < elements.size(); i += 2) {
+            selection.push_back(elements[i]);
+        }
+
+        SpeedTest speed;
+        speed.startTest("remove 50000 of 100000 elements, one by one");
+        for (Element* e: selection) {
+            layer.removeElement(e, false);
+        }
+        speed.endTest();
+
+        vector<std::pair<Element*, Layer::ElementIndex>> insert;
+        for (size_t i = 0; i < selection.size(); i++) {
+            insert.emplace_back(selection[i], i * 2);
+        }
+
+        speed.startTest("insert 50000 elements, batch");
+        layer.insertElements(insert);
+        speed.endTest();
+
+        speed.startTest("remove 50000 of 100000 elements, batch");
+        layer.removeElements(selection, true);
+        speed.endTest();
+    }
+#endif
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(LayerTest);
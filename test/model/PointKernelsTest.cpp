@@ -0,0 +1,260 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+
+#include <config-test.h>
+
+#include "model/PointKernels.h"
+
+#ifdef TEST_CHECK_SPEED
+#include "SpeedTest.cpp"
+#endif
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace PointKernels;
+
+class PointKernelsTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(PointKernelsTest);
+
+#ifdef TEST_CHECK_SPEED
+    CPPUNIT_TEST(testSpeedBounds);
+    CPPUNIT_TEST(testSpeedTransform);
+    CPPUNIT_TEST(testSpeedEraserCandidate);
+#endif
+
+    CPPUNIT_TEST(testBounds);
+    CPPUNIT_TEST(testTransform);
+    CPPUNIT_TEST(testEraserCandidate);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() { setInstructionSet(getSupportedInstructionSet()); }
+
+    /**
+     * A wave with a few jumps, and a pressure which changes on every point
+     */
+    static PointArray createPoints(size_t count) {
+        PointArray points;
+        for (size_t i = 0; i < count; i++) {
+            double jump = (i % 97 == 0) ? 50 : 0;
+            points.push_back(Point(i * 0.5 + jump, std::sin(i * 0.05) * 30 - jump, 0.5 + (i % 7) / 5.0));
+        }
+        return points;
+    }
+
+    static Bounds calcBounds(const PointArray& points, double halfWidth, bool usePressure) {
+        return PointKernels::calcBounds(points.getXData(), points.getYData(),
+                                        usePressure ? points.getPressureData() : nullptr, points.size(), halfWidth);
+    }
+
+    static void transform(PointArray& points, const Transformation& t) {
+        PointKernels::transform(points.getXData(), points.getYData(), points.size(), t);
+    }
+
+    static size_t findEraserCandidate(const PointArray& points, size_t begin, double x1, double y1, double x2,
+                                      double y2, double minSegmentLength) {
+        return PointKernels::findEraserCandidate(points.getXData(), points.getYData(), begin, points.size(), x1, y1,
+                                                 x2, y2, minSegmentLength);
+    }
+
+    static vector<InstructionSet> getInstructionSets() {
+        vector<InstructionSet> sets;
+        for (int set = INSTRUCTION_SET_SCALAR; set <= getSupportedInstructionSet(); set++) {
+            sets.push_back(static_cast<InstructionSet>(set));
+        }
+        return sets;
+    }
+
+    void testBounds() {
+        // Odd counts, so the remainder of the vector loops is tested, too
+        for (size_t count: {1, 2, 3, 5, 1001}) {
+            PointArray points = createPoints(count);
+
+            for (bool usePressure: {false, true}) {
+                setInstructionSet(INSTRUCTION_SET_SCALAR);
+                Bounds expected = calcBounds(points, 1.5, usePressure);
+
+                for (InstructionSet set: getInstructionSets()) {
+                    setInstructionSet(set);
+                    Bounds bounds = calcBounds(points, 1.5, usePressure);
+                    CPPUNIT_ASSERT_EQUAL(expected.minX, bounds.minX);
+                    CPPUNIT_ASSERT_EQUAL(expected.minY, bounds.minY);
+                    CPPUNIT_ASSERT_EQUAL(expected.maxX, bounds.maxX);
+                    CPPUNIT_ASSERT_EQUAL(expected.maxY, bounds.maxY);
+                }
+            }
+        }
+
+        setInstructionSet(INSTRUCTION_SET_SCALAR);
+        PointArray points;
+        points.push_back(Point(-10, -20, 2));
+        points.push_back(Point(-30, -5, 4));
+        Bounds bounds = calcBounds(points, 0, true);
+        CPPUNIT_ASSERT_EQUAL(-32.0, bounds.minX);
+        CPPUNIT_ASSERT_EQUAL(-21.0, bounds.minY);
+        CPPUNIT_ASSERT_EQUAL(-9.0, bounds.maxX);
+        CPPUNIT_ASSERT_EQUAL(-3.0, bounds.maxY);
+    }
+
+    void testTransform() {
+        Transformation t;
+        t.xx = std::cos(0.3);
+        t.xy = -std::sin(0.3);
+        t.yx = std::sin(0.3);
+        t.yy = std::cos(0.3);
+        t.originX = 12.5;
+        t.originY = -4;
+        t.translateX = 100;
+        t.translateY = 50;
+
+        for (size_t count: {1, 2, 3, 5, 1001}) {
+            PointArray original = createPoints(count);
+
+            setInstructionSet(INSTRUCTION_SET_SCALAR);
+            PointArray expected = original;
+            transform(expected, t);
+
+            for (InstructionSet set: getInstructionSets()) {
+                setInstructionSet(set);
+                PointArray points = original;
+                transform(points, t);
+
+                for (size_t i = 0; i < count; i++) {
+                    CPPUNIT_ASSERT_EQUAL(expected.getX(i), points.getX(i));
+                    CPPUNIT_ASSERT_EQUAL(expected.getY(i), points.getY(i));
+                    // The pressure is not changed
+                    CPPUNIT_ASSERT_EQUAL(original.getPressure(i), points.getPressure(i));
+                }
+            }
+        }
+
+        setInstructionSet(INSTRUCTION_SET_SCALAR);
+        Transformation move;
+        move.translateX = 3;
+        move.translateY = -2;
+        PointArray p;
+        p.push_back(Point(1, 1));
+        transform(p, move);
+        CPPUNIT_ASSERT_EQUAL(4.0, p.getX(0));
+        CPPUNIT_ASSERT_EQUAL(-1.0, p.getY(0));
+    }
+
+    static vector<size_t> findAllCandidates(const PointArray& points, size_t begin, double x, double y, double size) {
+        vector<size_t> result;
+        for (size_t i = begin; i < points.size(); i++) {
+            i = findEraserCandidate(points, i, x - size, y - size, x + size, y + size, size);
+            if (i < points.size()) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    void testEraserCandidate() {
+        PointArray points = createPoints(1001);
+
+        for (size_t begin: {0, 1, 2, 3, 500}) {
+            setInstructionSet(INSTRUCTION_SET_SCALAR);
+            vector<size_t> expected = findAllCandidates(points, begin, 100, 20, 5);
+            CPPUNIT_ASSERT(!expected.empty());
+
+            for (InstructionSet set: getInstructionSets()) {
+                setInstructionSet(set);
+                CPPUNIT_ASSERT(expected == findAllCandidates(points, begin, 100, 20, 5));
+            }
+        }
+
+        // A point inside, and the end of a long segment
+        PointArray line;
+        for (double x: {0, 1, 2, 12, 13}) {
+            line.push_back(Point(x, 0));
+        }
+        for (InstructionSet set: getInstructionSets()) {
+            setInstructionSet(set);
+            CPPUNIT_ASSERT_EQUAL((size_t)1, findEraserCandidate(line, 0, 0.5, -1, 1.5, 1, 5));
+            CPPUNIT_ASSERT_EQUAL((size_t)3, findEraserCandidate(line, 2, 50, -1, 51, 1, 5));
+            CPPUNIT_ASSERT_EQUAL(line.size(), findEraserCandidate(line, 4, 50, -1, 51, 1, 5));
+        }
+    }
+
+#ifdef TEST_CHECK_SPEED
+    static const char* getName(InstructionSet set) {
+        switch (set) {
+            case INSTRUCTION_SET_SSE2:
+                return "SSE2";
+            case INSTRUCTION_SET_AVX2:
+                return "AVX2";
+            default:
+                return "scalar";
+        }
+    }
+
+    void testSpeedBounds() {
+        PointArray points = createPoints(100000);
+
+        for (InstructionSet set: getInstructionSets()) {
+            setInstructionSet(set);
+
+            SpeedTest speed;
+            speed.startTest(string("bounds of 100000 points, 1000 times, ") + getName(set));
+            for (int i = 0; i < 1000; i++) {
+                calcBounds(points, 1, i % 2 == 0);
+            }
+            speed.endTest();
+        }
+    }
+
+    void testSpeedTransform() {
+        PointArray points = createPoints(100000);
+
+        Transformation t;
+        t.xx = 1.01;
+        t.yy = 0.99;
+
+        for (InstructionSet set: getInstructionSets()) {
+            setInstructionSet(set);
+
+            SpeedTest speed;
+            speed.startTest(string("transform 100000 points, 1000 times, ") + getName(set));
+            for (int i = 0; i < 1000; i++) {
+                transform(points, t);
+            }
+            speed.endTest();
+        }
+    }
+
+    void testSpeedEraserCandidate() {
+        PointArray points;
+        for (int i = 0; i < 100000; i++) {
+            points.push_back(Point(i * 0.5, std::sin(i * 0.05) * 30));
+        }
+
+        for (InstructionSet set: getInstructionSets()) {
+            setInstructionSet(set);
+
+            SpeedTest speed;
+            speed.startTest(string("eraser test of 100000 points, 1000 times, ") + getName(set));
+            for (int i = 0; i < 1000; i++) {
+                findEraserCandidate(points, 0, -10, -10, -5, -5, 5);
+            }
+            speed.endTest();
+        }
+    }
+#endif
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(PointKernelsTest);
@@ -0,0 +1,184 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+
+#include <config-test.h>
+
+#include "model/Stroke.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+/**
+ * Axis aligned rectangle, optionally without the bounding box tests
+ */
+class TestRectContainer: public ShapeContainer {
+public:
+    TestRectContainer(double x1, double y1, double x2, double y2, bool rectTests):
+            x1(x1), y1(y1), x2(x2), y2(y2), rectTests(rectTests) {}
+
+    bool contains(double x, double y) override { return x >= x1 && x <= x2 && y >= y1 && y <= y2; }
+
+    bool containsRect(double x1, double y1, double x2, double y2) override {
+        return rectTests && x1 >= this->x1 && x2 <= this->x2 && y1 >= this->y1 && y2 <= this->y2;
+    }
+
+    bool intersectsRect(double x1, double y1, double x2, double y2) override {
+        return !rectTests || (x1 <= this->x2 && x2 >= this->x1 && y1 <= this->y2 && y2 >= this->y1);
+    }
+
+private:
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+    bool rectTests;
+};
+
+class StrokeTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(StrokeTest);
+
+    CPPUNIT_TEST(testIntersectsCircle);
+    CPPUNIT_TEST(testIntersectsSegment);
+    CPPUNIT_TEST(testIntersectsAfterMove);
+    CPPUNIT_TEST(testIsInSelection);
+    CPPUNIT_TEST(testPressure);
+    CPPUNIT_TEST(testPointVector);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    /**
+     * Circle around (200, 200) with radius 100, starting at (300, 200)
+     */
+    static Stroke* createCircle(int count) {
+        auto* s = new Stroke();
+        s->setWidth(1);
+        for (int i = 0; i < count; i++) {
+            double angle = 2 * M_PI * i / count;
+            s->addPoint(Point(200 + 100 * std::cos(angle), 200 + 100 * std::sin(angle)));
+        }
+        return s;
+    }
+
+    void testIntersectsCircle() {
+        Stroke* s = createCircle(1000);
+
+        double gap = -1;
+        CPPUNIT_ASSERT(s->intersects(300, 200, 2, &gap));
+        CPPUNIT_ASSERT_EQUAL(0.0, gap);
+
+        CPPUNIT_ASSERT(s->intersects(200, 301, 2));
+        CPPUNIT_ASSERT(s->intersects(100, 200, 2));
+        CPPUNIT_ASSERT(!s->intersects(200, 200, 2));
+        CPPUNIT_ASSERT(!s->intersects(200, 305, 2));
+        CPPUNIT_ASSERT(!s->intersects(500, 500, 20));
+
+        delete s;
+    }
+
+    void testIntersectsSegment() {
+        // Long segments, only hit by the segment test, not by the points
+        auto* s = new Stroke();
+        s->setWidth(1);
+        for (int i = 0; i < 100; i++) {
+            s->addPoint(Point(i * 10, 0));
+        }
+
+        double gap = -1;
+        CPPUNIT_ASSERT(s->intersects(505, 0, 2, &gap));
+        CPPUNIT_ASSERT(gap != 0);
+        CPPUNIT_ASSERT(!s->intersects(505, 50, 2));
+
+        delete s;
+    }
+
+    void testIntersectsAfterMove() {
+        Stroke* s = createCircle(1000);
+        CPPUNIT_ASSERT(s->intersects(300, 200, 2));
+
+        s->move(10, 0);
+        CPPUNIT_ASSERT(!s->intersects(300, 200, 2));
+        CPPUNIT_ASSERT(s->intersects(310, 200, 2));
+
+        // The copy does not change with the original
+        Stroke* copy = s->cloneStroke();
+        s->move(-10, 0);
+        CPPUNIT_ASSERT(s->intersects(300, 200, 2));
+        CPPUNIT_ASSERT(copy->intersects(310, 200, 2));
+        CPPUNIT_ASSERT(!copy->intersects(300, 200, 2));
+
+        delete copy;
+        delete s;
+    }
+
+    void testIsInSelection() {
+        Stroke* s = createCircle(1000);
+
+        for (bool rectTests: {false, true}) {
+            TestRectContainer all(99, 99, 301, 301, rectTests);
+            CPPUNIT_ASSERT(s->isInSelection(&all));
+
+            TestRectContainer half(99, 99, 200, 301, rectTests);
+            CPPUNIT_ASSERT(!s->isInSelection(&half));
+
+            TestRectContainer outside(400, 400, 500, 500, rectTests);
+            CPPUNIT_ASSERT(!s->isInSelection(&outside));
+        }
+
+        delete s;
+    }
+
+    void testPressure() {
+        Stroke* s = createCircle(100);
+
+        // No pressure is stored if no point has one
+        CPPUNIT_ASSERT(!s->hasPressure());
+        CPPUNIT_ASSERT(s->getPointArray().getPressureData() == nullptr);
+        CPPUNIT_ASSERT_EQUAL(Point::NO_PRESSURE, s->getPoint(10).z);
+
+        s->addPoint(Point(1, 2, 3));
+        CPPUNIT_ASSERT(s->getPointArray().getPressureData() != nullptr);
+        CPPUNIT_ASSERT_EQUAL(Point::NO_PRESSURE, s->getPoint(10).z);
+        CPPUNIT_ASSERT_EQUAL(3.0, s->getPoint(100).z);
+
+        s->clearPressure();
+        s->freeUnusedPointItems();
+        CPPUNIT_ASSERT(s->getPointArray().getPressureData() == nullptr);
+        CPPUNIT_ASSERT_EQUAL(2 * 101 * sizeof(Coordinate), s->getPointArray().getMemoryUsage());
+
+        delete s;
+    }
+
+    void testPointVector() {
+        Stroke* s = createCircle(10);
+        s->setLastPressure(2);
+
+        vector<Point> points = s->getPointVector();
+        CPPUNIT_ASSERT_EQUAL((size_t)10, points.size());
+        for (int i = 0; i < 10; i++) {
+            Point p = s->getPoint(i);
+            CPPUNIT_ASSERT_EQUAL(p.x, points[i].x);
+            CPPUNIT_ASSERT_EQUAL(p.y, points[i].y);
+            CPPUNIT_ASSERT_EQUAL(p.z, points[i].z);
+        }
+        CPPUNIT_ASSERT_EQUAL(2.0, points[9].z);
+
+        delete s;
+    }
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(StrokeTest);
@@ -0,0 +1,215 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <config-test.h>
+
+#include "model/Stroke.h"
+#include "undo/UndoAction.h"
+#include "undo/UndoRedoHandler.h"
+
+#include "Util.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using std::vector;
+
+constexpr int POINT_COUNT = 10000;
+
+/**
+ * Removes a stroke from the document, the points of the stroke are freed if the action is spilled
+ */
+class TestUndoAction: public UndoAction {
+public:
+    TestUndoAction(): UndoAction("TestUndoAction") {
+        for (int i = 0; i < POINT_COUNT; i++) {
+            this->stroke.addPoint(Point(i, 2 * i, 0.5));
+        }
+    }
+
+public:
+    bool undo(Control* control) override {
+        this->pointsOnUndo = this->stroke.getPointCount();
+        return true;
+    }
+
+    bool redo(Control* control) override {
+        this->pointsOnRedo = this->stroke.getPointCount();
+        return true;
+    }
+
+    string getText() override { return "Test"; }
+
+    vector<Element*> getRemovedElements() override { return {&this->stroke}; }
+
+    bool hasPoints() const { return this->stroke.getPointCount() == POINT_COUNT; }
+
+    bool isFreed() const { return this->stroke.getPointCount() == 0; }
+
+    bool pointsUnchanged() const {
+        for (int i = 0; i < this->stroke.getPointCount(); i++) {
+            Point p = this->stroke.getPoint(i);
+            if (p.x != i || p.y != 2 * i || p.z != 0.5) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    Stroke stroke;
+    int pointsOnUndo = -1;
+    int pointsOnRedo = -1;
+};
+
+class UndoRedoHandlerTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(UndoRedoHandlerTest);
+
+    CPPUNIT_TEST(testDefaultLimit);
+    CPPUNIT_TEST(testSpillOldActions);
+    CPPUNIT_TEST(testUndoAfterSpill);
+    CPPUNIT_TEST(testRedoAfterSpill);
+    CPPUNIT_TEST(testRemoveSpilledAction);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    static bool spillFileExists() { return (Util::getTmpDirSubfolder("undo") / "undo.bin").exists(); }
+
+    static size_t actionMemory() {
+        TestUndoAction action;
+        return action.getMemoryUsage();
+    }
+
+    static vector<TestUndoAction*> addActions(UndoRedoHandler& handler, int count) {
+        vector<TestUndoAction*> actions;
+        for (int i = 0; i < count; i++) {
+            auto action = std::make_unique<TestUndoAction>();
+            actions.push_back(action.get());
+            handler.addUndoAction(std::move(action));
+        }
+        return actions;
+    }
+
+    void testDefaultLimit() {
+        UndoRedoHandler handler(nullptr);
+        vector<TestUndoAction*> actions = addActions(handler, 10);
+
+        // Far below the default limit, nothing is written
+        for (TestUndoAction* a: actions) {
+            CPPUNIT_ASSERT(a->hasPoints());
+        }
+        CPPUNIT_ASSERT(!spillFileExists());
+
+        // The last action is not accounted, it may still be extended
+        CPPUNIT_ASSERT_EQUAL(9 * actionMemory(), handler.getMemoryUsage());
+    }
+
+    void testSpillOldActions() {
+        UndoRedoHandler handler(nullptr);
+        vector<TestUndoAction*> actions = addActions(handler, 6);
+
+        size_t limit = 2 * actionMemory();
+        handler.setMemoryLimit(limit);
+
+        CPPUNIT_ASSERT(spillFileExists());
+        CPPUNIT_ASSERT(handler.getMemoryUsage() <= limit);
+
+        // The oldest actions are written, the newest are kept
+        CPPUNIT_ASSERT(actions[0]->isFreed());
+        CPPUNIT_ASSERT(actions[2]->isFreed());
+        CPPUNIT_ASSERT(actions[4]->hasPoints());
+        CPPUNIT_ASSERT(actions[5]->hasPoints());
+
+        // Further actions spill the next oldest one
+        addActions(handler, 1);
+        CPPUNIT_ASSERT(actions[4]->isFreed());
+        CPPUNIT_ASSERT(actions[5]->hasPoints());
+        CPPUNIT_ASSERT(handler.getMemoryUsage() <= limit);
+
+        handler.clearContents();
+        CPPUNIT_ASSERT(!spillFileExists());
+    }
+
+    void testUndoAfterSpill() {
+        UndoRedoHandler handler(nullptr);
+        handler.setMemoryLimit(2 * actionMemory());
+        vector<TestUndoAction*> actions = addActions(handler, 6);
+        CPPUNIT_ASSERT(actions[0]->isFreed());
+
+        // Each action is read back before it is undone
+        for (int i = 5; i >= 0; i--) {
+            handler.undo();
+            CPPUNIT_ASSERT_EQUAL(POINT_COUNT, actions[i]->pointsOnUndo);
+            CPPUNIT_ASSERT(actions[i]->pointsUnchanged());
+        }
+        CPPUNIT_ASSERT(!handler.canUndo());
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), handler.getMemoryUsage());
+
+        // All regions were freed
+        CPPUNIT_ASSERT(!spillFileExists());
+    }
+
+    void testRedoAfterSpill() {
+        UndoRedoHandler handler(nullptr);
+        handler.setMemoryLimit(2 * actionMemory());
+        vector<TestUndoAction*> actions = addActions(handler, 6);
+
+        for (int i = 0; i < 6; i++) {
+            handler.undo();
+        }
+        for (int i = 0; i < 6; i++) {
+            handler.redo();
+            CPPUNIT_ASSERT_EQUAL(POINT_COUNT, actions[i]->pointsOnRedo);
+        }
+
+        // Spilled again while redone
+        CPPUNIT_ASSERT(actions[0]->isFreed());
+        CPPUNIT_ASSERT(actions[5]->hasPoints());
+        CPPUNIT_ASSERT(handler.getMemoryUsage() <= 2 * actionMemory());
+
+        for (int i = 5; i >= 0; i--) {
+            handler.undo();
+            CPPUNIT_ASSERT_EQUAL(POINT_COUNT, actions[i]->pointsOnUndo);
+            CPPUNIT_ASSERT(actions[i]->pointsUnchanged());
+        }
+        CPPUNIT_ASSERT(!spillFileExists());
+    }
+
+    void testRemoveSpilledAction() {
+        UndoRedoHandler handler(nullptr);
+        handler.setMemoryLimit(2 * actionMemory());
+        vector<TestUndoAction*> actions = addActions(handler, 6);
+        CPPUNIT_ASSERT(actions[1]->isFreed());
+
+        CPPUNIT_ASSERT(handler.removeUndoAction(actions[1]));
+
+        for (int i = 5; i >= 0; i--) {
+            if (i == 1) {
+                continue;
+            }
+            handler.undo();
+            CPPUNIT_ASSERT_EQUAL(POINT_COUNT, actions[i]->pointsOnUndo);
+            CPPUNIT_ASSERT(actions[i]->pointsUnchanged());
+        }
+        CPPUNIT_ASSERT(!handler.canUndo());
+        CPPUNIT_ASSERT(!spillFileExists());
+    }
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(UndoRedoHandlerTest);
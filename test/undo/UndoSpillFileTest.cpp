@@ -0,0 +1,184 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <config-test.h>
+
+#include "undo/UndoSpillFile.h"
+
+#include "Util.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using std::string;
+
+class UndoSpillFileTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(UndoSpillFileTest);
+
+    CPPUNIT_TEST(testWriteRead);
+    CPPUNIT_TEST(testFirstFitReuse);
+    CPPUNIT_TEST(testSplitFreeRegion);
+    CPPUNIT_TEST(testMergeAdjacentRegions);
+    CPPUNIT_TEST(testShrinkAtEnd);
+    CPPUNIT_TEST(testDeleteWhenEmpty);
+    CPPUNIT_TEST(testClear);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    static UndoSpillFile::Entry write(UndoSpillFile& file, const string& data) {
+        GString* str = g_string_new_len(data.c_str(), data.length());
+        UndoSpillFile::Entry entry;
+        CPPUNIT_ASSERT(file.write(str, entry));
+        g_string_free(str, true);
+        return entry;
+    }
+
+    static string read(UndoSpillFile& file, const UndoSpillFile::Entry& entry) {
+        string data;
+        CPPUNIT_ASSERT(file.read(entry, data));
+        return data;
+    }
+
+    static bool fileExists() { return (Util::getTmpDirSubfolder("undo") / "undo.bin").exists(); }
+
+    void testWriteRead() {
+        UndoSpillFile file;
+        UndoSpillFile::Entry a = write(file, "first");
+        UndoSpillFile::Entry b = write(file, string("with\0zero", 9));
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), a.offset);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), a.length);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), b.offset);
+
+        CPPUNIT_ASSERT_EQUAL(string("first"), read(file, a));
+        CPPUNIT_ASSERT_EQUAL(string("with\0zero", 9), read(file, b));
+    }
+
+    void testFirstFitReuse() {
+        UndoSpillFile file;
+        UndoSpillFile::Entry a = write(file, "aa");
+        write(file, "bbbb");
+        UndoSpillFile::Entry c = write(file, "cccc");
+        write(file, "dd");
+
+        file.free(a);
+        file.free(c);
+
+        // Too large for the first free region, the second one is used
+        UndoSpillFile::Entry e = write(file, "eeee");
+        CPPUNIT_ASSERT_EQUAL(c.offset, e.offset);
+
+        // Larger than all free regions, appended
+        UndoSpillFile::Entry f = write(file, "fffff");
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(12), f.offset);
+
+        // Fits into the first region
+        UndoSpillFile::Entry g = write(file, "gg");
+        CPPUNIT_ASSERT_EQUAL(a.offset, g.offset);
+
+        CPPUNIT_ASSERT_EQUAL(string("eeee"), read(file, e));
+        CPPUNIT_ASSERT_EQUAL(string("fffff"), read(file, f));
+        CPPUNIT_ASSERT_EQUAL(string("gg"), read(file, g));
+    }
+
+    void testSplitFreeRegion() {
+        UndoSpillFile file;
+        UndoSpillFile::Entry a = write(file, "aaaaaa");
+        write(file, "bb");
+
+        file.free(a);
+
+        // The rest of the region stays free
+        UndoSpillFile::Entry c = write(file, "cc");
+        UndoSpillFile::Entry d = write(file, "dddd");
+        UndoSpillFile::Entry e = write(file, "e");
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), c.offset);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), d.offset);
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(8), e.offset);
+    }
+
+    void testMergeAdjacentRegions() {
+        UndoSpillFile file;
+        UndoSpillFile::Entry a = write(file, "aaa");
+        UndoSpillFile::Entry b = write(file, "bbb");
+        UndoSpillFile::Entry c = write(file, "ccc");
+        write(file, "ddd");
+
+        // Merged with the following region, then with the preceding one
+        file.free(c);
+        file.free(a);
+        file.free(b);
+
+        UndoSpillFile::Entry e = write(file, "eeeeeeeee");
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), e.offset);
+        CPPUNIT_ASSERT_EQUAL(string("eeeeeeeee"), read(file, e));
+    }
+
+    void testShrinkAtEnd() {
+        UndoSpillFile file;
+        write(file, "aaa");
+        UndoSpillFile::Entry b = write(file, "bbb");
+        UndoSpillFile::Entry c = write(file, "ccc");
+
+        // The free region before the end is merged, the file ends after the first entry
+        file.free(b);
+        file.free(c);
+
+        UndoSpillFile::Entry d = write(file, "dddddddd");
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), d.offset);
+    }
+
+    void testDeleteWhenEmpty() {
+        UndoSpillFile file;
+        UndoSpillFile::Entry a = write(file, "aaa");
+        UndoSpillFile::Entry b = write(file, "bbb");
+        CPPUNIT_ASSERT(fileExists());
+
+        file.free(a);
+        CPPUNIT_ASSERT(fileExists());
+
+        file.free(b);
+        CPPUNIT_ASSERT(!fileExists());
+
+        // Created again on the next write
+        UndoSpillFile::Entry c = write(file, "ccc");
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), c.offset);
+        CPPUNIT_ASSERT(fileExists());
+        CPPUNIT_ASSERT_EQUAL(string("ccc"), read(file, c));
+    }
+
+    void testClear() {
+        {
+            UndoSpillFile file;
+            write(file, "aaa");
+            file.clear();
+            CPPUNIT_ASSERT(!fileExists());
+
+            string data;
+            CPPUNIT_ASSERT(!file.read(UndoSpillFile::Entry(), data));
+
+            write(file, "bbb");
+        }
+
+        // Deleted with the object
+        CPPUNIT_ASSERT(!fileExists());
+    }
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(UndoSpillFileTest);
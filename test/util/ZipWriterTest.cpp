@@ -0,0 +1,130 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <config-test.h>
+#include <glib/gstdio.h>
+#include <zip.h>
+
+#include "ZipWriter.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using std::string;
+
+class ZipWriterTest: public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(ZipWriterTest);
+
+    CPPUNIT_TEST(testReadEntries);
+    CPPUNIT_TEST(testEntryTooLarge);
+    CPPUNIT_TEST(testNameTooLong);
+    CPPUNIT_TEST(testTooManyEntries);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() {
+        gchar* dir = g_dir_make_tmp("xournalpp-zip-XXXXXX", nullptr);
+        CPPUNIT_ASSERT(dir != nullptr);
+        this->folder = dir;
+        g_free(dir);
+
+        this->zipFile = this->folder / "test.zip";
+    }
+
+    void tearDown() {
+        g_unlink(this->zipFile.c_str());
+        g_rmdir(this->folder.c_str());
+    }
+
+    static string readEntry(zip_t* zipFp, const string& name) {
+        zip_stat_t stat;
+        CPPUNIT_ASSERT_EQUAL(0, zip_stat(zipFp, name.c_str(), 0, &stat));
+
+        string data(stat.size, '\0');
+        zip_file_t* file = zip_fopen(zipFp, name.c_str(), 0);
+        CPPUNIT_ASSERT(file != nullptr);
+        CPPUNIT_ASSERT_EQUAL(static_cast<zip_int64_t>(stat.size), zip_fread(file, &data[0], stat.size));
+        zip_fclose(file);
+        return data;
+    }
+
+    void testReadEntries() {
+        string text;
+        for (int i = 0; i < 1000; i++) {
+            text += "<stroke>" + std::to_string(i) + "</stroke>\n";
+        }
+
+        ZipWriter zip(this->zipFile);
+        zip.addEntry(ZipWriter::createEntry("mimetype", "application/xournal++", 0));
+        zip.addEntry(ZipWriter::createEntry("pages/page1.xml", text));
+        zip.addEntry(ZipWriter::createEntry("empty", ""));
+        zip.close();
+        CPPUNIT_ASSERT_EQUAL(string(), zip.getLastError());
+
+        int zipError = 0;
+        zip_t* zipFp = zip_open(this->zipFile.c_str(), ZIP_RDONLY | ZIP_CHECKCONS, &zipError);
+        CPPUNIT_ASSERT(zipFp != nullptr);
+        CPPUNIT_ASSERT_EQUAL(static_cast<zip_int64_t>(3), zip_get_num_entries(zipFp, 0));
+        CPPUNIT_ASSERT_EQUAL(string("application/xournal++"), readEntry(zipFp, "mimetype"));
+        CPPUNIT_ASSERT_EQUAL(text, readEntry(zipFp, "pages/page1.xml"));
+        CPPUNIT_ASSERT_EQUAL(string(), readEntry(zipFp, "empty"));
+        zip_close(zipFp);
+    }
+
+    void testEntryTooLarge() {
+        // The data is not needed, the size is checked before anything is written
+        ZipEntry entry;
+        entry.name = "attachments/bg.pdf";
+        entry.uncompressedSize = 0x100000000;
+
+        ZipWriter zip(this->zipFile);
+        zip.addEntry(ZipWriter::createEntry("mimetype", "application/xournal++", 0));
+        zip.addEntry(entry);
+        CPPUNIT_ASSERT(!zip.getLastError().empty());
+
+        // Nothing more is written after an error
+        zip.addEntry(ZipWriter::createEntry("content.xml", "<xournal/>"));
+        zip.close();
+        CPPUNIT_ASSERT(!zip.getLastError().empty());
+
+        int zipError = 0;
+        CPPUNIT_ASSERT(zip_open(this->zipFile.c_str(), ZIP_RDONLY, &zipError) == nullptr);
+    }
+
+    void testNameTooLong() {
+        ZipWriter zip(this->zipFile);
+        zip.addEntry(ZipWriter::createEntry(string(0xFFFF, 'a'), "data"));
+        zip.close();
+        CPPUNIT_ASSERT(!zip.getLastError().empty());
+    }
+
+    void testTooManyEntries() {
+        ZipWriter zip(this->zipFile);
+        for (int i = 0; i < 0xFFFE; i++) {
+            zip.addEntry(ZipWriter::createEntry(std::to_string(i), "", 0));
+        }
+        CPPUNIT_ASSERT_EQUAL(string(), zip.getLastError());
+
+        // 0xFFFF marks a Zip64 archive
+        zip.addEntry(ZipWriter::createEntry("last", "", 0));
+        CPPUNIT_ASSERT(!zip.getLastError().empty());
+        zip.close();
+    }
+
+private:
+    Path folder;
+    Path zipFile;
+};
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION(ZipWriterTest);